@@ -7,11 +7,13 @@
 #define EVENT_EPSILON (1e-10)
 
 
-void setStartValues(ModelInstance *comp) {
+Status setStartValues(ModelInstance *comp) {
     M(h) =  1;
     M(v) =  0;
     M(g) = -9.81;
     M(e) =  0.7;
+
+    return OK;
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -38,11 +38,13 @@ static void activateModelPartition1(ModelInstance* comp, double time) {
 
     M(outClock) = ((M(outClock) == false) && (M(totalInClockTicks) % 5 == 0));
 
+    const bool clockUpdate = M(inClock3_qualifier) == 2 || M(outClock);
+
     if (comp->unlockPreemtion) {
         comp->unlockPreemtion();
     }
 
-    if (M(inClock3_qualifier) == 2 || M(outClock)) {
+    if (clockUpdate) {
         comp->clockUpdate(comp->componentEnvironment);
     }
 }
@@ -71,11 +73,13 @@ static void activateModelPartition2(ModelInstance* comp, double time) {
     // set output clocks
     M(outClock) = ((M(outClock) == false) && (M(totalInClockTicks) % 5 == 0));
 
+    const bool clockUpdate = M(outClock);
+
     if (comp->unlockPreemtion) {
         comp->unlockPreemtion();
     }
 
-    if (M(outClock)) {
+    if (clockUpdate) {
         comp->clockUpdate(comp->componentEnvironment);
     }
 }
@@ -89,6 +93,8 @@ static void activateModelPartition2(ModelInstance* comp, double time) {
  **************************************/
  static void activateModelPartition3(ModelInstance *comp, double time) {
 
+    UNUSED(time);
+
     if (comp->lockPreemtion) {
         comp->lockPreemtion();
     }
@@ -108,32 +114,29 @@ static void activateModelPartition2(ModelInstance* comp, double time) {
     (void)sum; // use variable to avoid compiler warnings
 
     // ... end of burning CPU cycles
+
+    if (comp->lockPreemtion) {
+        comp->lockPreemtion();
+    }
+
     M(output3) = 1000;   // this is suposed to find its way into mp2
     M(totalInClockTicks)++;
 
     // set output clocks
     M(outClock) = ((M(outClock) == false) && (M(totalInClockTicks) % 5 == 0));
-    if (M(outClock)) {
-
-        bool earlyReturnRequested;
-        double earlyReturnTime;
-
-        if (M(outClock)) {
-            comp->intermediateUpdate(
-                comp,   // fmu instance
-                time,   // intermediateUpdateTime
-                false,  // intermediateVariableSetAllowed
-                false,  // intermediateVariableGetAllowed
-                true,   // intermediateStepFinished
-                false,  // canReturnEarly
-                &earlyReturnRequested,
-                &earlyReturnTime
-            );
-        }
+
+    const bool clockUpdate = M(outClock);
+
+    if (comp->unlockPreemtion) {
+        comp->unlockPreemtion();
+    }
+
+    if (clockUpdate) {
+        comp->clockUpdate(comp->componentEnvironment);
     }
 }
 
-void setStartValues(ModelInstance *comp) {
+Status setStartValues(ModelInstance *comp) {
     M(inClock3_interval) = 0.0;
     M(inClock3_qualifier)= 0; // fmi3IntervalNotYetKnown
     M(outClock)          = 0;
@@ -144,6 +147,8 @@ void setStartValues(ModelInstance *comp) {
     M(result2)           = 0;
     M(input2)            = 0;
     M(output3)           = 0;
+
+    return OK;
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -237,6 +242,10 @@ Status getClock(ModelInstance* comp, ValueReference vr, _Bool *value) {
 
 Status getInterval(ModelInstance* comp, ValueReference vr, double* interval, int* qualifier) {
     switch (vr) {
+    case vr_inClock1:
+        *interval = 1;                          // constant interval
+        *qualifier = 1;                         // fmi3IntervalUnchanged
+        return OK;
     case vr_inClock3:
         *qualifier = M(inClock3_qualifier);
         if (*qualifier == 2) {                  // fmi3IntervalChanged
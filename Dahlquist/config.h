@@ -1,6 +1,8 @@
 #ifndef config_h
 #define config_h
 
+#include "fixedSolver.h"
+
 // define class name and unique id
 #define MODEL_IDENTIFIER Dahlquist
 #define INSTANTIATION_TOKEN "{221063D2-EF4A-45FE-B954-B5BFEEA9A59B}"
@@ -13,6 +15,15 @@
 #define NZ 0
 
 #define SET_FLOAT64
+#define EQUATION_BLOCKS
+
+// the ensemble functions integrate with the forward Euler method
+#if FIXED_SOLVER == FIXED_SOLVER_EULER
+#define ENSEMBLE
+#endif
+
+// skip the event checks of doFixedStep() in DoStep (the model has no event indicators)
+#define FAST_FIXED_STEPS
 
 #define FIXED_SOLVER_STEP 0.1
 #define DEFAULT_STOP_TIME 10
@@ -29,4 +40,7 @@ typedef struct {
 
 } ModelData;
 
+#define ENSEMBLE_VARIABLES(X) X(x) X(der_x) X(k)
+#define ENSEMBLE_STATES(X) X(x, der_x)
+
 #endif /* config_h */
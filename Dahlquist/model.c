@@ -1,20 +1,45 @@
 #include "config.h"
 #include "model.h"
 
+// equation blocks
+#define DERIVATIVES (1 << 0)
 
-void setStartValues(ModelInstance *comp) {
+
+Status setStartValues(ModelInstance *comp) {
     M(x) = 1;
     M(k) = 1;
+
+    return OK;
 }
 
 Status calculateValues(ModelInstance *comp) {
-    M(der_x) = -M(k) * M(x);
-    return OK;
+    return calculateBlocks(comp, DERIVATIVES);
 }
 
-Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
+uint32_t dependentBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    return vr == vr_x || vr == vr_k ? DERIVATIVES : 0;
+}
+
+uint32_t requiredBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    return vr == vr_der_x ? DERIVATIVES : 0;
+}
 
-    calculateValues(comp);
+void calculateEnsembleBlocks(EnsembleData* data, uint32_t blocks, size_t begin, size_t end) {
+
+    UNUSED(blocks);
+
+    const double* x = data->x;
+    const double* k = data->k;
+    double* der_x = data->der_x;
+
+    for (size_t i = begin; i < end; i++) {
+        der_x[i] = -k[i] * x[i];
+    }
+}
+
+Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
 
     ASSERT_NVALUES(1);
 
@@ -70,10 +95,11 @@ void getContinuousStates(ModelInstance *comp, double x[], size_t nx) {
 void setContinuousStates(ModelInstance *comp, const double x[], size_t nx) {
     UNUSED(nx);
     M(x) = x[0];
+    comp->dirtyBlocks |= DERIVATIVES;
 }
 
 void getDerivatives(ModelInstance *comp, double dx[], size_t nx) {
     UNUSED(nx);
-    calculateValues(comp);
+    updateValues(comp, DERIVATIVES);
     dx[0] = M(der_x);
 }
@@ -45,6 +45,8 @@
 
 #define EVENT_UPDATE
 
+#define VARIABLE_TABLE
+
 #define FIXED_SOLVER_STEP 0.1
 #define DEFAULT_STOP_TIME 2
 
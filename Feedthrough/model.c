@@ -10,7 +10,53 @@
 #define STRING_START "Set me!"
 #define BINARY_START "foo"
 
-void setStartValues(ModelInstance *comp) {
+// variables that are copied directly from / to ModelData (all others and the setters
+// of variables with restrictions use the get / set functions below)
+const VariableInfo variableTable[] = {
+
+    [vr_Float32_continuous_input]  = VARIABLE(Float32, Float32_continuous_input,  true),
+    [vr_Float32_continuous_output] = VARIABLE(Float32, Float32_continuous_output, false),
+    [vr_Float32_discrete_input]    = VARIABLE(Float32, Float32_discrete_input,    false),
+    [vr_Float32_discrete_output]   = VARIABLE(Float32, Float32_discrete_output,   false),
+
+    [vr_Float64_fixed_parameter]   = VARIABLE(Float64, Float64_fixed_parameter,   false),
+    [vr_Float64_tunable_parameter] = VARIABLE(Float64, Float64_tunable_parameter, false),
+    [vr_Float64_continuous_input]  = VARIABLE(Float64, Float64_continuous_input,  true),
+    [vr_Float64_continuous_output] = VARIABLE(Float64, Float64_continuous_output, false),
+    [vr_Float64_discrete_input]    = VARIABLE(Float64, Float64_discrete_input,    false),
+    [vr_Float64_discrete_output]   = VARIABLE(Float64, Float64_discrete_output,   false),
+
+    [vr_Int8_input]    = VARIABLE(Int8,    Int8_input,    true),
+    [vr_Int8_output]   = VARIABLE(Int8,    Int8_output,   false),
+
+    [vr_UInt8_input]   = VARIABLE(UInt8,   UInt8_input,   true),
+    [vr_UInt8_output]  = VARIABLE(UInt8,   UInt8_output,  false),
+
+    [vr_Int16_input]   = VARIABLE(Int16,   Int16_input,   true),
+    [vr_Int16_output]  = VARIABLE(Int16,   Int16_output,  false),
+
+    [vr_UInt16_input]  = VARIABLE(UInt16,  UInt16_input,  true),
+    [vr_UInt16_output] = VARIABLE(UInt16,  UInt16_output, false),
+
+    [vr_Int32_input]   = VARIABLE(Int32,   Int32_input,   true),
+    [vr_Int32_output]  = VARIABLE(Int32,   Int32_output,  false),
+
+    [vr_UInt32_input]  = VARIABLE(UInt32,  UInt32_input,  true),
+    [vr_UInt32_output] = VARIABLE(UInt32,  UInt32_output, false),
+
+    [vr_Int64_input]   = VARIABLE(Int64,   Int64_input,   true),
+    [vr_Int64_output]  = VARIABLE(Int64,   Int64_output,  false),
+
+    [vr_UInt64_input]  = VARIABLE(UInt64,  UInt64_input,  true),
+    [vr_UInt64_output] = VARIABLE(UInt64,  UInt64_output, false),
+
+    [vr_Boolean_input]  = VARIABLE(Boolean, Boolean_input,  true),
+    [vr_Boolean_output] = VARIABLE(Boolean, Boolean_output, false),
+};
+
+const size_t nVariableTable = sizeof(variableTable) / sizeof(variableTable[0]);
+
+Status setStartValues(ModelInstance *comp) {
 
     M(Float32_continuous_input)  = 0.0f;
     M(Float32_continuous_output) = 0.0f;
@@ -60,6 +106,8 @@ void setStartValues(ModelInstance *comp) {
 
     M(Enumeration_input)  = Option1;
     M(Enumeration_output) = Option1;
+
+    return OK;
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -507,7 +555,7 @@ Status setInt16(ModelInstance* comp, ValueReference vr, const int16_t values[],
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -525,7 +573,7 @@ Status setUInt16(ModelInstance* comp, ValueReference vr, const uint16_t values[]
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -553,7 +601,7 @@ Status setInt32(ModelInstance* comp, ValueReference vr, const int32_t values[],
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -571,7 +619,7 @@ Status setUInt32(ModelInstance* comp, ValueReference vr, const uint32_t values[]
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -598,7 +646,7 @@ Status setInt64(ModelInstance* comp, ValueReference vr, const int64_t values[],
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -616,7 +664,7 @@ Status setUInt64(ModelInstance* comp, ValueReference vr, const uint64_t values[]
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -637,7 +685,7 @@ Status setBoolean(ModelInstance* comp, ValueReference vr, const bool values[], s
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -659,7 +707,7 @@ Status setString(ModelInstance* comp, ValueReference vr, const char *const value
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
@@ -682,7 +730,7 @@ Status setBinary(ModelInstance* comp, ValueReference vr, const size_t size[], co
             return Error;
     }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return OK;
 }
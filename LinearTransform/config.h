@@ -17,14 +17,14 @@
 #define SET_FLOAT64
 #define GET_UINT64
 #define SET_UINT64
+#define EQUATION_BLOCKS
 #define EVENT_UPDATE
+#define MODEL_BUFFER
+#define GET_DIRECTIONAL_DERIVATIVE
 
 #define FIXED_SOLVER_STEP 1
 #define DEFAULT_STOP_TIME 10
 
-#define M_MAX 5
-#define N_MAX 5
-
 typedef enum {
     vr_time,
     vr_m,
@@ -34,12 +34,10 @@ typedef enum {
     vr_y
 } ValueReference;
 
+// u[n], A[m][n] (row-major) and y[m] are stored in the model buffer
 typedef struct {
     uint64_t m;
     uint64_t n;
-    double u[N_MAX];
-    double A[M_MAX][N_MAX];
-    double y[M_MAX];
 } ModelData;
 
 #endif /* config_h */
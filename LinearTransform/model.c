@@ -1,44 +1,224 @@
+#include <string.h>
+
 #include "config.h"
 #include "model.h"
 
+// equation blocks
+#define OUTPUTS (1 << 0)
+
+// rows that are multiplied at once so that every element of u is loaded once for all of them
+#define GEMV_ROWS 4
+
+// independent partial sums per row that the compiler can keep in SIMD registers
+#define GEMV_LANES 8
+
+// columns per block so that the block of u stays in the L1 cache while it is multiplied with all rows
+#define GEMV_BLOCK 2048
+
+
+// u[n], A[m][n] and y[m] in the model buffer
+static double* u(ModelInstance* comp) {
+    return (double*)comp->buffer;
+}
+
+static double* A(ModelInstance* comp) {
+    return u(comp) + M(n);
+}
+
+static double* y(ModelInstance* comp) {
+    return A(comp) + M(m) * M(n);
+}
 
-void setStartValues(ModelInstance *comp) {
+// allocate the variables for the dimensions m and n and set their start values
+static Status resize(ModelInstance* comp, uint64_t m, uint64_t n) {
+
+    if (n > SIZE_MAX / sizeof(double) || m > (SIZE_MAX / sizeof(double) - n) / (n + 1)) {
+        logError(comp, "The dimensions m = %llu and n = %llu are too large.", (unsigned long long)m, (unsigned long long)n);
+        return Error;
+    }
 
-    M(m) = 2;
-    M(n) = 2;
+    Status status = resizeModelBuffer(comp, (n + m * n + m) * sizeof(double));
+
+    if (status > Warning) {
+        return status;
+    }
+
+    M(m) = m;
+    M(n) = n;
 
     // identity matrix
-    for (int i = 0; i < M_MAX; i++) {
-    for (int j = 0; j < N_MAX; j++) {
-        M(A)[i][j] = i == j ? 1 : 0;
-    }}
+    double* a = A(comp);
+
+    memset(a, 0, m * n * sizeof(double));
 
-    for (int i = 0; i < M_MAX; i++) {
-        M(u)[i] = i + 1;
+    for (size_t i = 0; i < m && i < n; i++) {
+        a[i * n + i] = 1;
     }
 
-    for (int i = 0; i < N_MAX; i++) {
-        M(y)[i] = 0;
+    for (size_t j = 0; j < n; j++) {
+        u(comp)[j] = (double)(j + 1);
     }
 
+    memset(y(comp), 0, m * sizeof(double));
+
+    return status;
 }
 
-Status calculateValues(ModelInstance *comp) {
+Status setStartValues(ModelInstance *comp) {
+    return resize(comp, 2, 2);
+}
+
+// add the product of nRows rows of A and the columns [begin, end) of u to y
+static void multiplyBlock(size_t nRows, size_t n, const double* a, const double* x, size_t begin, size_t end, double* b) {
+
+    double sum[GEMV_ROWS][GEMV_LANES] = { { 0 } };
+
+    size_t j = begin;
+
+    for (; j + GEMV_LANES <= end; j += GEMV_LANES) {
+        for (size_t r = 0; r < nRows; r++) {
+            for (size_t k = 0; k < GEMV_LANES; k++) {
+                sum[r][k] += a[r * n + j + k] * x[j + k];
+            }
+        }
+    }
+
+    for (size_t r = 0; r < nRows; r++) {
+
+        double s = 0;
+
+        for (size_t k = 0; k < GEMV_LANES; k++) {
+            s += sum[r][k];
+        }
+
+        for (size_t l = j; l < end; l++) {
+            s += a[r * n + l] * x[l];
+        }
+
+        b[r] += s;
+    }
+}
+
+// y = A * u
+static void gemv(size_t m, size_t n, const double* a, const double* x, double* b) {
+
+    memset(b, 0, m * sizeof(double));
+
+    for (size_t begin = 0; begin < n; begin += GEMV_BLOCK) {
+
+        const size_t end = n - begin > GEMV_BLOCK ? begin + GEMV_BLOCK : n;
+
+        size_t i = 0;
+
+        for (; i + GEMV_ROWS <= m; i += GEMV_ROWS) {
+            multiplyBlock(GEMV_ROWS, n, &a[i * n], x, begin, end, &b[i]);
+        }
+
+        if (i < m) {
+            multiplyBlock(m - i, n, &a[i * n], x, begin, end, &b[i]);
+        }
+    }
+}
+
+// x = A^T * b
+static void gemvTransposed(size_t m, size_t n, const double* a, const double* b, double* x) {
+
+    memset(x, 0, n * sizeof(double));
+
+    size_t i = 0;
+
+    // add GEMV_ROWS scaled rows at once so that x is loaded and stored once for all of them
+    for (; i + GEMV_ROWS <= m; i += GEMV_ROWS) {
+
+        const double* a0 = &a[i * n];
+        const double* a1 = a0 + n;
+        const double* a2 = a1 + n;
+        const double* a3 = a2 + n;
+
+        for (size_t j = 0; j < n; j++) {
+            x[j] += a0[j] * b[i] + a1[j] * b[i + 1] + a2[j] * b[i + 2] + a3[j] * b[i + 3];
+        }
+    }
 
-    // y = A * u
-    for (size_t i = 0; i < M(m); i++) {
-        M(y)[i] = 0;
-        for (size_t j = 0; j < M(n); j++) {
-            M(y)[i] += M(A)[i][j] * M(u)[j];
+    for (; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            x[j] += a[i * n + j] * b[i];
         }
     }
+}
+
+// the Jacobian of y with respect to u is A
+static Status checkDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns) {
+
+    if (nUnknowns != 1 || unknowns[0] != vr_y || nKnowns != 1 || knowns[0] != vr_u) {
+        logError(comp, "Only the derivatives of y with respect to u are supported.");
+        return Error;
+    }
 
     return OK;
 }
 
-Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
+Status getDirectionalDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, const double seed[], size_t nSeed, double sensitivity[], size_t nSensitivity) {
+
+    Status status = checkDerivative(comp, unknowns, nUnknowns, knowns, nKnowns);
+
+    if (status > Warning) {
+        return status;
+    }
+
+    if (nSeed != M(n) || nSensitivity != M(m)) {
+        logError(comp, "Expected nSeed = %llu and nSensitivity = %llu but was %zu and %zu.",
+            (unsigned long long)M(n), (unsigned long long)M(m), nSeed, nSensitivity);
+        return Error;
+    }
+
+    gemv(M(m), M(n), A(comp), seed, sensitivity);
+
+    return OK;
+}
+
+Status getAdjointDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, const double seed[], size_t nSeed, double sensitivity[], size_t nSensitivity) {
+
+    Status status = checkDerivative(comp, unknowns, nUnknowns, knowns, nKnowns);
+
+    if (status > Warning) {
+        return status;
+    }
+
+    if (nSeed != M(m) || nSensitivity != M(n)) {
+        logError(comp, "Expected nSeed = %llu and nSensitivity = %llu but was %zu and %zu.",
+            (unsigned long long)M(m), (unsigned long long)M(n), nSeed, nSensitivity);
+        return Error;
+    }
+
+    gemvTransposed(M(m), M(n), A(comp), seed, sensitivity);
+
+    return OK;
+}
+
+Status calculateValues(ModelInstance *comp) {
+
+    gemv(M(m), M(n), A(comp), u(comp), y(comp));
+
+    return OK;
+}
+
+uint32_t dependentBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    return vr == vr_time ? 0 : OUTPUTS;
+}
 
-    calculateValues(comp);
+uint32_t requiredBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    return vr == vr_y ? OUTPUTS : 0;
+}
+
+Status calculateBlocks(ModelInstance* comp, uint32_t blocks) {
+    UNUSED(blocks);
+    return calculateValues(comp);
+}
+
+Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
 
     switch (vr) {
         case vr_time:
@@ -47,22 +227,18 @@ Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_
             return OK;
         case vr_u:
             ASSERT_NVALUES(M(n));
-            for (size_t i = 0; i < M(n); i++) {
-                values[(*index)++] = M(u)[i];
-            }
+            memcpy(&values[*index], u(comp), M(n) * sizeof(double));
+            *index += M(n);
             return OK;
         case vr_A:
             ASSERT_NVALUES(M(m) * M(n));
-            for (size_t i = 0; i < M(m); i++)
-            for (size_t j = 0; j < M(n); j++) {
-                values[(*index)++] = M(A)[i][j];
-            }
+            memcpy(&values[*index], A(comp), M(m) * M(n) * sizeof(double));
+            *index += M(m) * M(n);
             return OK;
         case vr_y:
-            ASSERT_NVALUES(1);
-            for (size_t i = 0; i < M(m); i++) {
-                values[(*index)++] = M(y)[i];
-            }
+            ASSERT_NVALUES(M(m));
+            memcpy(&values[*index], y(comp), M(m) * sizeof(double));
+            *index += M(m);
             return OK;
         default:
             logError(comp, "Get Float64 is not allowed for value reference %u.", vr);
@@ -75,17 +251,13 @@ Status setFloat64(ModelInstance* comp, ValueReference vr, const double values[],
     switch (vr) {
         case vr_u:
             ASSERT_NVALUES(M(n));
-            for (size_t i = 0; i < M(n); i++) {
-                M(u)[i] = values[(*index)++];
-            }
-            calculateValues(comp);
+            memcpy(u(comp), &values[*index], M(n) * sizeof(double));
+            *index += M(n);
             return OK;
         case vr_A:
             ASSERT_NVALUES(M(m) * M(n));
-            for (size_t i = 0; i < M(m); i++)
-            for (size_t j = 0; j < M(n); j++) {
-                M(A)[i][j] = values[(*index)++];
-            }
+            memcpy(A(comp), &values[*index], M(m) * M(n) * sizeof(double));
+            *index += M(m) * M(n);
             return OK;
         default:
             logError(comp, "Set Float64 is not allowed for value reference %u.", vr);
@@ -97,8 +269,6 @@ Status getUInt64(ModelInstance* comp, ValueReference vr, uint64_t values[], size
 
     ASSERT_NVALUES(1);
 
-    calculateValues(comp);
-
     switch (vr) {
         case vr_m:
             values[(*index)++] = M(m);
@@ -117,20 +287,23 @@ Status setUInt64(ModelInstance* comp, ValueReference vr, const uint64_t values[]
     ASSERT_NVALUES(1);
 
     if (comp->state != ConfigurationMode && comp->state != ReconfigurationMode) {
+        logError(comp, "The dimensions m and n can only be set in configuration mode.");
         return Error;
     }
 
     const uint64_t v = values[(*index)++];
 
+    if (v < 1) {
+        logError(comp, "The dimensions m and n must be at least 1.");
+        return Error;
+    }
+
+    // the variables are reallocated with their start values
     switch (vr) {
         case vr_m:
-            if (v < 1 || v > M_MAX) return Error;
-            M(m) = v;
-            return OK;
+            return v == M(m) ? OK : resize(comp, v, M(n));
         case vr_n:
-            if (v < 1 || v > N_MAX) return Error;
-            M(n) = v;
-            return OK;
+            return v == M(n) ? OK : resize(comp, M(m), v);
         default:
             logError(comp, "Set UInt64 is not allowed for value reference %u.", vr);
             return Error;
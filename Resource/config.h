@@ -14,6 +14,9 @@
 
 #define GET_INT32
 
+// resource files that are mapped into memory when the model is instantiated
+#define RESOURCE_FILES(X) X(y_txt, "y.txt")
+
 #define FIXED_SOLVER_STEP 1
 #define DEFAULT_STOP_TIME 1
 
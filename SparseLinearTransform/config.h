@@ -0,0 +1,46 @@
+#ifndef config_h
+#define config_h
+
+#include <stdint.h>
+
+// define class name and unique id
+#define MODEL_IDENTIFIER SparseLinearTransform
+#define INSTANTIATION_TOKEN "{549BCC17-A9D4-4E76-9FB8-BAB2D84102AF}"
+
+// define model size
+#define NX 0
+#define NZ 0
+
+#define CO_SIMULATION
+#define MODEL_EXCHANGE
+
+#define SET_FLOAT64
+#define GET_UINT64
+#define SET_UINT64
+#define EQUATION_BLOCKS
+#define EVENT_UPDATE
+#define MODEL_BUFFER
+
+#define FIXED_SOLVER_STEP 1
+#define DEFAULT_STOP_TIME 10
+
+typedef enum {
+    vr_time,
+    vr_m,
+    vr_n,
+    vr_nnz,
+    vr_u,
+    vr_rowPointers,
+    vr_columnIndices,
+    vr_values,
+    vr_y
+} ValueReference;
+
+// u[n], values[nnz], y[m], rowPointers[m] and columnIndices[nnz] are stored in the model buffer
+typedef struct {
+    uint64_t m;
+    uint64_t n;
+    uint64_t nnz;
+} ModelData;
+
+#endif /* config_h */
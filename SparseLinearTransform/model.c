@@ -0,0 +1,295 @@
+#include <string.h>
+
+#include "config.h"
+#include "model.h"
+
+// equation blocks
+#define STRUCTURE (1 << 0)
+#define OUTPUTS   (1 << 1)
+
+
+// u[n], values[nnz] (the non-zero elements of A) and y[m] followed by rowPointers[m] and columnIndices[nnz] in the model buffer
+static double* u(ModelInstance* comp) {
+    return (double*)comp->buffer;
+}
+
+static double* nonZeros(ModelInstance* comp) {
+    return u(comp) + M(n);
+}
+
+static double* y(ModelInstance* comp) {
+    return nonZeros(comp) + M(nnz);
+}
+
+static uint64_t* rowPointers(ModelInstance* comp) {
+    return (uint64_t*)(y(comp) + M(m));
+}
+
+static uint64_t* columnIndices(ModelInstance* comp) {
+    return rowPointers(comp) + M(m);
+}
+
+// allocate the variables for the dimensions m, n and nnz and set their start values
+static Status resize(ModelInstance* comp, uint64_t m, uint64_t n, uint64_t nnz) {
+
+    const uint64_t maxSize = SIZE_MAX / (5 * sizeof(double));
+
+    if (m > maxSize || n > maxSize || nnz > maxSize) {
+        logError(comp, "The dimensions m = %llu, n = %llu and nnz = %llu are too large.",
+            (unsigned long long)m, (unsigned long long)n, (unsigned long long)nnz);
+        return Error;
+    }
+
+    Status status = resizeModelBuffer(comp, (n + 2 * nnz + 2 * m) * sizeof(double));
+
+    if (status > Warning) {
+        return status;
+    }
+
+    M(m) = m;
+    M(n) = n;
+    M(nnz) = nnz;
+
+    // identity matrix with the remaining non-zero elements as explicit zeros in the last row
+    size_t d = m < n ? m : n;
+
+    if (nnz < d) {
+        d = nnz;
+    }
+
+    for (size_t i = 0; i < m; i++) {
+        rowPointers(comp)[i] = i < d ? i : d;
+    }
+
+    for (size_t k = 0; k < nnz; k++) {
+        columnIndices(comp)[k] = k < d ? k : 0;
+        nonZeros(comp)[k] = k < d ? 1 : 0;
+    }
+
+    for (size_t j = 0; j < n; j++) {
+        u(comp)[j] = (double)(j + 1);
+    }
+
+    memset(y(comp), 0, m * sizeof(double));
+
+    return status;
+}
+
+Status setStartValues(ModelInstance *comp) {
+    return resize(comp, 2, 2, 2);
+}
+
+// check that the row pointers and column indices describe a valid matrix
+static Status checkStructure(ModelInstance* comp) {
+
+    const uint64_t* p = rowPointers(comp);
+    const uint64_t* c = columnIndices(comp);
+
+    if (p[0] != 0) {
+        logError(comp, "The first row pointer must be 0.");
+        return Error;
+    }
+
+    for (size_t i = 1; i < M(m); i++) {
+        if (p[i] < p[i - 1] || p[i] > M(nnz)) {
+            logError(comp, "The row pointers must be in ascending order and not greater than nnz = %llu.",
+                (unsigned long long)M(nnz));
+            return Error;
+        }
+    }
+
+    for (size_t k = 0; k < M(nnz); k++) {
+        if (c[k] >= M(n)) {
+            logError(comp, "The column index columnIndices[%zu] = %llu must be less than n = %llu.",
+                k, (unsigned long long)c[k], (unsigned long long)M(n));
+            return Error;
+        }
+    }
+
+    return OK;
+}
+
+// y = A * u
+static void spmv(size_t m, size_t nnz, const uint64_t* p, const uint64_t* c, const double* a, const double* x, double* b) {
+
+    for (size_t i = 0; i < m; i++) {
+
+        const size_t end = i + 1 < m ? p[i + 1] : nnz;
+
+        double s = 0;
+
+        for (size_t k = p[i]; k < end; k++) {
+            s += a[k] * x[c[k]];
+        }
+
+        b[i] = s;
+    }
+}
+
+Status calculateValues(ModelInstance *comp) {
+    return calculateBlocks(comp, STRUCTURE | OUTPUTS);
+}
+
+uint32_t dependentBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    switch (vr) {
+        case vr_time:
+            return 0;
+        case vr_u:
+        case vr_values:
+            return OUTPUTS;
+        default:
+            return STRUCTURE | OUTPUTS;
+    }
+}
+
+uint32_t requiredBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    return vr == vr_y ? STRUCTURE | OUTPUTS : 0;
+}
+
+Status calculateBlocks(ModelInstance* comp, uint32_t blocks) {
+
+    if (blocks & STRUCTURE) {
+        Status status = checkStructure(comp);
+        if (status > Warning) {
+            return status;
+        }
+    }
+
+    if (blocks & OUTPUTS) {
+        spmv(M(m), M(nnz), rowPointers(comp), columnIndices(comp), nonZeros(comp), u(comp), y(comp));
+    }
+
+    return OK;
+}
+
+Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
+
+    switch (vr) {
+        case vr_time:
+            ASSERT_NVALUES(1);
+            values[(*index)++] = comp->time;
+            return OK;
+        case vr_u:
+            ASSERT_NVALUES(M(n));
+            memcpy(&values[*index], u(comp), M(n) * sizeof(double));
+            *index += M(n);
+            return OK;
+        case vr_values:
+            ASSERT_NVALUES(M(nnz));
+            memcpy(&values[*index], nonZeros(comp), M(nnz) * sizeof(double));
+            *index += M(nnz);
+            return OK;
+        case vr_y:
+            ASSERT_NVALUES(M(m));
+            memcpy(&values[*index], y(comp), M(m) * sizeof(double));
+            *index += M(m);
+            return OK;
+        default:
+            logError(comp, "Get Float64 is not allowed for value reference %u.", vr);
+            return Error;
+    }
+}
+
+Status setFloat64(ModelInstance* comp, ValueReference vr, const double values[], size_t nValues, size_t* index) {
+
+    switch (vr) {
+        case vr_u:
+            ASSERT_NVALUES(M(n));
+            memcpy(u(comp), &values[*index], M(n) * sizeof(double));
+            *index += M(n);
+            return OK;
+        case vr_values:
+            ASSERT_NVALUES(M(nnz));
+            memcpy(nonZeros(comp), &values[*index], M(nnz) * sizeof(double));
+            *index += M(nnz);
+            return OK;
+        default:
+            logError(comp, "Set Float64 is not allowed for value reference %u.", vr);
+            return Error;
+    }
+}
+
+Status getUInt64(ModelInstance* comp, ValueReference vr, uint64_t values[], size_t nValues, size_t* index) {
+
+    switch (vr) {
+        case vr_m:
+            ASSERT_NVALUES(1);
+            values[(*index)++] = M(m);
+            return OK;
+        case vr_n:
+            ASSERT_NVALUES(1);
+            values[(*index)++] = M(n);
+            return OK;
+        case vr_nnz:
+            ASSERT_NVALUES(1);
+            values[(*index)++] = M(nnz);
+            return OK;
+        case vr_rowPointers:
+            ASSERT_NVALUES(M(m));
+            memcpy(&values[*index], rowPointers(comp), M(m) * sizeof(uint64_t));
+            *index += M(m);
+            return OK;
+        case vr_columnIndices:
+            ASSERT_NVALUES(M(nnz));
+            memcpy(&values[*index], columnIndices(comp), M(nnz) * sizeof(uint64_t));
+            *index += M(nnz);
+            return OK;
+        default:
+            logError(comp, "Get UInt64 is not allowed for value reference %u.", vr);
+            return Error;
+    }
+}
+
+Status setUInt64(ModelInstance* comp, ValueReference vr, const uint64_t values[], size_t nValues, size_t* index) {
+
+    switch (vr) {
+        case vr_rowPointers:
+            ASSERT_NVALUES(M(m));
+            memcpy(rowPointers(comp), &values[*index], M(m) * sizeof(uint64_t));
+            *index += M(m);
+            return OK;
+        case vr_columnIndices:
+            ASSERT_NVALUES(M(nnz));
+            memcpy(columnIndices(comp), &values[*index], M(nnz) * sizeof(uint64_t));
+            *index += M(nnz);
+            return OK;
+        default:
+            break;
+    }
+
+    ASSERT_NVALUES(1);
+
+    if (comp->state != ConfigurationMode && comp->state != ReconfigurationMode) {
+        logError(comp, "The dimensions m, n and nnz can only be set in configuration mode.");
+        return Error;
+    }
+
+    const uint64_t v = values[(*index)++];
+
+    if (v < 1) {
+        logError(comp, "The dimensions m, n and nnz must be at least 1.");
+        return Error;
+    }
+
+    // the variables are reallocated with their start values
+    switch (vr) {
+        case vr_m:
+            return v == M(m) ? OK : resize(comp, v, M(n), M(nnz));
+        case vr_n:
+            return v == M(n) ? OK : resize(comp, M(m), v, M(nnz));
+        case vr_nnz:
+            return v == M(nnz) ? OK : resize(comp, M(m), M(n), v);
+        default:
+            logError(comp, "Set UInt64 is not allowed for value reference %u.", vr);
+            return Error;
+    }
+}
+
+void eventUpdate(ModelInstance *comp) {
+    comp->valuesOfContinuousStatesChanged   = false;
+    comp->nominalsOfContinuousStatesChanged = false;
+    comp->terminateSimulation               = false;
+    comp->nextEventTimeDefined              = false;
+}
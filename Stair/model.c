@@ -4,12 +4,14 @@
 #include "model.h"
 
 
-void setStartValues(ModelInstance *comp) {
+Status setStartValues(ModelInstance *comp) {
     M(counter) = 1;
 
     // TODO: move this to initialize()?
     comp->nextEventTime        = 1;
     comp->nextEventTimeDefined = true;
+
+    return OK;
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -1,6 +1,8 @@
 #ifndef config_h
 #define config_h
 
+#include "fixedSolver.h"
+
 // define class name and unique id
 #define MODEL_IDENTIFIER VanDerPol
 #define INSTANTIATION_TOKEN "{BD403596-3166-4232-ABC2-132BDF73E644}"
@@ -13,9 +15,19 @@
 #define NZ 0
 
 #define SET_FLOAT64
+#define EQUATION_BLOCKS
 
 #define GET_PARTIAL_DERIVATIVE
 
+// the ensemble functions integrate with the forward Euler method
+#if FIXED_SOLVER == FIXED_SOLVER_EULER
+#define ENSEMBLE
+#endif
+
+// skip the event checks of doFixedStep() in DoStep (the model has no event indicators)
+#define FAST_FIXED_STEPS
+#define ASYNC_DO_STEP
+
 #define FIXED_SOLVER_STEP 1e-2
 #define DEFAULT_STOP_TIME 20
 
@@ -33,4 +45,7 @@ typedef struct {
 
 } ModelData;
 
+#define ENSEMBLE_VARIABLES(X) X(x0) X(der_x0) X(x1) X(der_x1) X(mu)
+#define ENSEMBLE_STATES(X) X(x0, der_x0) X(x1, der_x1)
+
 #endif /* config_h */
@@ -1,25 +1,73 @@
 #include "config.h"
 #include "model.h"
 
+// equation blocks
+#define DER_X0 (1 << 0)
+#define DER_X1 (1 << 1)
 
-void setStartValues(ModelInstance *comp) {
+
+Status setStartValues(ModelInstance *comp) {
     M(x0) = 2;
     M(x1) = 0;
     M(mu) = 1;
+
+    return OK;
 }
 
 Status calculateValues(ModelInstance *comp) {
-    M(der_x0) = M(x1);
-    M(der_x1) = M(mu) * ((1.0 - M(x0) * M(x0)) * M(x1)) - M(x0);
-    return OK;
+    return calculateBlocks(comp, DER_X0 | DER_X1);
+}
+
+uint32_t dependentBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    switch (vr) {
+        case vr_x0:
+        case vr_mu:
+            return DER_X1;
+        case vr_x1:
+            return DER_X0 | DER_X1;
+        default:
+            return 0;
+    }
+}
+
+uint32_t requiredBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    switch (vr) {
+        case vr_der_x0:
+            return DER_X0;
+        case vr_der_x1:
+            return DER_X1;
+        default:
+            return 0;
+    }
+}
+
+void calculateEnsembleBlocks(EnsembleData* data, uint32_t blocks, size_t begin, size_t end) {
+
+    const double* x0 = data->x0;
+    const double* x1 = data->x1;
+    const double* mu = data->mu;
+
+    if (blocks & DER_X0) {
+        double* der_x0 = data->der_x0;
+        for (size_t i = begin; i < end; i++) {
+            der_x0[i] = x1[i];
+        }
+    }
+
+    if (blocks & DER_X1) {
+        double* der_x1 = data->der_x1;
+        for (size_t i = begin; i < end; i++) {
+            der_x1[i] = mu[i] * ((1.0 - x0[i] * x0[i]) * x1[i]) - x0[i];
+        }
+    }
 }
 
 Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
 
     ASSERT_NVALUES(1);
 
-    calculateValues(comp);
-
     switch (vr) {
         case vr_time:
             values[(*index)++] = comp->time;
@@ -84,12 +132,12 @@ void setContinuousStates(ModelInstance *comp, const double x[], size_t nx) {
     UNUSED(nx);
     M(x0) = x[0];
     M(x1) = x[1];
-    calculateValues(comp);
+    comp->dirtyBlocks |= DER_X0 | DER_X1;
 }
 
 void getDerivatives(ModelInstance *comp, double dx[], size_t nx) {
     UNUSED(nx);
-    calculateValues(comp);
+    updateValues(comp, DER_X0 | DER_X1);
     dx[0] = M(der_x0);
     dx[1] = M(der_x1);
 }
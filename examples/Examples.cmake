@@ -41,6 +41,129 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # ensemble_benchmark
+    add_executable(ensemble_benchmark
+        include/cosimulation.h
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/fmi3PlatformTypes.h
+        include/model.h
+        VanDerPol/config.h
+        src/fmi3Functions.c
+        VanDerPol/model.c
+        src/cosimulation.c
+        examples/ensemble_benchmark.c
+    )
+    set_target_properties (ensemble_benchmark PROPERTIES FOLDER examples)
+    target_compile_definitions(ensemble_benchmark PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(ensemble_benchmark PRIVATE include VanDerPol)
+    if(UNIX)
+        target_link_libraries(ensemble_benchmark m)
+    endif()
+    set_target_properties(ensemble_benchmark PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    # equation_blocks
+    add_executable(equation_blocks
+        include/cosimulation.h
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/fmi3PlatformTypes.h
+        include/model.h
+        VanDerPol/config.h
+        src/fmi3Functions.c
+        VanDerPol/model.c
+        src/cosimulation.c
+        examples/equation_blocks.c
+    )
+    set_target_properties (equation_blocks PROPERTIES FOLDER examples)
+    target_compile_definitions(equation_blocks PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(equation_blocks PRIVATE include VanDerPol)
+    if(UNIX)
+        target_link_libraries(equation_blocks m)
+    endif()
+    set_target_properties(equation_blocks PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    # gemv_benchmark
+    add_executable(gemv_benchmark
+        include/cosimulation.h
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/fmi3PlatformTypes.h
+        include/model.h
+        LinearTransform/config.h
+        src/fmi3Functions.c
+        LinearTransform/model.c
+        src/cosimulation.c
+        examples/gemv_benchmark.c
+    )
+    set_target_properties (gemv_benchmark PROPERTIES FOLDER examples)
+    target_compile_definitions(gemv_benchmark PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(gemv_benchmark PRIVATE include LinearTransform)
+    if(UNIX)
+        target_link_libraries(gemv_benchmark m)
+    endif()
+    set_target_properties(gemv_benchmark PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    # linear_transform_derivatives
+    add_executable(linear_transform_derivatives
+        include/cosimulation.h
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/fmi3PlatformTypes.h
+        include/model.h
+        LinearTransform/config.h
+        src/fmi3Functions.c
+        LinearTransform/model.c
+        src/cosimulation.c
+        examples/linear_transform_derivatives.c
+    )
+    set_target_properties (linear_transform_derivatives PROPERTIES FOLDER examples)
+    target_compile_definitions(linear_transform_derivatives PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(linear_transform_derivatives PRIVATE include LinearTransform)
+    if(UNIX)
+        target_link_libraries(linear_transform_derivatives m)
+    endif()
+    set_target_properties(linear_transform_derivatives PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    # resource_files
+    add_executable(resource_files
+        include/cosimulation.h
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/fmi3PlatformTypes.h
+        include/model.h
+        Resource/config.h
+        src/fmi3Functions.c
+        Resource/model.c
+        src/cosimulation.c
+        examples/resource_files.c
+    )
+    set_target_properties (resource_files PROPERTIES FOLDER examples)
+    target_compile_definitions(resource_files PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(resource_files PRIVATE include Resource)
+    target_link_libraries(resource_files Threads::Threads)
+    set_target_properties(resource_files PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
     # import_shared_library
     add_executable(import_shared_library
         include/fmi3FunctionTypes.h
@@ -132,6 +255,23 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # fmu_state_benchmark
+    add_executable(fmu_state_benchmark
+        ${EXAMPLE_SOURCES}
+        BouncingBall/config.h
+        examples/fmu_state_benchmark.c
+    )
+    add_dependencies(fmu_state_benchmark BouncingBall)
+    set_target_properties(fmu_state_benchmark PROPERTIES FOLDER examples)
+    target_compile_definitions(fmu_state_benchmark PRIVATE FMI_VERSION=${FMI_VERSION} DISABLE_PREFIX)
+    target_include_directories(fmu_state_benchmark PRIVATE include BouncingBall)
+    target_link_libraries(fmu_state_benchmark ${LIBRARIES})
+    set_target_properties(fmu_state_benchmark PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
     # scs_synchronous
     add_executable (scs_synchronous
         ${EXAMPLE_SOURCES}
@@ -150,6 +290,27 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    if (UNIX AND NOT APPLE)
+        # scs_benchmark
+        add_executable (scs_benchmark
+            ${EXAMPLE_SOURCES}
+            Clocks/config.h
+            fmusim/FMIScheduler.h
+            fmusim/FMIScheduler.c
+            examples/scs_benchmark.c
+        )
+        add_dependencies(scs_benchmark Clocks)
+        set_target_properties(scs_benchmark PROPERTIES FOLDER examples)
+        target_compile_definitions(scs_benchmark PRIVATE FMI_VERSION=${FMI_VERSION})
+        target_include_directories(scs_benchmark PRIVATE include Clocks fmusim)
+        target_link_libraries(scs_benchmark ${LIBRARIES} Threads::Threads)
+        set_target_properties(scs_benchmark PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+    endif ()
+
     if (WIN32)
         add_executable (scs_threaded
             ${EXAMPLE_SOURCES}
@@ -170,6 +331,27 @@ if (${FMI_VERSION} EQUAL 3)
 
 endif()
 
+if (${FMI_VERSION} EQUAL 2)
+
+    # cs_async_step
+    add_executable(cs_async_step
+        ${EXAMPLE_SOURCES}
+        VanDerPol/config.h
+        examples/cs_async_step.c
+    )
+    add_dependencies(cs_async_step VanDerPol)
+    set_target_properties(cs_async_step PROPERTIES FOLDER examples)
+    target_compile_definitions(cs_async_step PRIVATE FMI_VERSION=${FMI_VERSION} DISABLE_PREFIX)
+    target_include_directories(cs_async_step PRIVATE include VanDerPol)
+    target_link_libraries(cs_async_step ${LIBRARIES})
+    set_target_properties(cs_async_step PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+endif()
+
 # Examples
 set(MODEL_NAMES BouncingBall Dahlquist Feedthrough Stair VanDerPol)
 
@@ -184,7 +366,7 @@ elseif(${FMI_VERSION} EQUAL 2)
     set(MODEL_NAMES ${MODEL_NAMES} Resource)
     set(INTERFACE_TYPES cs me)
 else()
-    set(MODEL_NAMES ${MODEL_NAMES} LinearTransform Resource)
+    set(MODEL_NAMES ${MODEL_NAMES} LinearTransform SparseLinearTransform Resource)
     set(INTERFACE_TYPES cs me)
 endif()
 
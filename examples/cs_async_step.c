@@ -0,0 +1,81 @@
+/* This example computes the steps of the VanDerPol model asynchronously: fmi2DoStep() returns fmi2Pending,
+   the FMU computes the step on its worker thread and the master polls the status of the step */
+
+#include "util.h"
+
+
+static void stepFinished(FMIInstance *instance, FMIStatus status) {
+    // called on the worker thread of the FMU (e.g. to notify the master that is waiting for several FMUs)
+}
+
+int main(int argc, char* argv[]) {
+
+    CALL(setUp());
+
+    // request asynchronous steps
+    S->stepFinished = stepFinished;
+
+    CALL(FMI2Instantiate(S,
+        resourceURI(),       // fmuResourceLocation
+        fmi2CoSimulation,    // fmuType
+        INSTANTIATION_TOKEN, // fmuGUID
+        fmi2False,           // visible
+        fmi2False            // loggingOn
+    ));
+
+    CALL(FMI2SetupExperiment(S, fmi2False, 0.0, startTime, fmi2True, stopTime));
+    CALL(FMI2EnterInitializationMode(S));
+    CALL(FMI2ExitInitializationMode(S));
+
+    // cancel a step that runs to the stop time
+    if (FMI2DoStep(S, startTime, stopTime - startTime, fmi2True) != FMIPending) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(FMI2CancelStep(S));
+
+    // start over
+    CALL(FMI2Reset(S));
+    CALL(FMI2SetupExperiment(S, fmi2False, 0.0, startTime, fmi2True, stopTime));
+    CALL(FMI2EnterInitializationMode(S));
+    CALL(FMI2ExitInitializationMode(S));
+
+    const fmi2Real stepSize = 10 * h;
+
+    size_t nPolls = 0;
+
+    for (uint64_t step = 0;; step++) {
+
+        const fmi2Real time = step * stepSize;
+
+        if (time + stepSize > stopTime + h / 2) {
+            break;
+        }
+
+        if (FMI2DoStep(S, time, stepSize, fmi2True) != FMIPending) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        fmi2Status doStepStatus = fmi2Pending;
+
+        while (doStepStatus == fmi2Pending) {
+            // the master can do other work here
+            nPolls++;
+            CALL(FMI2GetStatus(S, fmi2DoStepStatus, &doStepStatus));
+        }
+
+        CALL((FMIStatus)doStepStatus);
+    }
+
+    const fmi2ValueReference vr_x0 = 1;
+    fmi2Real x0;
+
+    CALL(FMI2GetReal(S, &vr_x0, 1, &x0));
+
+    printf("x0 = %.16g at t = %g (%zu status requests)\n", x0, stopTime, nPolls);
+
+TERMINATE:
+    return tearDown();
+}
@@ -0,0 +1,125 @@
+/* This example compares the throughput of an ensemble of VanDerPol models in structure-of-arrays layout
+   with that of individual instances that are simulated through the FMI API */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define FMI3_FUNCTION_PREFIX VanDerPol_
+#include "fmi3Functions.h"
+#include "refEnsembleFunctions.h"
+#undef FMI3_FUNCTION_PREFIX
+
+#include "model.h"
+
+#define N_MEMBERS 4096
+#define COMMUNICATION_STEP_SIZE 0.1
+
+
+static double elapsed(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// parameter sweep over the members
+static double mu(size_t i) {
+    return 0.5 + (double)i / N_MEMBERS;
+}
+
+int main(int argc, char* argv[]) {
+
+    const double startTime = 0;
+    const double stopTime = DEFAULT_STOP_TIME;
+    const size_t nSteps = (size_t)round((stopTime - startTime) / COMMUNICATION_STEP_SIZE);
+    const fmi3ValueReference vr_mu_ = vr_mu;
+    const fmi3ValueReference vr_x0_ = vr_x0;
+
+    double* x0 = (double*)calloc(N_MEMBERS, sizeof(double));
+
+    if (!x0) {
+        return EXIT_FAILURE;
+    }
+
+    // one instance per member
+    clock_t start = clock();
+
+    for (size_t i = 0; i < N_MEMBERS; i++) {
+
+        fmi3Instance instance = VanDerPol_fmi3InstantiateCoSimulation("instance", INSTANTIATION_TOKEN, NULL,
+            fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL, NULL, NULL);
+
+        if (!instance) {
+            return EXIT_FAILURE;
+        }
+
+        const double value = mu(i);
+
+        VanDerPol_fmi3SetFloat64(instance, &vr_mu_, 1, &value, 1);
+        VanDerPol_fmi3EnterInitializationMode(instance, fmi3False, 0, startTime, fmi3True, stopTime);
+        VanDerPol_fmi3ExitInitializationMode(instance);
+
+        for (size_t step = 0; step < nSteps; step++) {
+
+            const double time = startTime + step * COMMUNICATION_STEP_SIZE;
+
+            fmi3Boolean eventHandlingNeeded, terminateSimulation, earlyReturn;
+            fmi3Float64 lastSuccessfulTime;
+
+            VanDerPol_fmi3DoStep(instance, time, COMMUNICATION_STEP_SIZE, fmi3True,
+                &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+        }
+
+        VanDerPol_fmi3GetFloat64(instance, &vr_x0_, 1, &x0[i], 1);
+        VanDerPol_fmi3Terminate(instance);
+        VanDerPol_fmi3FreeInstance(instance);
+    }
+
+    double t = elapsed(start);
+
+    printf("instances: %d trajectories in %g s (%g trajectories/s)\n", N_MEMBERS, t, N_MEMBERS / t);
+
+    // one ensemble for all members
+    start = clock();
+
+    refEnsemble ensemble = VanDerPol_refInstantiateEnsemble(INSTANTIATION_TOKEN, N_MEMBERS, startTime);
+
+    double* values = (double*)calloc(N_MEMBERS, sizeof(double));
+
+    if (!ensemble || !values) {
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < N_MEMBERS; i++) {
+        values[i] = mu(i);
+    }
+
+    VanDerPol_refSetEnsembleFloat64(ensemble, vr_mu_, values, N_MEMBERS);
+
+    for (size_t step = 0; step < nSteps; step++) {
+
+        const double time = startTime + step * COMMUNICATION_STEP_SIZE;
+
+        VanDerPol_refDoStepEnsemble(ensemble, time, COMMUNICATION_STEP_SIZE);
+    }
+
+    VanDerPol_refGetEnsembleFloat64(ensemble, vr_x0_, values, N_MEMBERS);
+
+    t = elapsed(start);
+
+    printf("ensemble:  %d trajectories in %g s (%g trajectories/s)\n", N_MEMBERS, t, N_MEMBERS / t);
+
+    // the ensemble must produce the same results as the instances
+    double maxError = 0;
+
+    for (size_t i = 0; i < N_MEMBERS; i++) {
+        maxError = fmax(maxError, fabs(values[i] - x0[i]));
+    }
+
+    printf("max. difference of x0: %g\n", maxError);
+
+    VanDerPol_refFreeEnsemble(ensemble);
+    free(values);
+    free(x0);
+
+    return maxError == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
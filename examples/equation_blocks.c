@@ -0,0 +1,74 @@
+/* This example demonstrates that getting a variable only calculates the equation blocks it requires */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FMI3_FUNCTION_PREFIX VanDerPol_
+#include "fmi3Functions.h"
+#undef FMI3_FUNCTION_PREFIX
+
+#include "model.h"
+
+// sentinel for values that have not been calculated
+#define NOT_CALCULATED -1e300
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        printf("Check failed: %s (line %d)\n", #condition, __LINE__); \
+        status = EXIT_FAILURE; \
+        goto TERMINATE; \
+    }
+
+
+int main(int argc, char* argv[]) {
+
+    int status = EXIT_SUCCESS;
+
+    const fmi3ValueReference vr_x0_     = vr_x0;
+    const fmi3ValueReference vr_der_x0_ = vr_der_x0;
+    const fmi3ValueReference vr_der_x1_ = vr_der_x1;
+
+    const fmi3Float64 x0 = 1;
+    fmi3Float64 der_x0, der_x1;
+
+    fmi3Instance instance = VanDerPol_fmi3InstantiateModelExchange("instance", INSTANTIATION_TOKEN, NULL,
+        fmi3False, fmi3False, NULL, NULL);
+
+    if (!instance) {
+        return EXIT_FAILURE;
+    }
+
+    ModelInstance* comp = (ModelInstance*)instance;
+
+    CHECK(VanDerPol_fmi3EnterInitializationMode(instance, fmi3False, 0, 0, fmi3False, 0) == fmi3OK);
+
+    // x0 = 2, x1 = 0 and mu = 1
+    comp->modelData.der_x0 = NOT_CALCULATED;
+    comp->modelData.der_x1 = NOT_CALCULATED;
+
+    // der_x0 = x1 is calculated without der_x1
+    CHECK(VanDerPol_fmi3GetFloat64(instance, &vr_der_x0_, 1, &der_x0, 1) == fmi3OK);
+    CHECK(der_x0 == 0);
+    CHECK(comp->modelData.der_x1 == NOT_CALCULATED);
+
+    // der_x1 = mu * (1 - x0^2) * x1 - x0
+    CHECK(VanDerPol_fmi3GetFloat64(instance, &vr_der_x1_, 1, &der_x1, 1) == fmi3OK);
+    CHECK(der_x1 == -2);
+
+    // setting x0 only invalidates der_x1
+    comp->modelData.der_x0 = NOT_CALCULATED;
+
+    CHECK(VanDerPol_fmi3SetFloat64(instance, &vr_x0_, 1, &x0, 1) == fmi3OK);
+
+    CHECK(VanDerPol_fmi3GetFloat64(instance, &vr_der_x1_, 1, &der_x1, 1) == fmi3OK);
+    CHECK(der_x1 == -1);
+
+    CHECK(VanDerPol_fmi3GetFloat64(instance, &vr_der_x0_, 1, &der_x0, 1) == fmi3OK);
+    CHECK(der_x0 == NOT_CALCULATED);
+
+TERMINATE:
+
+    VanDerPol_fmi3FreeInstance(instance);
+
+    return status;
+}
@@ -0,0 +1,85 @@
+#include <time.h>
+
+#include "util.h"
+
+#define N_ITERATIONS 1000000
+
+
+static double elapsed(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char* argv[]) {
+
+    fmi3FMUState FMUState = NULL;
+
+    CALL(setUp());
+
+    // don't measure the logging
+    S->logFunctionCall = NULL;
+
+    CALL(FMI3InstantiateCoSimulation(S,
+        INSTANTIATION_TOKEN, // instantiationToken
+        NULL,                // resourcePath
+        fmi3False,           // visible
+        fmi3False,           // loggingOn
+        fmi3False,           // eventModeUsed
+        fmi3False,           // earlyReturnAllowed
+        NULL,                // requiredIntermediateVariables
+        0,                   // nRequiredIntermediateVariables
+        NULL                 // intermediateUpdate
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0.0, startTime, fmi3False, 0.0));
+
+    CALL(FMI3ExitInitializationMode(S));
+
+    // get, set and free a new FMU state in every iteration
+    clock_t start = clock();
+
+    for (size_t i = 0; i < N_ITERATIONS; i++) {
+        CALL(FMI3GetFMUState(S, &FMUState));
+        CALL(FMI3SetFMUState(S, FMUState));
+        CALL(FMI3FreeFMUState(S, &FMUState));
+    }
+
+    double t = elapsed(start);
+
+    printf("get / set / free: %d iterations in %g s (%g iterations/s)\n", N_ITERATIONS, t, N_ITERATIONS / t);
+
+    // overwrite the same FMU state in every iteration
+    start = clock();
+
+    for (size_t i = 0; i < N_ITERATIONS; i++) {
+        CALL(FMI3GetFMUState(S, &FMUState));
+        CALL(FMI3SetFMUState(S, FMUState));
+    }
+
+    t = elapsed(start);
+
+    printf("get / set:        %d iterations in %g s (%g iterations/s)\n", N_ITERATIONS, t, N_ITERATIONS / t);
+
+    // roll back a step in every iteration
+    start = clock();
+
+    for (size_t i = 0; i < N_ITERATIONS; i++) {
+
+        fmi3Boolean terminate;
+
+        CALL(FMI3GetFMUState(S, &FMUState));
+        CALL(FMI3DoStep(S, startTime, h, fmi3False, &eventEncountered, &terminate, &earlyReturn, &lastSuccessfulTime));
+        CALL(FMI3SetFMUState(S, FMUState));
+    }
+
+    t = elapsed(start);
+
+    printf("get / step / set: %d iterations in %g s (%g iterations/s)\n", N_ITERATIONS, t, N_ITERATIONS / t);
+
+TERMINATE:
+
+    if (S && FMUState) {
+        FMI3FreeFMUState(S, &FMUState);
+    }
+
+    return tearDown();
+}
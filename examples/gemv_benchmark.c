@@ -0,0 +1,121 @@
+/* This example measures the throughput of the matrix-vector product y = A * u of the LinearTransform model for
+   square matrices from 10 x 10 to 2000 x 2000 and compares it with a naive loop */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define FMI3_FUNCTION_PREFIX LinearTransform_
+#include "fmi3Functions.h"
+#undef FMI3_FUNCTION_PREFIX
+
+#include "config.h"
+
+// multiply-adds per size so that every size takes about the same time
+#define N_OPERATIONS 1e9
+
+
+static double elapsed(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void naiveGemv(size_t m, size_t n, const double* A, const double* u, double* y) {
+    for (size_t i = 0; i < m; i++) {
+        y[i] = 0;
+        for (size_t j = 0; j < n; j++) {
+            y[i] += A[i * n + j] * u[j];
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    const size_t sizes[] = { 10, 20, 50, 100, 200, 500, 1000, 2000 };
+    const fmi3ValueReference vr_m_ = vr_m, vr_n_ = vr_n, vr_u_ = vr_u, vr_A_ = vr_A, vr_y_ = vr_y;
+
+    double maxError = 0;
+
+    printf("size         iterations   naive [GFLOP/s]   model [GFLOP/s]\n");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+
+        const size_t n = sizes[s];
+        const uint64_t dimension = n;
+        const size_t nIterations = (size_t)(N_OPERATIONS / (n * n)) + 1;
+
+        double* A = (double*)malloc(n * n * sizeof(double));
+        double* u = (double*)malloc(n * sizeof(double));
+        double* y = (double*)malloc(n * sizeof(double));
+        double* y_ = (double*)malloc(n * sizeof(double));
+
+        if (!A || !u || !y || !y_) {
+            return EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < n * n; i++) {
+            A[i] = (double)rand() / RAND_MAX - 0.5;
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            u[j] = (double)rand() / RAND_MAX - 0.5;
+        }
+
+        fmi3Instance instance = LinearTransform_fmi3InstantiateCoSimulation("instance", INSTANTIATION_TOKEN, NULL,
+            fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL, NULL, NULL);
+
+        if (!instance ||
+            LinearTransform_fmi3EnterConfigurationMode(instance) > fmi3OK ||
+            LinearTransform_fmi3SetUInt64(instance, &vr_m_, 1, &dimension, 1) > fmi3OK ||
+            LinearTransform_fmi3SetUInt64(instance, &vr_n_, 1, &dimension, 1) > fmi3OK ||
+            LinearTransform_fmi3ExitConfigurationMode(instance) > fmi3OK ||
+            LinearTransform_fmi3SetFloat64(instance, &vr_A_, 1, A, n * n) > fmi3OK ||
+            LinearTransform_fmi3EnterInitializationMode(instance, fmi3False, 0, 0, fmi3False, 0) > fmi3OK ||
+            LinearTransform_fmi3ExitInitializationMode(instance) > fmi3OK) {
+            return EXIT_FAILURE;
+        }
+
+        clock_t start = clock();
+
+        for (size_t k = 0; k < nIterations; k++) {
+            u[k % n] += 1e-3;
+            naiveGemv(n, n, A, u, y_);
+        }
+
+        const double naiveTime = elapsed(start);
+
+        // set a new input in every iteration so that the outputs are recalculated
+        start = clock();
+
+        for (size_t k = 0; k < nIterations; k++) {
+            u[k % n] -= 1e-3;
+            LinearTransform_fmi3SetFloat64(instance, &vr_u_, 1, u, n);
+            LinearTransform_fmi3GetFloat64(instance, &vr_y_, 1, y, n);
+        }
+
+        const double modelTime = elapsed(start);
+
+        // compare the last result with the naive loop
+        naiveGemv(n, n, A, u, y_);
+
+        for (size_t i = 0; i < n; i++) {
+            maxError = fmax(maxError, fabs(y[i] - y_[i]));
+        }
+
+        const double flops = 2.0 * n * n * nIterations;
+
+        printf("%4zu x %-4zu %11zu %17.2f %17.2f\n", n, n, nIterations, 1e-9 * flops / naiveTime, 1e-9 * flops / modelTime);
+
+        LinearTransform_fmi3Terminate(instance);
+        LinearTransform_fmi3FreeInstance(instance);
+
+        free(A);
+        free(u);
+        free(y);
+        free(y_);
+    }
+
+    printf("max. difference of y: %g\n", maxError);
+
+    return maxError < 1e-9 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+/* This example checks the directional derivatives A * v and adjoint derivatives A^T * w of the LinearTransform model
+   against a dense matrix-vector product for dimensions that are not multiples of the block sizes */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FMI3_FUNCTION_PREFIX LinearTransform_
+#include "fmi3Functions.h"
+#undef FMI3_FUNCTION_PREFIX
+
+#include "config.h"
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        printf("Check failed: %s (line %d)\n", #condition, __LINE__); \
+        status = EXIT_FAILURE; \
+        goto TERMINATE; \
+    }
+
+
+static double randomValue(void) {
+    return (double)rand() / RAND_MAX - 0.5;
+}
+
+// maximum difference of the n values of x and y relative to the largest value of y
+static double maxDifference(size_t n, const double* x, const double* y) {
+
+    double difference = 0, scale = 1;
+
+    for (size_t i = 0; i < n; i++) {
+        difference = fmax(difference, fabs(x[i] - y[i]));
+        scale = fmax(scale, fabs(y[i]));
+    }
+
+    return difference / scale;
+}
+
+static int checkDerivatives(size_t m, size_t n) {
+
+    int status = EXIT_SUCCESS;
+
+    const fmi3ValueReference vr_m_ = vr_m, vr_n_ = vr_n, vr_u_ = vr_u, vr_A_ = vr_A, vr_y_ = vr_y;
+    const fmi3ValueReference unknowns[] = { vr_y, vr_y };
+    const uint64_t m_ = m, n_ = n;
+
+    fmi3Instance instance = NULL;
+
+    double* A = (double*)malloc(m * n * sizeof(double));
+    double* v = (double*)malloc((n + 1) * sizeof(double));
+    double* w = (double*)malloc((m + 1) * sizeof(double));
+    double* Av = (double*)malloc((m + 1) * sizeof(double));
+    double* ATw = (double*)malloc((n + 1) * sizeof(double));
+    double* reference = (double*)malloc((m + n) * sizeof(double));
+
+    CHECK(A && v && w && Av && ATw && reference);
+
+    for (size_t i = 0; i < m * n; i++) {
+        A[i] = randomValue();
+    }
+
+    for (size_t j = 0; j < n; j++) {
+        v[j] = randomValue();
+    }
+
+    for (size_t i = 0; i < m; i++) {
+        w[i] = randomValue();
+    }
+
+    instance = LinearTransform_fmi3InstantiateCoSimulation("instance", INSTANTIATION_TOKEN, NULL,
+        fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL, NULL, NULL);
+
+    CHECK(instance);
+
+    CHECK(LinearTransform_fmi3EnterConfigurationMode(instance) == fmi3OK);
+    CHECK(LinearTransform_fmi3SetUInt64(instance, &vr_m_, 1, &m_, 1) == fmi3OK);
+    CHECK(LinearTransform_fmi3SetUInt64(instance, &vr_n_, 1, &n_, 1) == fmi3OK);
+    CHECK(LinearTransform_fmi3ExitConfigurationMode(instance) == fmi3OK);
+    CHECK(LinearTransform_fmi3SetFloat64(instance, &vr_A_, 1, A, m * n) == fmi3OK);
+    CHECK(LinearTransform_fmi3EnterInitializationMode(instance, fmi3False, 0, 0, fmi3False, 0) == fmi3OK);
+    CHECK(LinearTransform_fmi3ExitInitializationMode(instance) == fmi3OK);
+
+    // A * v
+    CHECK(LinearTransform_fmi3GetDirectionalDerivative(instance, &vr_y_, 1, &vr_u_, 1, v, n, Av, m) == fmi3OK);
+
+    for (size_t i = 0; i < m; i++) {
+        reference[i] = 0;
+        for (size_t j = 0; j < n; j++) {
+            reference[i] += A[i * n + j] * v[j];
+        }
+    }
+
+    CHECK(maxDifference(m, Av, reference) < 1e-12);
+
+    // A^T * w
+    CHECK(LinearTransform_fmi3GetAdjointDerivative(instance, &vr_y_, 1, &vr_u_, 1, w, m, ATw, n) == fmi3OK);
+
+    for (size_t j = 0; j < n; j++) {
+        reference[j] = 0;
+        for (size_t i = 0; i < m; i++) {
+            reference[j] += A[i * n + j] * w[i];
+        }
+    }
+
+    CHECK(maxDifference(n, ATw, reference) < 1e-12);
+
+    // the sizes of the seed and the sensitivity must match the dimensions
+    CHECK(LinearTransform_fmi3GetDirectionalDerivative(instance, &vr_y_, 1, &vr_u_, 1, v, n + 1, Av, m) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetDirectionalDerivative(instance, &vr_y_, 1, &vr_u_, 1, v, n, Av, m + 1) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetAdjointDerivative(instance, &vr_y_, 1, &vr_u_, 1, w, m + 1, ATw, n) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetAdjointDerivative(instance, &vr_y_, 1, &vr_u_, 1, w, m, ATw, n + 1) == fmi3Error);
+
+    // only the derivatives of y with respect to u are supported
+    CHECK(LinearTransform_fmi3GetDirectionalDerivative(instance, &vr_u_, 1, &vr_y_, 1, w, m, ATw, n) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetDirectionalDerivative(instance, &vr_y_, 1, &vr_A_, 1, v, n, Av, m) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetDirectionalDerivative(instance, unknowns, 2, &vr_u_, 1, v, n, Av, m) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetAdjointDerivative(instance, &vr_y_, 1, &vr_A_, 1, w, m, ATw, n) == fmi3Error);
+    CHECK(LinearTransform_fmi3GetAdjointDerivative(instance, &vr_y_, 1, NULL, 0, w, m, ATw, n) == fmi3Error);
+
+TERMINATE:
+
+    if (instance) {
+        LinearTransform_fmi3FreeInstance(instance);
+    }
+
+    free(A);
+    free(v);
+    free(w);
+    free(Av);
+    free(ATw);
+    free(reference);
+
+    if (status != EXIT_SUCCESS) {
+        printf("m = %zu, n = %zu\n", m, n);
+    }
+
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+
+    // remainders of the rows and lanes and a matrix with more columns than a block
+    const size_t sizes[][2] = { { 1, 1 }, { 7, 13 }, { 13, 7 }, { 5, 2051 } };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (checkDerivatives(sizes[s][0], sizes[s][1]) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
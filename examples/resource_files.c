@@ -0,0 +1,102 @@
+/* This example checks that the instances of the Resource model in a process share one mapping of the
+   resource file and that the file is unmapped when the last instance that uses it is freed */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define mkdir(path) mkdir(path, 0777)
+#endif
+
+#define FMI3_FUNCTION_PREFIX Resource_
+#include "fmi3Functions.h"
+#undef FMI3_FUNCTION_PREFIX
+
+#include "config.h"
+#include "model.h"
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        printf("Check failed: %s (line %d)\n", #condition, __LINE__); \
+        status = EXIT_FAILURE; \
+        goto TERMINATE; \
+    }
+
+#define RESOURCE_PATH "shared_resources/"
+#define RESOURCE_FILE RESOURCE_PATH "y.txt"
+
+
+static fmi3Instance instantiate(const char* instanceName) {
+    return Resource_fmi3InstantiateCoSimulation(instanceName, INSTANTIATION_TOKEN, RESOURCE_PATH,
+        fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL, NULL, NULL);
+}
+
+// contents of the resource file as seen by an instance
+static const ResourceFile* resourceFile(fmi3Instance instance) {
+    return ((ModelInstance*)instance)->resources[resource_y_txt];
+}
+
+static int writeResourceFile(const char* contents) {
+
+    FILE* file = fopen(RESOURCE_FILE, "w");
+
+    if (!file) {
+        return EXIT_FAILURE;
+    }
+
+    const int status = fputs(contents, file) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    return fclose(file) ? EXIT_FAILURE : status;
+}
+
+int main(int argc, char* argv[]) {
+
+    int status = EXIT_SUCCESS;
+
+    fmi3Instance instances[4] = { NULL };
+
+    mkdir(RESOURCE_PATH);
+
+    CHECK(writeResourceFile("a") == EXIT_SUCCESS);
+
+    // the instances share the mapping of the file
+    CHECK(instances[0] = instantiate("instance0"));
+    CHECK(instances[1] = instantiate("instance1"));
+    CHECK(resourceFile(instances[0]) == resourceFile(instances[1]));
+    CHECK(resourceFile(instances[0])->size == 1 && resourceFile(instances[0])->data[0] == 'a');
+
+    // the mapping is kept as long as it is used by an instance
+    Resource_fmi3FreeInstance(instances[0]);
+    instances[0] = NULL;
+
+    CHECK(instances[2] = instantiate("instance2"));
+    CHECK(resourceFile(instances[1]) == resourceFile(instances[2]));
+    CHECK(resourceFile(instances[2])->data[0] == 'a');
+
+    // the file is unmapped when the last instance is freed (so it can be replaced)
+    Resource_fmi3FreeInstance(instances[1]);
+    instances[1] = NULL;
+    Resource_fmi3FreeInstance(instances[2]);
+    instances[2] = NULL;
+
+    CHECK(remove(RESOURCE_FILE) == 0);
+    CHECK(writeResourceFile("b") == EXIT_SUCCESS);
+
+    // a new instance maps the new file
+    CHECK(instances[3] = instantiate("instance3"));
+    CHECK(resourceFile(instances[3])->size == 1 && resourceFile(instances[3])->data[0] == 'b');
+
+TERMINATE:
+
+    for (size_t i = 0; i < sizeof(instances) / sizeof(instances[0]); i++) {
+        if (instances[i]) {
+            Resource_fmi3FreeInstance(instances[i]);
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,308 @@
+/* This example measures the activation latency and jitter of the model partitions of the Clocks model that run on
+   the threads of the fmusim scheduler. The input clocks are activated in real time at the given rates and the
+   percentiles are printed for every partition. */
+
+#include <pthread.h>
+#include <time.h>
+
+#include "util.h"
+#include "FMIScheduler.h"
+
+#define N_PARTITIONS 3
+
+
+typedef struct {
+
+    const char* name;
+    fmi3ValueReference clock;
+    int priority;
+    double rate;
+
+    size_t nActivations;
+    size_t nSamples;
+
+    // time from the activation time to the call of fmi3ActivateModelPartition [us]
+    double* jitter;
+
+    // time from the call of fmi3ActivateModelPartition until it returns [us]
+    double* latency;
+
+} Partition;
+
+static Partition partitions[N_PARTITIONS] = {
+    { "inClock1", vr_inClock1, 0, 1000 },
+    { "inClock2", vr_inClock2, 1,  100 },
+    { "inClock3", vr_inClock3, 2,  0.1 }
+};
+
+// wall clock time at activation time 0
+static struct timespec startTime_;
+
+static volatile bool stopLoad = false;
+
+static double elapsed(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)(now.tv_sec - startTime_.tv_sec) + 1e-9 * (double)(now.tv_nsec - startTime_.tv_nsec);
+}
+
+static void sleepUntil(double time) {
+
+    struct timespec deadline = startTime_;
+
+    const double seconds = floor(time);
+
+    deadline.tv_sec += (time_t)seconds;
+    deadline.tv_nsec += (long)((time - seconds) * 1e9);
+
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) != 0);
+}
+
+static FMIStatus activatePartition(void* context, size_t index, double activationTime) {
+
+    Partition* partition = &partitions[index];
+
+    const double released = elapsed();
+
+    const FMIStatus activateStatus = FMI3ActivateModelPartition(S, partition->clock, activationTime);
+
+    const double finished = elapsed();
+
+    if (partition->nSamples < partition->nActivations) {
+        partition->jitter[partition->nSamples] = (released - activationTime) * 1e6;
+        partition->latency[partition->nSamples] = (finished - released) * 1e6;
+        partition->nSamples++;
+    }
+
+    return activateStatus;
+}
+
+// the Clocks model sets the countdown interval of inClock3 only at t = 4 so inClock3 is activated at its own rate instead
+static void clockUpdate(fmi3InstanceEnvironment instanceEnvironment) {
+}
+
+// keep a CPU busy to measure the jitter under load
+static void* load(void* arg) {
+
+    volatile double x = 0;
+
+    while (!stopLoad) {
+        x += 1;
+    }
+
+    return NULL;
+}
+
+static int compare(const void* a, const void* b) {
+
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* samples, size_t nSamples, double p) {
+
+    if (nSamples == 0) {
+        return 0;
+    }
+
+    const size_t i = (size_t)(p * nSamples);
+
+    return samples[i < nSamples ? i : nSamples - 1];
+}
+
+static void printUsage() {
+    printf(
+        "Usage: scs_benchmark [OPTION]...\n"
+        "Activate the model partitions of the Clocks model in real time and print the latency percentiles.\n"
+        "\n"
+        "  --help                 display this help and exit\n"
+        "  --rate1 [HZ]           activation rate of inClock1 (default: 1000)\n"
+        "  --rate2 [HZ]           activation rate of inClock2 (default: 100)\n"
+        "  --rate3 [HZ]           activation rate of the countdown clock inClock3 (default: 0.1)\n"
+        "  --duration [SECONDS]   duration of the benchmark (default: 10)\n"
+        "  --load [N]             number of threads that keep a CPU busy (default: 0)\n"
+        "  --max-p99 [US]         fail if the p99 jitter or latency of a partition exceeds US microseconds\n"
+    );
+}
+
+int main(int argc, char* argv[]) {
+
+    double duration = 10;
+    size_t nLoadThreads = 0;
+    double maxP99 = 0;
+
+    FMIScheduler* scheduler = NULL;
+    pthread_t* loadThreads = NULL;
+    size_t nLoadThreadsCreated = 0;
+    size_t next[N_PARTITIONS] = { 0 };
+    bool failed = false;
+
+    for (int i = 1; i < argc; i++) {
+
+        const char* v = argv[i];
+
+        if (!strcmp(v, "--help")) {
+            printUsage();
+            return EXIT_SUCCESS;
+        } else if (!strcmp(v, "--rate1") && i < argc - 1) {
+            partitions[0].rate = atof(argv[++i]);
+        } else if (!strcmp(v, "--rate2") && i < argc - 1) {
+            partitions[1].rate = atof(argv[++i]);
+        } else if (!strcmp(v, "--rate3") && i < argc - 1) {
+            partitions[2].rate = atof(argv[++i]);
+        } else if (!strcmp(v, "--duration") && i < argc - 1) {
+            duration = atof(argv[++i]);
+        } else if (!strcmp(v, "--load") && i < argc - 1) {
+            nLoadThreads = (size_t)atoi(argv[++i]);
+        } else if (!strcmp(v, "--max-p99") && i < argc - 1) {
+            maxP99 = atof(argv[++i]);
+        } else {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    int priorities[N_PARTITIONS];
+
+    for (size_t i = 0; i < N_PARTITIONS; i++) {
+
+        Partition* partition = &partitions[i];
+
+        partition->nActivations = partition->rate > 0 ? (size_t)floor(partition->rate * duration) + 1 : 0;
+        partition->jitter = (double*)calloc(partition->nActivations, sizeof(double));
+        partition->latency = (double*)calloc(partition->nActivations, sizeof(double));
+
+        if (partition->nActivations > 0 && (!partition->jitter || !partition->latency)) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        priorities[i] = partition->priority;
+    }
+
+    CALL(setUp());
+
+    // don't measure the logging
+    S->logFunctionCall = NULL;
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        INSTANTIATION_TOKEN,   // instantiationToken
+        NULL,                  // resourcePath
+        fmi3False,             // visible
+        fmi3False,             // loggingOn
+        NULL,                  // requiredIntermediateVariables
+        0,                     // nRequiredIntermediateVariables
+        clockUpdate,           // clockUpdate
+        FMILockPreemption,     // lockPreemption
+        FMIUnlockPreemption    // unlockPreemption
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3True, duration));
+    CALL(FMI3ExitInitializationMode(S));
+
+    scheduler = FMICreateScheduler(N_PARTITIONS, priorities, activatePartition, NULL, true);
+
+    if (!scheduler) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    loadThreads = (pthread_t*)calloc(nLoadThreads, sizeof(pthread_t));
+
+    for (; nLoadThreadsCreated < nLoadThreads; nLoadThreadsCreated++) {
+        if (!loadThreads || pthread_create(&loadThreads[nLoadThreadsCreated], NULL, load, NULL)) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &startTime_);
+
+    for (;;) {
+
+        double time = INFINITY;
+
+        // the next activation time of all clocks
+        for (size_t i = 0; i < N_PARTITIONS; i++) {
+            if (next[i] < partitions[i].nActivations) {
+                time = fmin(time, next[i] / partitions[i].rate);
+            }
+        }
+
+        if (time == INFINITY) {
+            break;
+        }
+
+        sleepUntil(time);
+
+        for (size_t i = 0; i < N_PARTITIONS; i++) {
+            while (next[i] < partitions[i].nActivations && next[i] / partitions[i].rate <= time) {
+                CALL(FMIScheduleActivation(scheduler, i, next[i] / partitions[i].rate));
+                next[i]++;
+            }
+        }
+
+        // don't wait for the partitions so that the ones with a higher priority are not delayed by long activations
+        FMIReleaseActivations(scheduler, time);
+    }
+
+    CALL(FMIRunPartitions(scheduler, duration));
+
+    printf("partition   activations   jitter [us]: p50      p99      p999     max   latency [us]: p50      p99      p999     max\n");
+
+    for (size_t i = 0; i < N_PARTITIONS; i++) {
+
+        Partition* partition = &partitions[i];
+
+        qsort(partition->jitter, partition->nSamples, sizeof(double), compare);
+        qsort(partition->latency, partition->nSamples, sizeof(double), compare);
+
+        const double* j = partition->jitter;
+        const double* l = partition->latency;
+        const size_t n = partition->nSamples;
+
+        printf("%-11s %11zu %17.1f %8.1f %8.1f %8.1f %19.1f %8.1f %8.1f %8.1f\n", partition->name, n,
+            percentile(j, n, 0.5), percentile(j, n, 0.99), percentile(j, n, 0.999), n > 0 ? j[n - 1] : 0,
+            percentile(l, n, 0.5), percentile(l, n, 0.99), percentile(l, n, 0.999), n > 0 ? l[n - 1] : 0);
+
+        if (maxP99 > 0 && (percentile(j, n, 0.99) > maxP99 || percentile(l, n, 0.99) > maxP99)) {
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        printf("The p99 jitter or latency exceeds %g us.\n", maxP99);
+    }
+
+TERMINATE:
+
+    stopLoad = true;
+
+    for (size_t i = 0; i < nLoadThreadsCreated; i++) {
+        pthread_join(loadThreads[i], NULL);
+    }
+
+    free(loadThreads);
+
+    // stop the partition threads before the instance is freed
+    FMIFreeScheduler(scheduler);
+
+    for (size_t i = 0; i < N_PARTITIONS; i++) {
+        free(partitions[i].jitter);
+        free(partitions[i].latency);
+    }
+
+    status = tearDown();
+
+    return status == FMIOK && !failed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
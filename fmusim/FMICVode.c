@@ -24,7 +24,7 @@ typedef struct SolverImpl Solver;
 struct SolverImpl {
     FMIInstance* S;
     const FMIModelDescription* modelDescription;
-    const FMUStaticInput* input;
+    FMUStaticInput* input;
     size_t nx;
     size_t nz;
     FMIValueReference* xvr;
@@ -141,7 +141,7 @@ static int Jac(realtype t, N_Vector y, N_Vector fy, SUNMatrix J, void* user_data
     return 0;
 }
 
-Solver* FMICVodeCreate(FMIInstance* S, const FMIModelDescription* modelDescription, const FMUStaticInput* input, double tolerance, double startTime) {
+Solver* FMICVodeCreate(FMIInstance* S, const FMIModelDescription* modelDescription, FMUStaticInput* input, double tolerance, double startTime) {
 
     int flag = CV_SUCCESS;
     FMIStatus status = FMIOK;
@@ -0,0 +1,293 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "FMIUtil.h"
+
+#include "FMICheckpoint.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIOK) goto TERMINATE; } while (0)
+
+// checkpoint file: header, the applied discrete inputs and the serialized FMU state
+#define CHECKPOINT_MAGIC   "FMICHKPT"
+#define CHECKPOINT_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t nInputVariables;
+    double time;
+    uint64_t nSteps;
+    double nextEventTime;
+    uint64_t nCheckpoints;
+    double nextCheckpointTime;
+    uint64_t recorderPosition;
+    uint64_t fmuStateSize;
+} FMICheckpointHeader;
+
+typedef struct {
+    FMICheckpointHeader header;
+    bool* applied;
+    uint64_t* appliedValues;
+    char* fmuState;
+} FMICheckpointData;
+
+static char* checkpointFilename(const char* checkpointFile, uint64_t index, const char* suffix) {
+
+    const size_t length = strlen(checkpointFile) + strlen(suffix) + 32;
+
+    char* filename = (char*)malloc(length);
+
+    if (filename) {
+        snprintf(filename, length, "%s.%d%s", checkpointFile, (int)(index % 2), suffix);
+    }
+
+    return filename;
+}
+
+static void freeCheckpointData(FMICheckpointData* data) {
+    free(data->applied);
+    free(data->appliedValues);
+    free(data->fmuState);
+    memset(data, 0, sizeof(FMICheckpointData));
+}
+
+static bool readCheckpoint(const char* filename, size_t nInputVariables, FMICheckpointData* data) {
+
+    bool valid = false;
+
+    FILE* file = fopen(filename, "rb");
+
+    if (!file) {
+        return false;
+    }
+
+    FMICheckpointHeader* header = &data->header;
+
+    if (fread(header, sizeof(FMICheckpointHeader), 1, file) != 1 ||
+        memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) ||
+        header->version != CHECKPOINT_VERSION ||
+        header->nInputVariables != nInputVariables) {
+        goto TERMINATE;
+    }
+
+    data->applied       = (bool*)calloc(nInputVariables + 1, sizeof(bool));
+    data->appliedValues = (uint64_t*)calloc(nInputVariables + 1, sizeof(uint64_t));
+    data->fmuState      = (char*)malloc(header->fmuStateSize + 1);
+
+    if (!data->applied || !data->appliedValues || !data->fmuState) {
+        goto TERMINATE;
+    }
+
+    if (fread(data->applied, sizeof(bool), nInputVariables, file) != nInputVariables ||
+        fread(data->appliedValues, sizeof(uint64_t), nInputVariables, file) != nInputVariables ||
+        fread(data->fmuState, sizeof(char), header->fmuStateSize, file) != header->fmuStateSize) {
+        goto TERMINATE;
+    }
+
+    // a partially written file must have been caught by the atomic rename
+    valid = fgetc(file) == EOF;
+
+TERMINATE:
+
+    fclose(file);
+
+    if (!valid) {
+        freeCheckpointData(data);
+    }
+
+    return valid;
+}
+
+static FMIStatus replaceFile(const char* source, const char* destination) {
+#ifdef _WIN32
+    return MoveFileExA(source, destination, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ? FMIOK : FMIError;
+#else
+    return rename(source, destination) ? FMIError : FMIOK;
+#endif
+}
+
+bool FMICheckpointDue(const FMISimulationSettings* settings, const FMICheckpoint* checkpoint, double time) {
+    return settings->checkpointInterval > 0 && time >= checkpoint->nextCheckpointTime;
+}
+
+FMIStatus FMISaveCheckpoint(
+    FMIInstance* S,
+    const FMISimulationSettings* settings,
+    FMICheckpoint* checkpoint,
+    double time,
+    uint64_t nSteps,
+    double nextEventTime,
+    FMIRecorder* recorder,
+    const FMUStaticInput* input) {
+
+    FMIStatus status = FMIOK;
+
+    char* fmuState = NULL;
+    size_t fmuStateSize = 0;
+    char* filename = NULL;
+    char* temporaryFilename = NULL;
+    FILE* file = NULL;
+
+    const size_t nInputVariables = input ? input->nVariables : 0;
+
+    CALL(FMIGetSerializedFMUState(S, &fmuState, &fmuStateSize));
+
+    checkpoint->time          = time;
+    checkpoint->nSteps        = nSteps;
+    checkpoint->nextEventTime = nextEventTime;
+    checkpoint->nCheckpoints++;
+
+    while (checkpoint->nextCheckpointTime <= time) {
+        checkpoint->nextCheckpointTime += settings->checkpointInterval;
+    }
+
+    FMICheckpointHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+
+    header.version            = CHECKPOINT_VERSION;
+    header.nInputVariables    = (uint32_t)nInputVariables;
+    header.time               = checkpoint->time;
+    header.nSteps             = checkpoint->nSteps;
+    header.nextEventTime      = checkpoint->nextEventTime;
+    header.nCheckpoints       = checkpoint->nCheckpoints;
+    header.nextCheckpointTime = checkpoint->nextCheckpointTime;
+    header.fmuStateSize       = fmuStateSize;
+
+    if (recorder) {
+        CALL(FMIGetRecorderPosition(recorder, &header.recorderPosition));
+    }
+
+    filename          = checkpointFilename(settings->checkpointFile, checkpoint->nCheckpoints, "");
+    temporaryFilename = checkpointFilename(settings->checkpointFile, checkpoint->nCheckpoints, ".tmp");
+
+    if (!filename || !temporaryFilename) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    file = fopen(temporaryFilename, "wb");
+
+    if (!file) {
+        printf("Failed to open checkpoint file %s for writing.\n", temporaryFilename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // the inputs have been applied before the simulation loop so the arrays have been allocated
+    const bool written =
+        fwrite(&header, sizeof(header), 1, file) == 1 &&
+        (nInputVariables == 0 || (
+        fwrite(input->applied, sizeof(bool), nInputVariables, file) == nInputVariables &&
+        fwrite(input->appliedValues, sizeof(uint64_t), nInputVariables, file) == nInputVariables)) &&
+        fwrite(fmuState, sizeof(char), fmuStateSize, file) == fmuStateSize &&
+        fflush(file) == 0;
+
+    if (!written) {
+        printf("Failed to write checkpoint file %s.\n", temporaryFilename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // make sure the data is on disk before the previous checkpoint is replaced
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+
+    const int closed = fclose(file);
+
+    file = NULL;
+
+    if (closed || replaceFile(temporaryFilename, filename) > FMIOK) {
+        printf("Failed to save checkpoint file %s.\n", filename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+TERMINATE:
+
+    if (file) {
+        fclose(file);
+    }
+
+    free(fmuState);
+    free(filename);
+    free(temporaryFilename);
+
+    return status;
+}
+
+FMIStatus FMIRestoreCheckpoint(
+    FMIInstance* S,
+    const FMISimulationSettings* settings,
+    FMICheckpoint* checkpoint,
+    FMIRecorder* recorder,
+    FMUStaticInput* input) {
+
+    FMIStatus status = FMIOK;
+
+    FMICheckpointData candidates[2];
+    bool valid[2] = { false, false };
+
+    memset(candidates, 0, sizeof(candidates));
+
+    const size_t nInputVariables = input ? input->nVariables : 0;
+
+    for (uint64_t i = 0; i < 2; i++) {
+
+        char* filename = checkpointFilename(settings->checkpointFile, i, "");
+
+        if (!filename) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        valid[i] = readCheckpoint(filename, nInputVariables, &candidates[i]);
+
+        free(filename);
+    }
+
+    if (!valid[0] && !valid[1]) {
+        printf("No valid checkpoint %s.0 or %s.1 found.\n", settings->checkpointFile, settings->checkpointFile);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // use the most recent checkpoint
+    const FMICheckpointData* data = &candidates[!valid[0] || (valid[1] && candidates[1].header.nCheckpoints > candidates[0].header.nCheckpoints)];
+
+    CALL(FMISetSerializedFMUState(S, data->fmuState, data->header.fmuStateSize));
+
+    if (recorder) {
+        CALL(FMISetRecorderPosition(recorder, S, data->header.recorderPosition));
+    }
+
+    if (input) {
+        CALL(FMIRestoreAppliedInput(input, data->applied, data->appliedValues));
+    }
+
+    checkpoint->time               = data->header.time;
+    checkpoint->nSteps             = data->header.nSteps;
+    checkpoint->nextEventTime      = data->header.nextEventTime;
+    checkpoint->nCheckpoints       = data->header.nCheckpoints;
+    checkpoint->nextCheckpointTime = data->header.nextCheckpointTime;
+
+TERMINATE:
+
+    freeCheckpointData(&candidates[0]);
+    freeCheckpointData(&candidates[1]);
+
+    return status;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "FMIRecorder.h"
+#include "fmusim.h"
+#include "fmusim_input.h"
+
+
+// state of the simulation loop that is saved with a checkpoint
+typedef struct {
+
+    double time;
+    uint64_t nSteps;
+    double nextEventTime;
+
+    // number of checkpoints that have been saved (selects the file to write next)
+    uint64_t nCheckpoints;
+    double nextCheckpointTime;
+
+} FMICheckpoint;
+
+bool FMICheckpointDue(const FMISimulationSettings* settings, const FMICheckpoint* checkpoint, double time);
+
+// save the FMU state, the loop state and the positions of the recorder and the input to
+// <checkpointFile>.0 or <checkpointFile>.1 (alternating) and schedule the next checkpoint
+FMIStatus FMISaveCheckpoint(
+    FMIInstance* S,
+    const FMISimulationSettings* settings,
+    FMICheckpoint* checkpoint,
+    double time,
+    uint64_t nSteps,
+    double nextEventTime,
+    FMIRecorder* recorder,
+    const FMUStaticInput* input);
+
+// restore the most recent valid checkpoint
+FMIStatus FMIRestoreCheckpoint(
+    FMIInstance* S,
+    const FMISimulationSettings* settings,
+    FMICheckpoint* checkpoint,
+    FMIRecorder* recorder,
+    FMUStaticInput* input);
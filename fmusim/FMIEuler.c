@@ -25,7 +25,7 @@ struct SolverImpl {
     FMIStatus(*get_z)(FMIInstance* instance, double z[], size_t nz);
 } SolverImpl_;
 
-Solver* FMIEulerCreate(FMIInstance* S, const FMIModelDescription* modelDescription, const FMUStaticInput* input, double tolerance, double startTime) {
+Solver* FMIEulerCreate(FMIInstance* S, const FMIModelDescription* modelDescription, FMUStaticInput* input, double tolerance, double startTime) {
 
     (void)tolerance; // unused
 
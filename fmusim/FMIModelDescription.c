@@ -1,5 +1,6 @@
 #include "FMIModelDescription.h"
 
+#include <ctype.h>
 #include <string.h>
 #include <stdint.h>
 
@@ -149,6 +150,65 @@ static FMIModelDescription* readModelDescriptionFMI1(xmlNodePtr root) {
     return modelDescription;
 }
 
+static void readDependencies(xmlNodePtr unknownNode, FMIModelDescription* modelDescription, FMIUnknown* unknown) {
+
+    char* literal = (char*)xmlGetProp(unknownNode, (xmlChar*)"dependencies");
+
+    if (!literal) {
+        return;
+    }
+
+    unknown->hasDependencies = true;
+
+    size_t nDependencies = 0;
+
+    for (const char* c = literal; *c; c++) {
+        if (!isspace(*c) && (c == literal || isspace(c[-1]))) {
+            nDependencies++;
+        }
+    }
+
+    unknown->dependencies = calloc(nDependencies, sizeof(FMIModelVariable*));
+
+    char* next = literal;
+
+    for (size_t i = 0; i < nDependencies; i++) {
+
+        const unsigned long value = strtoul(next, &next, 10);
+
+        // FMI 2.0 uses the (1-based) index of the model variable, FMI 3.0 the value reference
+        FMIModelVariable* variable = NULL;
+
+        if (modelDescription->fmiVersion == FMIVersion2) {
+            if (value > 0 && value <= modelDescription->nModelVariables) {
+                variable = &modelDescription->modelVariables[value - 1];
+            }
+        } else {
+            variable = FMIModelVariableForValueReference(modelDescription, (FMIValueReference)value);
+        }
+
+        if (variable) {
+            unknown->dependencies[unknown->nDependencies++] = variable;
+        }
+    }
+
+    free(literal);
+}
+
+static void freeUnknowns(size_t nUnknowns, FMIUnknown* unknowns) {
+
+    // FMI 1.0 and 2.0 only declare the number of some unknowns
+    if (!unknowns) {
+        return;
+    }
+
+    for (size_t i = 0; i < nUnknowns; i++) {
+        free(unknowns[i].dependencies);
+    }
+
+    free(unknowns);
+}
+
 static void readUnknownsFMI2(xmlXPathContextPtr xpathCtx, FMIModelDescription* modelDescription, const char* path, size_t* nUnkonwns, FMIUnknown** unknowns) {
 
     xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression((xmlChar*)path, xpathCtx);
@@ -165,6 +225,8 @@ static void readUnknownsFMI2(xmlXPathContextPtr xpathCtx, FMIModelDescription* m
         (*unknowns)[i].modelVariable = FMIModelVariableForIndexLiteral(modelDescription, indexLiteral);
 
         free(indexLiteral);
+
+        readDependencies(unkownNode, modelDescription, &(*unknowns)[i]);
     }
 
     xmlXPathFreeObject(xpathObj);
@@ -190,6 +252,8 @@ static void readUnknownsFMI3(xmlXPathContextPtr xpathCtx, FMIModelDescription* m
                 break;
             }
         }
+
+        readDependencies(unknownNode, modelDescription, &(*unknowns)[i]);
     }
 
     xmlXPathFreeObject(xpathObj);
@@ -366,6 +430,13 @@ static FMIModelDescription* readModelDescriptionFMI3(xmlNodePtr root) {
     }
     xmlXPathFreeObject(xpathObj);
 
+    xpathObj = xmlXPathEvalExpression((xmlChar*)"/fmiModelDescription/ScheduledExecution", xpathCtx);
+    if (xpathObj->nodesetval->nodeNr == 1) {
+        modelDescription->scheduledExecution = (FMIScheduledExecutionInterface*)calloc(1, sizeof(FMIScheduledExecutionInterface));
+        modelDescription->scheduledExecution->modelIdentifier = (char*)xmlGetProp(xpathObj->nodesetval->nodeTab[0], (xmlChar*)"modelIdentifier");
+    }
+    xmlXPathFreeObject(xpathObj);
+
     xpathObj = xmlXPathEvalExpression((xmlChar*)"/fmiModelDescription/ModelExchange", xpathCtx);
     if (xpathObj->nodesetval->nodeNr == 1) {
         xmlNodePtr node = xpathObj->nodesetval->nodeTab[0];
@@ -485,6 +556,41 @@ static FMIModelDescription* readModelDescriptionFMI3(xmlNodePtr root) {
 
         variable->derivative = (FMIModelVariable*)xmlGetProp(node, (xmlChar*)"derivative");
 
+        if (type == FMIClockType) {
+
+            const char* intervalVariability = (char*)xmlGetProp(node, (xmlChar*)"intervalVariability");
+
+            if (!intervalVariability || !strcmp(intervalVariability, "constant")) {
+                variable->intervalVariability = FMIConstantInterval;
+            } else if (!strcmp(intervalVariability, "fixed")) {
+                variable->intervalVariability = FMIFixedInterval;
+            } else if (!strcmp(intervalVariability, "calculated")) {
+                variable->intervalVariability = FMICalculatedInterval;
+            } else if (!strcmp(intervalVariability, "tunable")) {
+                variable->intervalVariability = FMITunableInterval;
+            } else if (!strcmp(intervalVariability, "changing")) {
+                variable->intervalVariability = FMIChangingInterval;
+            } else if (!strcmp(intervalVariability, "countdown")) {
+                variable->intervalVariability = FMICountdownInterval;
+            } else {
+                variable->intervalVariability = FMITriggeredInterval;
+            }
+
+            free((void*)intervalVariability);
+
+            const char* literal = (char*)xmlGetProp(node, (xmlChar*)"intervalDecimal");
+            variable->intervalDecimal = literal ? strtod(literal, NULL) : 0;
+            free((void*)literal);
+
+            literal = (char*)xmlGetProp(node, (xmlChar*)"shiftDecimal");
+            variable->shiftDecimal = literal ? strtod(literal, NULL) : 0;
+            free((void*)literal);
+
+            literal = (char*)xmlGetProp(node, (xmlChar*)"priority");
+            variable->priority = literal ? (int)strtol(literal, NULL, 10) : 0;
+            free((void*)literal);
+        }
+
         xmlXPathObjectPtr xpathObj2 = xmlXPathNodeEval(node, ".//Dimension", xpathCtx);
 
         for (size_t j = 0; j < xpathObj2->nodesetval->nodeNr; j++) {
@@ -678,6 +784,11 @@ void FMIFreeModelDescription(FMIModelDescription* modelDescription) {
         free(modelDescription->coSimulation);
     }
 
+    if (modelDescription->scheduledExecution) {
+        free((void*)modelDescription->scheduledExecution->modelIdentifier);
+        free(modelDescription->scheduledExecution);
+    }
+
     if (modelDescription->defaultExperiment) {
         free((void*)modelDescription->defaultExperiment->startTime);
         free((void*)modelDescription->defaultExperiment->stopTime);
@@ -692,6 +803,11 @@ void FMIFreeModelDescription(FMIModelDescription* modelDescription) {
     }
     free(modelDescription->modelVariables);
 
+    freeUnknowns(modelDescription->nOutputs, modelDescription->outputs);
+    freeUnknowns(modelDescription->nContinuousStates, modelDescription->derivatives);
+    freeUnknowns(modelDescription->nInitialUnknowns, modelDescription->initialUnknowns);
+    freeUnknowns(modelDescription->nEventIndicators, modelDescription->eventIndicators);
+
     free(modelDescription);
 }
 
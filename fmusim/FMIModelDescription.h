@@ -18,6 +18,18 @@ typedef enum {
 
 } FMICausality;
 
+typedef enum {
+
+    FMIConstantInterval,
+    FMIFixedInterval,
+    FMICalculatedInterval,
+    FMITunableInterval,
+    FMIChangingInterval,
+    FMICountdownInterval,
+    FMITriggeredInterval
+
+} FMIIntervalVariability;
+
 typedef struct FMIDimension FMIDimension;
 
 typedef struct FMIModelVariable FMIModelVariable;
@@ -33,6 +45,12 @@ struct FMIModelVariable {
     FMIDimension* dimensions;
     FMIModelVariable* derivative;
 
+    // Clock attributes (FMI 3.0)
+    FMIIntervalVariability intervalVariability;
+    double intervalDecimal;
+    double shiftDecimal;
+    int priority;
+
 };
 
 struct FMIDimension{
@@ -55,6 +73,12 @@ typedef struct {
 
 } FMICoSimulationInterface;
 
+typedef struct {
+
+    const char* modelIdentifier;
+
+} FMIScheduledExecutionInterface;
+
 typedef struct {
 
     const char* startTime;
@@ -67,6 +91,11 @@ typedef struct {
 
     FMIModelVariable* modelVariable;
 
+    // variables the unknown depends on (if the attribute is missing the unknown depends on all knowns)
+    bool hasDependencies;
+    size_t nDependencies;
+    FMIModelVariable** dependencies;
+
 } FMIUnknown;
 
 typedef struct {
@@ -80,6 +109,7 @@ typedef struct {
 
     FMIModelExchangeInterface* modelExchange;
     FMICoSimulationInterface* coSimulation;
+    FMIScheduledExecutionInterface* scheduledExecution;
 
     FMIDefaultExperiment* defaultExperiment;
 
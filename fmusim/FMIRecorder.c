@@ -1,6 +1,17 @@
+#ifndef _WIN32
+// 64-bit file positions for ftello() and fseeko()
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #include <inttypes.h>
 #include <stdlib.h>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "FMI1.h"
 #include "FMI2.h"
 #include "FMI3.h"
@@ -12,7 +23,7 @@
 #define CALL(f) do { status = f; if (status > FMIOK) goto TERMINATE; } while (0)
 
 
-FMIRecorder* FMICreateRecorder(size_t nVariables, const FMIModelVariable* variables[], const char* file) {
+FMIRecorder* FMICreateRecorder(size_t nVariables, const FMIModelVariable* variables[], const char* file, bool resume) {
 
     FMIRecorder* result = calloc(1, sizeof(FMIRecorder));
 
@@ -22,7 +33,7 @@ FMIRecorder* FMICreateRecorder(size_t nVariables, const FMIModelVariable* variab
 
     result->nVariables = nVariables;
     result->variables = variables;
-    result->file = fopen(file, "w");
+    result->file = fopen(file, resume ? "r+" : "w");
 
     if (!result->file) {
         free(result);
@@ -47,45 +58,138 @@ void FMIFreeRecorder(FMIRecorder* result) {
     }
 }
 
-FMIStatus FMISample(FMIInstance* instance, double time, FMIRecorder* result) {
+FMIStatus FMIGetRecorderPosition(FMIRecorder* result, uint64_t* position) {
+
+    if (fflush(result->file)) {
+        return FMIError;
+    }
+
+#ifdef _WIN32
+    const __int64 offset = _ftelli64(result->file);
+#else
+    const off_t offset = ftello(result->file);
+#endif
+
+    if (offset < 0) {
+        return FMIError;
+    }
+
+    *position = offset;
+
+    return FMIOK;
+}
+
+FMIStatus FMISetRecorderPosition(FMIRecorder* result, FMIInstance* instance, uint64_t position) {
+
+    if (fflush(result->file)) {
+        return FMIError;
+    }
+
+#ifdef _WIN32
+    if (_chsize_s(_fileno(result->file), position)) {
+#else
+    if (ftruncate(fileno(result->file), position)) {
+#endif
+        printf("Failed to truncate the result file.\n");
+        return FMIError;
+    }
+
+#ifdef _WIN32
+    if (_fseeki64(result->file, (__int64)position, SEEK_SET)) {
+#else
+    if (fseeko(result->file, (off_t)position, SEEK_SET)) {
+#endif
+        return FMIError;
+    }
+
+    // the header has already been written
+    if (position > 0) {
+        result->instance = instance;
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus writeHeader(FMIInstance* instance, FMIRecorder* result) {
 
     FMIStatus status = FMIOK;
 
-    if (!result) {
-        goto TERMINATE;
+    if (result->ensemble) {
+        fprintf(result->file, "\"member\",");
     }
 
-    FILE* file = result->file;
+    fprintf(result->file, "\"time\"");
+
+    for (size_t i = 0; i < result->nVariables; i++) {
+
+        const FMIModelVariable* variable = result->variables[i];
+
+        const char* name = result->variables[i]->name;
+
+        if (variable->nDimensions == 0) {
+            fprintf(result->file, ",\"%s\"", name);
+        } else {
+            size_t nValues;
+            CALL(FMIGetNumberOfVariableValues(instance, variable, &nValues));
+            for (size_t j = 0; j < nValues; j++) {
+                fprintf(result->file, ",\"%s[%zu]\"", name, j);
+            }
+        }
 
-    if (!file) {
-        goto TERMINATE;
     }
 
+    fputc('\n', result->file);
+
+    result->instance = instance;
+
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMISampleFloat64(FMIInstance* instance, double time, const double values[], FMIRecorder* result) {
+
+    FMIStatus status = FMIOK;
+
     if (!result->instance) {
+        CALL(writeHeader(instance, result));
+    }
 
-        fprintf(result->file, "\"time\"");
+    if (result->ensemble) {
+        fprintf(result->file, "%zu,", result->member);
+    }
 
-        for (size_t i = 0; i < result->nVariables; i++) {
+    fprintf(result->file, "%.16g", time);
 
-            const FMIModelVariable* variable = result->variables[i];
+    for (size_t i = 0; i < result->nVariables; i++) {
+        fprintf(result->file, ",%.16g", values[i]);
+    }
 
-            const char* name = result->variables[i]->name;
+    fputc('\n', result->file);
 
-            if (variable->nDimensions == 0) {
-                fprintf(result->file, ",\"%s\"", name);
-            } else {
-                size_t nValues;
-                CALL(FMIGetNumberOfVariableValues(instance, variable, &nValues));
-                for (size_t j = 0; j < nValues; j++) {
-                    fprintf(result->file, ",\"%s[%zu]\"", name, j);
-                }
-            }
+TERMINATE:
+    return status;
+}
 
-        }
+FMIStatus FMISample(FMIInstance* instance, double time, FMIRecorder* result) {
 
-        fputc('\n', result->file);
+    FMIStatus status = FMIOK;
 
-        result->instance = instance;
+    if (!result) {
+        goto TERMINATE;
+    }
+
+    FILE* file = result->file;
+
+    if (!file) {
+        goto TERMINATE;
+    }
+
+    if (!result->instance) {
+        CALL(writeHeader(instance, result));
+    }
+
+    if (result->ensemble) {
+        fprintf(file, "%zu,", result->member);
     }
 
     fprintf(file, "%.16g", time);
@@ -2,6 +2,7 @@
 
 #include "FMIModelDescription.h"
 #include <stdio.h>
+#include <stdint.h>
 
 
 typedef struct {
@@ -14,10 +15,23 @@ typedef struct {
     char* values;
     size_t* sizes;
 
+    // prefix the rows with the index of the ensemble member that is simulated
+    bool ensemble;
+    size_t member;
+
 } FMIRecorder;
 
-FMIRecorder* FMICreateRecorder(size_t nVariables, const FMIModelVariable* variables[], const char* file);
+// create a recorder (if resume is true the existing file is opened and must be positioned with FMISetRecorderPosition())
+FMIRecorder* FMICreateRecorder(size_t nVariables, const FMIModelVariable* variables[], const char* file, bool resume);
 
 void FMIFreeRecorder(FMIRecorder* result);
 
 FMIStatus FMISample(FMIInstance* instance, double time, FMIRecorder* result);
+
+// record the values of scalar Float64 variables that have already been retrieved
+FMIStatus FMISampleFloat64(FMIInstance* instance, double time, const double values[], FMIRecorder* result);
+
+FMIStatus FMIGetRecorderPosition(FMIRecorder* result, uint64_t* position);
+
+// truncate the file to position and continue recording from there
+FMIStatus FMISetRecorderPosition(FMIRecorder* result, FMIInstance* instance, uint64_t position);
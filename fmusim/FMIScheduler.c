@@ -0,0 +1,649 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "FMIScheduler.h"
+
+
+#ifdef _WIN32
+#define LOCK(s)      EnterCriticalSection(&(s)->mutex)
+#define UNLOCK(s)    LeaveCriticalSection(&(s)->mutex)
+#define WAIT(s, c)   SleepConditionVariableCS(&(c), &(s)->mutex, INFINITE)
+#define NOTIFY(c)    WakeAllConditionVariable(&(c))
+#else
+#define LOCK(s)      pthread_mutex_lock(&(s)->mutex)
+#define UNLOCK(s)    pthread_mutex_unlock(&(s)->mutex)
+#define WAIT(s, c)   pthread_cond_wait(&(c), &(s)->mutex)
+#define NOTIFY(c)    pthread_cond_broadcast(&(c))
+#endif
+
+typedef struct {
+
+    double time;
+    int priority;
+
+    // keeps activations with the same time and priority in the order in which they have been scheduled
+    unsigned long long sequence;
+
+    size_t partition;
+
+    // the activation of a periodic clock that schedules the next one when it is released
+    bool periodic;
+
+} FMIActivation;
+
+typedef struct {
+
+    FMIScheduler* scheduler;
+    size_t index;
+    int priority;
+
+    // the activation that has been released to the partition
+    bool active;
+    double activationTime;
+
+    // periodic activations at firstActivation + n * interval
+    double firstActivation;
+    double interval;
+    unsigned long long nPeriodicActivations;
+
+    bool created;
+
+#ifdef _WIN32
+    HANDLE thread;
+    DWORD threadId;
+    CONDITION_VARIABLE released;
+#else
+    pthread_t thread;
+    pthread_t self;
+    pthread_cond_t released;
+#endif
+
+} FMIPartition;
+
+struct FMIScheduler {
+
+    size_t nPartitions;
+    FMIPartition* partitions;
+
+    FMIPartitionTask* task;
+    void* context;
+    bool concurrent;
+
+#ifdef _WIN32
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE finished;
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+#endif
+
+    // min-heap of the activations that have not been released yet
+    size_t nActivations;
+    size_t activationsSize;
+    FMIActivation* activations;
+    unsigned long long nScheduled;
+
+    // due activations of busy partitions that are set aside while the next one is released
+    FMIActivation* blocked;
+
+    // activations up to time are released
+    size_t nRunning;
+    double time;
+    FMIStatus status;
+    bool quit;
+};
+
+#ifdef _WIN32
+static INIT_ONCE preemptionLockOnce = INIT_ONCE_STATIC_INIT;
+static CRITICAL_SECTION preemptionLock;
+#else
+static pthread_once_t preemptionLockOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t preemptionLock;
+#endif
+
+#ifdef _WIN32
+static BOOL CALLBACK initPreemptionLock(PINIT_ONCE initOnce, PVOID parameter, PVOID* context) {
+    InitializeCriticalSection(&preemptionLock);
+    return TRUE;
+}
+#else
+static void initPreemptionLock(void) {
+
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+
+    // the FMU may call clockUpdate while it holds the lock
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+    // a partition that holds the lock runs with the priority of the partitions that wait for it
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+
+    pthread_mutex_init(&preemptionLock, &attr);
+
+    pthread_mutexattr_destroy(&attr);
+}
+#endif
+
+void FMILockPreemption(void) {
+#ifdef _WIN32
+    InitOnceExecuteOnce(&preemptionLockOnce, initPreemptionLock, NULL, NULL);
+    EnterCriticalSection(&preemptionLock);
+#else
+    pthread_once(&preemptionLockOnce, initPreemptionLock);
+    pthread_mutex_lock(&preemptionLock);
+#endif
+}
+
+void FMIUnlockPreemption(void) {
+#ifdef _WIN32
+    LeaveCriticalSection(&preemptionLock);
+#else
+    pthread_mutex_unlock(&preemptionLock);
+#endif
+}
+
+static bool before(const FMIActivation* a, const FMIActivation* b) {
+
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+
+    if (a->priority != b->priority) {
+        return a->priority < b->priority;
+    }
+
+    return a->sequence < b->sequence;
+}
+
+// make room for one more activation (must be called with the lock held)
+static bool reserveActivation(FMIScheduler* scheduler) {
+
+    if (scheduler->nActivations < scheduler->activationsSize) {
+        return true;
+    }
+
+    const size_t size = scheduler->activationsSize > 0 ? 2 * scheduler->activationsSize : 16;
+
+    FMIActivation* activations = (FMIActivation*)realloc(scheduler->activations, size * sizeof(FMIActivation));
+
+    if (!activations) {
+        return false;
+    }
+
+    scheduler->activations = activations;
+
+    FMIActivation* blocked = (FMIActivation*)realloc(scheduler->blocked, size * sizeof(FMIActivation));
+
+    if (!blocked) {
+        return false;
+    }
+
+    scheduler->blocked = blocked;
+    scheduler->activationsSize = size;
+
+    return true;
+}
+
+// add an activation to the heap (there must be room for it)
+static void pushActivation(FMIScheduler* scheduler, FMIActivation activation) {
+
+    FMIActivation* heap = scheduler->activations;
+
+    size_t i = scheduler->nActivations++;
+
+    while (i > 0) {
+
+        const size_t parent = (i - 1) / 2;
+
+        if (!before(&activation, &heap[parent])) {
+            break;
+        }
+
+        heap[i] = heap[parent];
+        i = parent;
+    }
+
+    heap[i] = activation;
+}
+
+// remove the earliest activation from the heap
+static FMIActivation popActivation(FMIScheduler* scheduler) {
+
+    FMIActivation* heap = scheduler->activations;
+
+    const FMIActivation first = heap[0];
+    const FMIActivation last = heap[--scheduler->nActivations];
+    const size_t n = scheduler->nActivations;
+
+    size_t i = 0;
+
+    for (;;) {
+
+        size_t child = 2 * i + 1;
+
+        if (child >= n) {
+            break;
+        }
+
+        if (child + 1 < n && before(&heap[child + 1], &heap[child])) {
+            child++;
+        }
+
+        if (!before(&heap[child], &last)) {
+            break;
+        }
+
+        heap[i] = heap[child];
+        i = child;
+    }
+
+    if (n > 0) {
+        heap[i] = last;
+    }
+
+    return first;
+}
+
+static FMIActivation createActivation(FMIScheduler* scheduler, size_t partition, double time, bool periodic) {
+
+    FMIActivation activation = {
+        .time = time,
+        .priority = scheduler->partitions[partition].priority,
+        .sequence = scheduler->nScheduled++,
+        .partition = partition,
+        .periodic = periodic
+    };
+
+    return activation;
+}
+
+// release the due activations ordered by activation time and priority (must be called with the lock held)
+static void releaseActivations(FMIScheduler* scheduler) {
+
+    for (;;) {
+
+        if (!scheduler->concurrent && scheduler->nRunning > 0) {
+            return;
+        }
+
+        size_t nBlocked = 0;
+
+        // a partition runs one activation at a time
+        while (scheduler->nActivations > 0 && scheduler->activations[0].time <= scheduler->time &&
+            scheduler->partitions[scheduler->activations[0].partition].active) {
+            scheduler->blocked[nBlocked++] = popActivation(scheduler);
+        }
+
+        bool released = false;
+
+        if (scheduler->nActivations > 0 && scheduler->activations[0].time <= scheduler->time) {
+
+            const FMIActivation activation = popActivation(scheduler);
+
+            FMIPartition* partition = &scheduler->partitions[activation.partition];
+
+            // only the next activation of a periodic clock is in the heap so the heap does not grow with the simulated time
+            if (activation.periodic) {
+                partition->nPeriodicActivations++;
+                const double time = partition->firstActivation + partition->nPeriodicActivations * partition->interval;
+                pushActivation(scheduler, createActivation(scheduler, activation.partition, time, true));
+            }
+
+            partition->active = true;
+            partition->activationTime = activation.time;
+            scheduler->nRunning++;
+
+            NOTIFY(partition->released);
+
+            released = true;
+        }
+
+        // the popped activations left room for the blocked ones
+        for (size_t i = 0; i < nBlocked; i++) {
+            pushActivation(scheduler, scheduler->blocked[i]);
+        }
+
+        if (!released) {
+            return;
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI partitionThread(LPVOID arg) {
+#else
+static void* partitionThread(void* arg) {
+#endif
+
+    FMIPartition* partition = (FMIPartition*)arg;
+    FMIScheduler* scheduler = partition->scheduler;
+
+    LOCK(scheduler);
+
+#ifdef _WIN32
+    partition->threadId = GetCurrentThreadId();
+#else
+    partition->self = pthread_self();
+#endif
+
+    for (;;) {
+
+        while (!scheduler->quit && !partition->active) {
+            WAIT(scheduler, partition->released);
+        }
+
+        if (scheduler->quit) {
+            break;
+        }
+
+        const double activationTime = partition->activationTime;
+
+        UNLOCK(scheduler);
+
+        const FMIStatus status = scheduler->task(scheduler->context, partition->index, activationTime);
+
+        LOCK(scheduler);
+
+        if (status > scheduler->status) {
+            scheduler->status = status;
+        }
+
+        partition->active = false;
+        scheduler->nRunning--;
+
+        releaseActivations(scheduler);
+
+        NOTIFY(scheduler->finished);
+    }
+
+    UNLOCK(scheduler);
+
+    return 0;
+}
+
+// create the thread of a partition with a priority for its rank (0 is the highest priority)
+static bool createPartitionThread(FMIPartition* partition, size_t rank) {
+
+#ifdef _WIN32
+    partition->thread = CreateThread(NULL, 0, partitionThread, partition, 0, NULL);
+
+    if (!partition->thread) {
+        return false;
+    }
+
+    const int priority = rank < 4 ? THREAD_PRIORITY_HIGHEST - (int)rank : THREAD_PRIORITY_LOWEST;
+
+    SetThreadPriority(partition->thread, priority);
+#else
+    pthread_attr_t attr;
+    struct sched_param param;
+
+    const int maxPriority = sched_get_priority_max(SCHED_FIFO);
+    const int minPriority = sched_get_priority_min(SCHED_FIFO);
+
+    param.sched_priority = maxPriority - (int)rank > minPriority ? maxPriority - (int)rank : minPriority;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+
+    int error = pthread_create(&partition->thread, &attr, partitionThread, partition);
+
+    pthread_attr_destroy(&attr);
+
+    // use the default scheduling if the process is not allowed to use real-time priorities
+    if (error) {
+        error = pthread_create(&partition->thread, NULL, partitionThread, partition);
+    }
+
+    if (error) {
+        return false;
+    }
+#endif
+
+    partition->created = true;
+
+    return true;
+}
+
+FMIScheduler* FMICreateScheduler(size_t nPartitions, const int priorities[], FMIPartitionTask* task, void* context, bool concurrent) {
+
+    FMIScheduler* scheduler = (FMIScheduler*)calloc(1, sizeof(FMIScheduler));
+
+    if (!scheduler) {
+        return NULL;
+    }
+
+    scheduler->partitions = (FMIPartition*)calloc(nPartitions, sizeof(FMIPartition));
+
+    if (nPartitions > 0 && !scheduler->partitions) {
+        free(scheduler);
+        return NULL;
+    }
+
+    scheduler->nPartitions = nPartitions;
+    scheduler->time = -INFINITY;
+    scheduler->task = task;
+    scheduler->context = context;
+    scheduler->concurrent = concurrent;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&scheduler->mutex);
+    InitializeConditionVariable(&scheduler->finished);
+#else
+    pthread_mutex_init(&scheduler->mutex, NULL);
+    pthread_cond_init(&scheduler->finished, NULL);
+#endif
+
+    for (size_t i = 0; i < nPartitions; i++) {
+
+        FMIPartition* partition = &scheduler->partitions[i];
+
+        partition->scheduler = scheduler;
+        partition->index = i;
+        partition->priority = priorities[i];
+
+#ifdef _WIN32
+        InitializeConditionVariable(&partition->released);
+#else
+        pthread_cond_init(&partition->released, NULL);
+#endif
+    }
+
+    for (size_t i = 0; i < nPartitions; i++) {
+
+        // the number of distinct higher priorities
+        size_t rank = 0;
+
+        for (size_t j = 0; j < nPartitions; j++) {
+
+            bool distinct = priorities[j] < priorities[i];
+
+            for (size_t k = 0; distinct && k < j; k++) {
+                distinct = priorities[k] != priorities[j];
+            }
+
+            if (distinct) {
+                rank++;
+            }
+        }
+
+        if (!createPartitionThread(&scheduler->partitions[i], rank)) {
+            FMIFreeScheduler(scheduler);
+            return NULL;
+        }
+    }
+
+    return scheduler;
+}
+
+void FMIFreeScheduler(FMIScheduler* scheduler) {
+
+    if (!scheduler) {
+        return;
+    }
+
+    LOCK(scheduler);
+
+    scheduler->quit = true;
+
+    for (size_t i = 0; i < scheduler->nPartitions; i++) {
+        NOTIFY(scheduler->partitions[i].released);
+    }
+
+    UNLOCK(scheduler);
+
+    for (size_t i = 0; i < scheduler->nPartitions; i++) {
+
+        FMIPartition* partition = &scheduler->partitions[i];
+
+        if (partition->created) {
+#ifdef _WIN32
+            WaitForSingleObject(partition->thread, INFINITE);
+            CloseHandle(partition->thread);
+#else
+            pthread_join(partition->thread, NULL);
+#endif
+        }
+
+#ifndef _WIN32
+        pthread_cond_destroy(&partition->released);
+#endif
+    }
+
+#ifdef _WIN32
+    DeleteCriticalSection(&scheduler->mutex);
+#else
+    pthread_mutex_destroy(&scheduler->mutex);
+    pthread_cond_destroy(&scheduler->finished);
+#endif
+
+    free(scheduler->activations);
+    free(scheduler->blocked);
+    free(scheduler->partitions);
+    free(scheduler);
+}
+
+FMIStatus FMIScheduleActivation(FMIScheduler* scheduler, size_t partition, double activationTime) {
+
+    FMIStatus status = FMIOK;
+
+    if (partition >= scheduler->nPartitions) {
+        return FMIError;
+    }
+
+    LOCK(scheduler);
+
+    if (!reserveActivation(scheduler)) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    pushActivation(scheduler, createActivation(scheduler, partition, activationTime, false));
+
+    releaseActivations(scheduler);
+
+TERMINATE:
+    UNLOCK(scheduler);
+
+    return status;
+}
+
+FMIStatus FMISchedulePeriodicActivations(FMIScheduler* scheduler, size_t partition, double firstActivation, double interval) {
+
+    FMIStatus status = FMIOK;
+
+    if (partition >= scheduler->nPartitions || !(interval > 0)) {
+        return FMIError;
+    }
+
+    LOCK(scheduler);
+
+    if (!reserveActivation(scheduler)) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    scheduler->partitions[partition].firstActivation = firstActivation;
+    scheduler->partitions[partition].interval = interval;
+    scheduler->partitions[partition].nPeriodicActivations = 0;
+
+    pushActivation(scheduler, createActivation(scheduler, partition, firstActivation, true));
+
+    releaseActivations(scheduler);
+
+TERMINATE:
+    UNLOCK(scheduler);
+
+    return status;
+}
+
+void FMIReleaseActivations(FMIScheduler* scheduler, double time) {
+
+    LOCK(scheduler);
+
+    scheduler->time = time;
+
+    releaseActivations(scheduler);
+
+    UNLOCK(scheduler);
+}
+
+FMIStatus FMIRunPartitions(FMIScheduler* scheduler, double time) {
+
+    LOCK(scheduler);
+
+    scheduler->time = time;
+
+    releaseActivations(scheduler);
+
+    // the partitions release the activations they schedule and the ones that were waiting for them
+    while (scheduler->nRunning > 0) {
+        WAIT(scheduler, scheduler->finished);
+    }
+
+    const FMIStatus status = scheduler->status;
+
+    scheduler->status = FMIOK;
+
+    UNLOCK(scheduler);
+
+    return status;
+}
+
+double FMIActivationTime(FMIScheduler* scheduler) {
+
+    LOCK(scheduler);
+
+    double time = scheduler->time;
+
+    for (size_t i = 0; i < scheduler->nPartitions; i++) {
+
+        const FMIPartition* partition = &scheduler->partitions[i];
+
+#ifdef _WIN32
+        const bool current = partition->threadId == GetCurrentThreadId();
+#else
+        const bool current = partition->created && pthread_equal(partition->self, pthread_self());
+#endif
+
+        if (current && partition->active) {
+            time = partition->activationTime;
+            break;
+        }
+    }
+
+    UNLOCK(scheduler);
+
+    return time;
+}
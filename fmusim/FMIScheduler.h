@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "FMI.h"
+
+
+typedef struct FMIScheduler FMIScheduler;
+
+// activate the model partition with the given index
+typedef FMIStatus FMIPartitionTask(void* context, size_t partition, double activationTime);
+
+/* Create one thread per model partition. The pending activations are kept in a min-heap and the threads are only
+   woken for due activations. Activations that are due at the same time are released in the order of
+   their priorities (as in FMI 3.0 a lower value means a higher priority). The threads get real-time priorities if
+   the process is allowed to use them. With concurrent == false only one partition runs at a time. */
+FMIScheduler* FMICreateScheduler(size_t nPartitions, const int priorities[], FMIPartitionTask* task, void* context, bool concurrent);
+
+void FMIFreeScheduler(FMIScheduler* scheduler);
+
+// request the activation of a partition (may be called from the partitions, e.g. in the clockUpdate callback)
+FMIStatus FMIScheduleActivation(FMIScheduler* scheduler, size_t partition, double activationTime);
+
+/* Activate a partition periodically at firstActivation + n * interval. Only the next activation is kept in the
+   queue so the cost is proportional to the number of activations and not to the simulated time. */
+FMIStatus FMISchedulePeriodicActivations(FMIScheduler* scheduler, size_t partition, double firstActivation, double interval);
+
+// release the activations up to time without waiting for the partitions (e.g. to activate them in real time)
+void FMIReleaseActivations(FMIScheduler* scheduler, double time);
+
+/* Run all activations up to time (including the ones scheduled by the running partitions) and wait until the
+   partitions are idle. Returns the worst status of the activations since the last call. */
+FMIStatus FMIRunPartitions(FMIScheduler* scheduler, double time);
+
+// the activation time of the partition that runs on the calling thread (or the time up to which the activations have been released)
+double FMIActivationTime(FMIScheduler* scheduler);
+
+// process wide lock for the lockPreemption and unlockPreemption callbacks
+void FMILockPreemption(void);
+
+void FMIUnlockPreemption(void);
@@ -0,0 +1,522 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI2.h"
+#include "FMI3.h"
+#include "FMIZip.h"
+
+#include "FMISystem.h"
+
+
+#define FMI_PATH_MAX 4096
+
+#define MAX_LINE_LENGTH 65536
+
+#define WHITESPACE " \t\r\n"
+
+
+// size of the values of a connection type in the buffers of an FMU
+static size_t connectionValueSize(FMIVersion fmiVersion, FMIConnectionType type) {
+
+    switch (type) {
+    case FMIRealConnection:
+        return sizeof(double);
+    case FMIIntegerConnection:
+        return sizeof(int32_t);
+    default:
+        return fmiVersion == FMIVersion3 ? sizeof(fmi3Boolean) : sizeof(fmi2Boolean);
+    }
+}
+
+static bool connectionTypeForVariable(const FMIModelVariable* variable, FMIConnectionType* type) {
+
+    if (variable->nDimensions > 0) {
+        return false;
+    }
+
+    switch (variable->type) {
+    case FMIFloat64Type:
+    case FMIDiscreteFloat64Type:
+        *type = FMIRealConnection;
+        return true;
+    case FMIInt32Type:
+        *type = FMIIntegerConnection;
+        return true;
+    case FMIBooleanType:
+        *type = FMIBooleanConnection;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// remove leading and trailing whitespace
+static char* trim(char* s) {
+
+    s += strspn(s, WHITESPACE);
+
+    size_t length = strlen(s);
+
+    while (length > 0 && strchr(WHITESPACE, s[length - 1])) {
+        s[--length] = '\0';
+    }
+
+    return s;
+}
+
+// split the next whitespace separated token from s
+static char* nextToken(char** s) {
+
+    char* token = *s + strspn(*s, WHITESPACE);
+
+    if (!*token) {
+        return NULL;
+    }
+
+    char* end = token + strcspn(token, WHITESPACE);
+
+    if (*end) {
+        *end++ = '\0';
+    }
+
+    *s = end;
+
+    return token;
+}
+
+static bool isAbsolutePath(const char* path) {
+#ifdef _WIN32
+    return path[0] == '\\' || path[0] == '/' || (path[0] && path[1] == ':');
+#else
+    return path[0] == '/';
+#endif
+}
+
+// find the variable of a component for a reference "[name].[variable]"
+static FMIStatus resolveVariable(FMISystem* system, const char* reference, size_t* componentIndex, const FMIModelVariable** variable) {
+
+    const char* dot = strchr(reference, '.');
+
+    if (!dot) {
+        printf("Variable reference %s must have the form [name].[variable].\n", reference);
+        return FMIError;
+    }
+
+    const size_t length = dot - reference;
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        if (strlen(component->name) == length && !strncmp(component->name, reference, length)) {
+
+            *componentIndex = i;
+            *variable = FMIModelVariableForName(component->modelDescription, dot + 1);
+
+            if (!*variable) {
+                printf("Variable %s does not exist in %s.\n", dot + 1, component->name);
+                return FMIError;
+            }
+
+            return FMIOK;
+        }
+    }
+
+    printf("FMU %.*s does not exist.\n", (int)length, reference);
+
+    return FMIError;
+}
+
+// get the index of valueReference in the buffer and add it if it's not in the buffer
+static FMIStatus addValueReference(FMIConnectionBuffer* buffer, FMIValueReference valueReference, bool unique, size_t* index) {
+
+    for (size_t i = 0; i < buffer->nValues; i++) {
+        if (buffer->valueReferences[i] == valueReference) {
+            *index = i;
+            return unique ? FMIError : FMIOK;
+        }
+    }
+
+    FMIValueReference* valueReferences = realloc(buffer->valueReferences, (buffer->nValues + 1) * sizeof(FMIValueReference));
+
+    if (!valueReferences) {
+        return FMIError;
+    }
+
+    valueReferences[buffer->nValues] = valueReference;
+
+    buffer->valueReferences = valueReferences;
+
+    *index = buffer->nValues++;
+
+    return FMIOK;
+}
+
+static FMIStatus addComponent(FMISystem* system, const char* name, const char* path, FMILogMessage* logMessage, FMILogFunctionCall* logFunctionCall) {
+
+    if (strchr(name, '.')) {
+        printf("The name of an FMU must not contain a dot.\n");
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+        if (!strcmp(system->components[i].name, name)) {
+            printf("The name %s is not unique.\n", name);
+            return FMIError;
+        }
+    }
+
+    FMIComponent* components = realloc(system->components, (system->nComponents + 1) * sizeof(FMIComponent));
+
+    if (!components) {
+        return FMIError;
+    }
+
+    system->components = components;
+
+    FMIComponent* component = &components[system->nComponents++];
+
+    memset(component, 0, sizeof(FMIComponent));
+
+    component->name = strdup(name);
+    component->unzipdir = FMICreateTemporaryDirectory();
+
+    if (!component->name || !component->unzipdir) {
+        return FMIError;
+    }
+
+    if (FMIExtractArchive(path, component->unzipdir)) {
+        printf("Failed to extract %s.\n", path);
+        return FMIError;
+    }
+
+    char modelDescriptionPath[FMI_PATH_MAX] = "";
+
+    strcpy(modelDescriptionPath, component->unzipdir);
+
+    if (!FMIPathAppend(modelDescriptionPath, "modelDescription.xml")) {
+        return FMIError;
+    }
+
+    component->modelDescription = FMIReadModelDescription(modelDescriptionPath);
+
+    if (!component->modelDescription) {
+        printf("Failed to read the model description of %s.\n", path);
+        return FMIError;
+    }
+
+    const FMIModelDescription* modelDescription = component->modelDescription;
+
+    if (modelDescription->fmiVersion == FMIVersion1 || !modelDescription->coSimulation) {
+        printf("%s must be an FMI 2.0 or FMI 3.0 FMU for Co-Simulation.\n", path);
+        return FMIError;
+    }
+
+    char platformBinaryPath[FMI_PATH_MAX] = "";
+
+    FMIPlatformBinaryPath(component->unzipdir, modelDescription->coSimulation->modelIdentifier, modelDescription->fmiVersion, platformBinaryPath, FMI_PATH_MAX);
+
+    component->instance = FMICreateInstance(component->name, platformBinaryPath, logMessage, logFunctionCall);
+
+    if (!component->instance) {
+        printf("Failed to load the shared library of %s.\n", path);
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus addConnection(FMISystem* system, const char* start, const char* end) {
+
+    FMIConnection connection;
+    FMIConnectionType endType;
+    const FMIModelVariable* startVariable = NULL;
+    const FMIModelVariable* endVariable = NULL;
+
+    if (resolveVariable(system, start, &connection.startComponent, &startVariable) != FMIOK ||
+        resolveVariable(system, end, &connection.endComponent, &endVariable) != FMIOK) {
+        return FMIError;
+    }
+
+    if (startVariable->causality != FMIOutput || endVariable->causality != FMIInput) {
+        printf("Connection %s -> %s must connect an output to an input.\n", start, end);
+        return FMIError;
+    }
+
+    if (!connectionTypeForVariable(startVariable, &connection.type) ||
+        !connectionTypeForVariable(endVariable, &endType) || connection.type != endType) {
+        printf("Connection %s -> %s must connect scalar variables of the same type (Float64, Int32 or Boolean).\n", start, end);
+        return FMIError;
+    }
+
+    connection.startVariable = startVariable;
+    connection.endVariable = endVariable;
+
+    FMIComponent* startComponent = &system->components[connection.startComponent];
+    FMIComponent* endComponent = &system->components[connection.endComponent];
+
+    if (addValueReference(&startComponent->outputs[connection.type], startVariable->valueReference, false, &connection.startIndex) != FMIOK) {
+        return FMIError;
+    }
+
+    if (addValueReference(&endComponent->inputs[connection.type], endVariable->valueReference, true, &connection.endIndex) != FMIOK) {
+        printf("Input %s is connected more than once.\n", end);
+        return FMIError;
+    }
+
+    FMIConnection* connections = realloc(system->connections, (system->nConnections + 1) * sizeof(FMIConnection));
+
+    if (!connections) {
+        return FMIError;
+    }
+
+    connections[system->nConnections++] = connection;
+
+    system->connections = connections;
+
+    return FMIOK;
+}
+
+static FMIStatus addStartValue(FMISystem* system, const char* reference, const char* value) {
+
+    size_t componentIndex;
+    const FMIModelVariable* variable;
+
+    if (resolveVariable(system, reference, &componentIndex, &variable) != FMIOK) {
+        return FMIError;
+    }
+
+    FMIComponent* component = &system->components[componentIndex];
+
+    const FMIModelVariable** startVariables = realloc(component->startVariables, (component->nStartValues + 1) * sizeof(FMIModelVariable*));
+
+    if (!startVariables) {
+        return FMIError;
+    }
+
+    component->startVariables = startVariables;
+
+    const char** startValues = realloc(component->startValues, (component->nStartValues + 1) * sizeof(char*));
+
+    if (!startValues) {
+        return FMIError;
+    }
+
+    component->startValues = startValues;
+
+    startVariables[component->nStartValues] = variable;
+    startValues[component->nStartValues] = strdup(value);
+
+    if (!startValues[component->nStartValues++]) {
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+FMISystem* FMIReadSystem(const char* filename, FMILogMessage* logMessage, FMILogFunctionCall* logFunctionCall) {
+
+    FMIStatus status = FMIOK;
+
+    char* line = NULL;
+    char directory[FMI_PATH_MAX] = "";
+    char path[FMI_PATH_MAX] = "";
+
+    FMISystem* system = (FMISystem*)calloc(1, sizeof(FMISystem));
+
+    FILE* file = fopen(filename, "r");
+
+    line = (char*)malloc(MAX_LINE_LENGTH);
+
+    if (!system || !file || !line) {
+        printf("Failed to open %s.\n", filename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // the paths of the FMUs are relative to the system description
+    strncpy(directory, filename, FMI_PATH_MAX - 1);
+
+    char* separator = strrchr(directory, '/');
+
+#ifdef _WIN32
+    char* backslash = strrchr(directory, '\\');
+
+    if (backslash > separator) {
+        separator = backslash;
+    }
+#endif
+
+    if (separator) {
+        separator[1] = '\0';
+    } else {
+        directory[0] = '\0';
+    }
+
+    for (size_t lineNumber = 1; fgets(line, MAX_LINE_LENGTH, file); lineNumber++) {
+
+        if (!strchr(line, '\n') && !feof(file)) {
+            printf("%s:%zu: Line is too long.\n", filename, lineNumber);
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        char* rest = line;
+        char* keyword = nextToken(&rest);
+
+        if (!keyword || keyword[0] == '#') {
+            continue;
+        }
+
+        if (!strcmp(keyword, "fmu")) {
+
+            const char* name = nextToken(&rest);
+            const char* fmuPath = trim(rest);
+
+            if (!name || !*fmuPath) {
+                printf("%s:%zu: Expected fmu [name] [path].\n", filename, lineNumber);
+                status = FMIError;
+                goto TERMINATE;
+            }
+
+            if (isAbsolutePath(fmuPath)) {
+                snprintf(path, FMI_PATH_MAX, "%s", fmuPath);
+            } else {
+                snprintf(path, FMI_PATH_MAX, "%s%s", directory, fmuPath);
+            }
+
+            status = addComponent(system, name, path, logMessage, logFunctionCall);
+
+        } else if (!strcmp(keyword, "connection")) {
+
+            const char* start = nextToken(&rest);
+            const char* end = nextToken(&rest);
+
+            if (!start || !end || nextToken(&rest)) {
+                printf("%s:%zu: Expected connection [name].[variable] [name].[variable].\n", filename, lineNumber);
+                status = FMIError;
+                goto TERMINATE;
+            }
+
+            status = addConnection(system, start, end);
+
+        } else if (!strcmp(keyword, "start")) {
+
+            const char* reference = nextToken(&rest);
+            const char* value = trim(rest);
+
+            if (!reference || !*value) {
+                printf("%s:%zu: Expected start [name].[variable] [value].\n", filename, lineNumber);
+                status = FMIError;
+                goto TERMINATE;
+            }
+
+            status = addStartValue(system, reference, value);
+
+        } else {
+            printf("%s:%zu: Unknown statement \"%s\".\n", filename, lineNumber, keyword);
+            status = FMIError;
+        }
+
+        if (status != FMIOK) {
+            printf("%s:%zu: Failed to read the system description.\n", filename, lineNumber);
+            goto TERMINATE;
+        }
+    }
+
+    if (system->nComponents == 0) {
+        printf("%s does not contain any FMUs.\n", filename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // allocate the contiguous values of the connections
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        const FMIVersion fmiVersion = component->modelDescription->fmiVersion;
+
+        for (FMIConnectionType type = 0; type < FMINConnectionTypes; type++) {
+
+            const size_t valueSize = connectionValueSize(fmiVersion, type);
+
+            component->outputs[type].values = calloc(component->outputs[type].nValues + 1, valueSize);
+            component->inputs[type].values  = calloc(component->inputs[type].nValues + 1, valueSize);
+
+            if (!component->outputs[type].values || !component->inputs[type].values) {
+                status = FMIError;
+                goto TERMINATE;
+            }
+        }
+    }
+
+TERMINATE:
+
+    if (file) {
+        fclose(file);
+    }
+
+    free(line);
+
+    if (status != FMIOK) {
+        FMIFreeSystem(system);
+        return NULL;
+    }
+
+    return system;
+}
+
+static void freeConnectionBuffer(FMIConnectionBuffer* buffer) {
+    free(buffer->valueReferences);
+    free(buffer->values);
+}
+
+void FMIFreeSystem(FMISystem* system) {
+
+    if (!system) {
+        return;
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        if (component->recorder) {
+            free((void*)component->recorder->variables);
+            FMIFreeRecorder(component->recorder);
+        }
+
+        if (component->instance) {
+            FMIFreeInstance(component->instance);
+        }
+
+        if (component->modelDescription) {
+            FMIFreeModelDescription(component->modelDescription);
+        }
+
+        if (component->unzipdir) {
+            FMIRemoveDirectory(component->unzipdir);
+            free((void*)component->unzipdir);
+        }
+
+        for (size_t j = 0; j < component->nStartValues; j++) {
+            free((void*)component->startValues[j]);
+        }
+
+        free(component->startVariables);
+        free(component->startValues);
+
+        for (FMIConnectionType type = 0; type < FMINConnectionTypes; type++) {
+            freeConnectionBuffer(&component->outputs[type]);
+            freeConnectionBuffer(&component->inputs[type]);
+        }
+
+        free((void*)component->name);
+    }
+
+    free(system->components);
+    free(system->connections);
+    free(system);
+}
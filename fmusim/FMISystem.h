@@ -0,0 +1,83 @@
+#pragma once
+
+#include "FMI.h"
+#include "FMIModelDescription.h"
+#include "FMIRecorder.h"
+
+
+// types of the values that can be exchanged through connections
+typedef enum {
+
+    FMIRealConnection,
+    FMIIntegerConnection,
+    FMIBooleanConnection,
+    FMINConnectionTypes
+
+} FMIConnectionType;
+
+// value references and contiguous values of the connected variables of one type that are get / set with a single call
+typedef struct {
+
+    size_t nValues;
+    FMIValueReference* valueReferences;
+    void* values;
+
+} FMIConnectionBuffer;
+
+// an FMU in a system
+typedef struct {
+
+    const char* name;
+    const char* unzipdir;
+    FMIModelDescription* modelDescription;
+    FMIInstance* instance;
+    FMIRecorder* recorder;
+
+    size_t nStartValues;
+    const FMIModelVariable** startVariables;
+    const char** startValues;
+
+    // connected outputs and inputs
+    FMIConnectionBuffer outputs[FMINConnectionTypes];
+    FMIConnectionBuffer inputs[FMINConnectionTypes];
+
+    // status of the last task
+    FMIStatus status;
+    bool terminated;
+
+} FMIComponent;
+
+// connects the output values[startIndex] of startComponent to the input values[endIndex] of endComponent
+typedef struct {
+
+    FMIConnectionType type;
+    size_t startComponent;
+    size_t startIndex;
+    const FMIModelVariable* startVariable;
+    size_t endComponent;
+    size_t endIndex;
+    const FMIModelVariable* endVariable;
+
+} FMIConnection;
+
+typedef struct {
+
+    size_t nComponents;
+    FMIComponent* components;
+
+    size_t nConnections;
+    FMIConnection* connections;
+
+} FMISystem;
+
+/* Read a system description, extract the FMUs and create their instances. A system description is a text file
+   with one statement per line (paths are relative to the system description, empty lines and lines that start
+   with # are ignored):
+
+     fmu [name] [path]                                    add an FMU
+     connection [name].[variable] [name].[variable]       connect an output to an input
+     start [name].[variable] [value]                      set a start value
+*/
+FMISystem* FMIReadSystem(const char* filename, FMILogMessage* logMessage, FMILogFunctionCall* logFunctionCall);
+
+void FMIFreeSystem(FMISystem* system);
@@ -0,0 +1,194 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "FMIThreadPool.h"
+
+
+#ifdef _WIN32
+#define LOCK(p)      EnterCriticalSection(&(p)->mutex)
+#define UNLOCK(p)    LeaveCriticalSection(&(p)->mutex)
+#define WAIT(p, c)   SleepConditionVariableCS(&(p)->c, &(p)->mutex, INFINITE)
+#define NOTIFY(p, c) WakeAllConditionVariable(&(p)->c)
+#else
+#define LOCK(p)      pthread_mutex_lock(&(p)->mutex)
+#define UNLOCK(p)    pthread_mutex_unlock(&(p)->mutex)
+#define WAIT(p, c)   pthread_cond_wait(&(p)->c, &(p)->mutex)
+#define NOTIFY(p, c) pthread_cond_broadcast(&(p)->c)
+#endif
+
+struct FMIThreadPool {
+
+    size_t nThreads;
+
+#ifdef _WIN32
+    HANDLE* threads;
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE started;
+    CONDITION_VARIABLE finished;
+#else
+    pthread_t* threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t started;
+    pthread_cond_t finished;
+#endif
+
+    FMITask* task;
+    void* context;
+    size_t nTasks;
+    size_t nextTask;
+    size_t nFinishedTasks;
+
+    bool quit;
+};
+
+// take the next task and run it (must be called with the lock held)
+static void runNextTask(FMIThreadPool* pool) {
+
+    const size_t index = pool->nextTask++;
+
+    UNLOCK(pool);
+
+    pool->task(pool->context, index);
+
+    LOCK(pool);
+
+    if (++pool->nFinishedTasks == pool->nTasks) {
+        NOTIFY(pool, finished);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker(LPVOID arg) {
+#else
+static void* worker(void* arg) {
+#endif
+
+    FMIThreadPool* pool = (FMIThreadPool*)arg;
+
+    LOCK(pool);
+
+    for (;;) {
+
+        while (!pool->quit && pool->nextTask >= pool->nTasks) {
+            WAIT(pool, started);
+        }
+
+        if (pool->quit) {
+            break;
+        }
+
+        runNextTask(pool);
+    }
+
+    UNLOCK(pool);
+
+    return 0;
+}
+
+FMIThreadPool* FMICreateThreadPool(size_t nThreads) {
+
+    FMIThreadPool* pool = (FMIThreadPool*)calloc(1, sizeof(FMIThreadPool));
+
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->threads = calloc(nThreads, sizeof(pool->threads[0]));
+
+    if (nThreads > 0 && !pool->threads) {
+        free(pool);
+        return NULL;
+    }
+
+#ifdef _WIN32
+    InitializeCriticalSection(&pool->mutex);
+    InitializeConditionVariable(&pool->started);
+    InitializeConditionVariable(&pool->finished);
+#else
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->started, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+#endif
+
+    for (size_t i = 0; i < nThreads; i++) {
+
+#ifdef _WIN32
+        pool->threads[i] = CreateThread(NULL, 0, worker, pool, 0, NULL);
+        if (!pool->threads[i]) {
+#else
+        if (pthread_create(&pool->threads[i], NULL, worker, pool)) {
+#endif
+            FMIFreeThreadPool(pool);
+            return NULL;
+        }
+
+        pool->nThreads++;
+    }
+
+    return pool;
+}
+
+void FMIFreeThreadPool(FMIThreadPool* pool) {
+
+    if (!pool) {
+        return;
+    }
+
+    LOCK(pool);
+    pool->quit = true;
+    NOTIFY(pool, started);
+    UNLOCK(pool);
+
+    for (size_t i = 0; i < pool->nThreads; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+
+#ifdef _WIN32
+    DeleteCriticalSection(&pool->mutex);
+#else
+    pthread_cond_destroy(&pool->finished);
+    pthread_cond_destroy(&pool->started);
+    pthread_mutex_destroy(&pool->mutex);
+#endif
+
+    free(pool->threads);
+    free(pool);
+}
+
+void FMIRunTasks(FMIThreadPool* pool, FMITask* task, void* context, size_t nTasks) {
+
+    if (nTasks == 0) {
+        return;
+    }
+
+    LOCK(pool);
+
+    pool->task           = task;
+    pool->context        = context;
+    pool->nTasks         = nTasks;
+    pool->nextTask       = 0;
+    pool->nFinishedTasks = 0;
+
+    NOTIFY(pool, started);
+
+    while (pool->nextTask < pool->nTasks) {
+        runNextTask(pool);
+    }
+
+    while (pool->nFinishedTasks < pool->nTasks) {
+        WAIT(pool, finished);
+    }
+
+    UNLOCK(pool);
+}
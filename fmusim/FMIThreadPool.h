@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+
+
+typedef struct FMIThreadPool FMIThreadPool;
+
+typedef void FMITask(void* context, size_t index);
+
+// create a pool of nThreads worker threads (the calling thread also works on the tasks)
+FMIThreadPool* FMICreateThreadPool(size_t nThreads);
+
+void FMIFreeThreadPool(FMIThreadPool* pool);
+
+// run task(context, 0) ... task(context, nTasks - 1) in parallel and wait until all tasks have finished
+void FMIRunTasks(FMIThreadPool* pool, FMITask* task, void* context, size_t nTasks);
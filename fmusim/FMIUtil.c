@@ -1,5 +1,17 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "FMI1.h"
 #include "FMI2.h"
 #include "FMI3.h"
@@ -51,6 +63,7 @@ FMIStatus FMI1SetValues(
 
      switch (type) {
      case FMIRealType:
+     case FMIDiscreteRealType:
          return FMI1SetReal(instance, valueReferences, nValueReferences, (fmi1Real*)values);
      case FMIIntegerType:
          return FMI1SetInteger(instance, valueReferences, nValueReferences, (fmi1Integer*)values);
@@ -72,6 +85,7 @@ FMIStatus FMI2SetValues(
 
     switch (type) {
     case FMIRealType:
+    case FMIDiscreteRealType:
         return FMI2SetReal(instance, valueReferences, nValueReferences, (fmi2Real*)values);
     case FMIIntegerType:
         return FMI2SetInteger(instance, valueReferences, nValueReferences, (fmi2Integer*)values);
@@ -94,8 +108,10 @@ FMIStatus FMI3SetValues(
 
     switch (type) {
     case FMIFloat32Type:
+    case FMIDiscreteFloat32Type:
         return FMI3SetFloat32(instance, valueReferences, nValueReferences, (fmi3Float32*)values, nValues);
     case FMIFloat64Type:
+    case FMIDiscreteFloat64Type:
         return FMI3SetFloat64(instance, valueReferences, nValueReferences, (fmi3Float64*)values, nValues);
     case FMIInt8Type:
         return FMI3SetInt8(instance, valueReferences, nValueReferences, (fmi3Int8*)values, nValues);
@@ -291,121 +307,712 @@ FMIStatus FMI3SetValues(
      return FMIOK;
  }
 
-FMIStatus FMIRestoreFMUStateFromFile(FMIInstance* S, const char* filename) {
+void* FMIMapFile(const char* filename, size_t* size) {
 
-     FMIStatus status = FMIOK;
+    void* data = NULL;
 
-     FILE* file = NULL;
+    *size = 0;
 
-     file = fopen(filename, "rb");
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
 
-     if (!file) {
-         return FMIError;
-     }
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
 
-     fseek(file, 0L, SEEK_END);
-     
-     const size_t serializedFMUStateSize = ftell(file);
+    LARGE_INTEGER fileSize;
 
-     fseek(file, 0L, SEEK_SET);
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
 
-     char* serializedFMUState = (char*)calloc(serializedFMUStateSize, sizeof(char));
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
 
-     if (!serializedFMUState) {
-         return FMIError;
-     }
+        if (mapping) {
+            // the view keeps the mapping alive after the handles have been closed
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
 
-     fread(serializedFMUState, sizeof(char), serializedFMUStateSize, file);
+        *size = (size_t)fileSize.QuadPart;
+    }
 
-     fclose(file);
+    CloseHandle(file);
+#else
+    const int fd = open(filename, O_RDONLY);
 
-     void* FMUState = NULL;
+    if (fd < 0) {
+        return NULL;
+    }
 
-     switch (S->fmiVersion) {
-     case FMIVersion2:
-         CALL(FMI2DeSerializeFMUstate(S, serializedFMUState, serializedFMUStateSize, &FMUState));
-         CALL(FMI2SetFMUstate(S, FMUState));
-         CALL(FMI2FreeFMUstate(S, FMUState));
-         break;
-     case FMIVersion3:
-         CALL(FMI3DeserializeFMUState(S, serializedFMUState, serializedFMUStateSize, &FMUState));
-         CALL(FMI3SetFMUState(S, FMUState));
-         CALL(FMI3FreeFMUState(S, FMUState));
-         break;
-     default:
-         status = FMIError;
-         break;
-     }
+    struct stat st;
 
- TERMINATE:
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
 
-     free(serializedFMUState);
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
 
-     return status;
+        if (data == MAP_FAILED) {
+            data = NULL;
+        }
+
+        *size = (size_t)st.st_size;
+    }
+
+    close(fd);
+#endif
+
+    return data;
 }
 
-FMIStatus FMISaveFMUStateToFile(FMIInstance* S, const char* filename) {
+void* FMICreateMappedFile(const char* filename, size_t size) {
 
-    if (S->fmiVersion == FMIVersion1) {
-        return FMIError;
+    void* data = NULL;
+
+    if (size == 0) {
+        return NULL;
     }
 
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    // the mapping extends the file to its size
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+
+    if (mapping) {
+        data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+#else
+    const int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (ftruncate(fd, (off_t)size) == 0) {
+
+        data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (data == MAP_FAILED) {
+            data = NULL;
+        }
+    }
+
+    close(fd);
+#endif
+
+    return data;
+}
+
+void FMIUnmapFile(void* data, size_t size) {
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+// delta encoded FMU state file: header, name of the base file and the byte ranges that differ from the base state
+#define FMU_STATE_DELTA_MAGIC   "FMIDELTA"
+#define FMU_STATE_DELTA_VERSION 1
+
+// maximum length of a chain of delta encoded FMU state files
+#define FMU_STATE_DELTA_MAX_DEPTH 64
+
+// unchanged bytes that are included in a range instead of starting a new one
+#define FMU_STATE_DELTA_MIN_GAP 16
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t baseFilenameLength;
+    uint64_t baseSize;
+    uint64_t baseHash;
+    uint64_t size;
+    uint64_t nRanges;
+} FMUStateDeltaHeader;
+
+// serialized FMU state that is either mapped from a file or has been reconstructed from deltas
+typedef struct {
+    char* data;
+    size_t size;
+    bool mapped;
+} FMUStateBuffer;
+
+static void freeFMUStateBuffer(FMUStateBuffer* buffer) {
+
+    if (buffer->mapped) {
+        if (buffer->data) {
+            FMIUnmapFile(buffer->data, buffer->size);
+        }
+    } else {
+        free(buffer->data);
+    }
+
+    memset(buffer, 0, sizeof(FMUStateBuffer));
+}
+
+#ifdef _WIN32
+#define IS_SEPARATOR(c) ((c) == '/' || (c) == '\\')
+#else
+#define IS_SEPARATOR(c) ((c) == '/')
+#endif
+
+static bool isAbsolutePath(const char* path) {
+#ifdef _WIN32
+    return IS_SEPARATOR(path[0]) || (path[0] != '\0' && path[1] == ':');
+#else
+    return path[0] == '/';
+#endif
+}
+
+// length of the directory of path including the trailing separator
+static size_t directoryLength(const char* path) {
+
+    size_t length = strlen(path);
+
+    while (length > 0 && !IS_SEPARATOR(path[length - 1])) {
+        length--;
+    }
+
+    return length;
+}
+
+// absolute path without symbolic links of a file that does not have to exist yet
+static char* canonicalPath(const char* path) {
+
+#ifdef _WIN32
+    return _fullpath(NULL, path, 0);
+#else
+    char* resolved = realpath(path, NULL);
+
+    if (resolved) {
+        return resolved;
+    }
+
+    // resolve the directory and append the file name
+    const size_t length = directoryLength(path);
+
+    char* directory = (char*)calloc(length + 2, sizeof(char));
+
+    if (!directory) {
+        return NULL;
+    }
+
+    if (length > 0) {
+        memcpy(directory, path, length);
+    } else {
+        directory[0] = '.';
+    }
+
+    char* resolvedDirectory = realpath(directory, NULL);
+
+    free(directory);
+
+    if (!resolvedDirectory) {
+        return NULL;
+    }
+
+    const char* name = path + length;
+    const size_t directorySize = strlen(resolvedDirectory);
+
+    resolved = (char*)calloc(directorySize + strlen(name) + 2, sizeof(char));
+
+    if (resolved) {
+        strcpy(resolved, resolvedDirectory);
+        if (directorySize == 0 || resolved[directorySize - 1] != '/') {
+            strcat(resolved, "/");
+        }
+        strcat(resolved, name);
+    }
+
+    free(resolvedDirectory);
+
+    return resolved;
+#endif
+}
+
+static bool isSamePath(const char* path1, const char* path2) {
+#ifdef _WIN32
+    return _stricmp(path1, path2) == 0;
+#else
+    return strcmp(path1, path2) == 0;
+#endif
+}
+
+// path of the base file relative to the directory of a delta file (both canonical)
+static char* relativeBaseFilename(const char* filename, const char* baseFilename) {
+
+    // length of the common directory including the trailing separator
+    size_t common = 0;
+
+    for (size_t i = 0; filename[i] != '\0' && baseFilename[i] != '\0'; i++) {
+
+        if (IS_SEPARATOR(filename[i]) && IS_SEPARATOR(baseFilename[i])) {
+            common = i + 1;
+        }
+#ifdef _WIN32
+        if (tolower((unsigned char)filename[i]) != tolower((unsigned char)baseFilename[i])) {
+#else
+        if (filename[i] != baseFilename[i]) {
+#endif
+            break;
+        }
+    }
+
+    // on different drives the absolute path is used
+    if (common == 0) {
+        return strdup(baseFilename);
+    }
+
+    size_t nParents = 0;
+
+    for (const char* c = filename + common; *c != '\0'; c++) {
+        if (IS_SEPARATOR(*c)) {
+            nParents++;
+        }
+    }
+
+    const char* name = baseFilename + common;
+
+    char* relative = (char*)calloc(3 * nParents + strlen(name) + 1, sizeof(char));
+
+    if (!relative) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < nParents; i++) {
+        strcat(relative, "../");
+    }
+
+    strcat(relative, name);
+
+    return relative;
+}
+
+// path of the base file of a delta file (relative paths are relative to the directory of the delta file)
+static char* resolveBaseFilename(const char* filename, const char* baseFilename) {
+
+    const size_t length = isAbsolutePath(baseFilename) ? 0 : directoryLength(filename);
+
+    char* path = (char*)calloc(length + strlen(baseFilename) + 1, sizeof(char));
+
+    if (path) {
+        memcpy(path, filename, length);
+        strcpy(path + length, baseFilename);
+    }
+
+    return path;
+}
+
+static uint64_t hashBytes(const char* data, size_t size) {
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// read a serialized FMU state and apply the deltas
+static FMIStatus readFMUStateFile(const char* filename, FMUStateBuffer* state, size_t depth) {
+
     FMIStatus status = FMIOK;
 
-    void* FMUState = NULL;
+    char* file = NULL;
+    size_t fileSize = 0;
+    char* storedBaseFilename = NULL;
+    char* baseFilename = NULL;
+    FMUStateBuffer base = { NULL, 0, false };
+
+    memset(state, 0, sizeof(FMUStateBuffer));
+
+    if (depth > FMU_STATE_DELTA_MAX_DEPTH) {
+        return FMIError;
+    }
+
+    file = (char*)FMIMapFile(filename, &fileSize);
+
+    if (!file) {
+        return FMIError;
+    }
+
+    FMUStateDeltaHeader header;
+
+    if (fileSize < sizeof(header) || memcmp(file, FMU_STATE_DELTA_MAGIC, 8)) {
+        // full FMU state (deserialized directly from the mapped file)
+        state->data = file;
+        state->size = fileSize;
+        state->mapped = true;
+        return FMIOK;
+    }
+
+    memcpy(&header, file, sizeof(header));
+
+    size_t offset = sizeof(header);
+
+    if (header.version != FMU_STATE_DELTA_VERSION || header.baseFilenameLength > fileSize - offset) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    storedBaseFilename = (char*)calloc(header.baseFilenameLength + 1, sizeof(char));
+
+    if (!storedBaseFilename) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    memcpy(storedBaseFilename, file + offset, header.baseFilenameLength);
+
+    offset += header.baseFilenameLength;
+
+    baseFilename = resolveBaseFilename(filename, storedBaseFilename);
+
+    if (!baseFilename) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(readFMUStateFile(baseFilename, &base, depth + 1));
+
+    if (base.size != header.baseSize || hashBytes(base.data, base.size) != header.baseHash) {
+        printf("The FMU state in %s has changed since %s was written.\n", baseFilename, filename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    state->data = (char*)calloc(header.size > 0 ? header.size : 1, sizeof(char));
+    state->size = header.size;
+
+    if (!state->data) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    memcpy(state->data, base.data, base.size < header.size ? base.size : header.size);
+
+    for (uint64_t i = 0; i < header.nRanges; i++) {
+
+        uint64_t range[2];  // offset, length
+
+        if (sizeof(range) > fileSize - offset) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        memcpy(range, file + offset, sizeof(range));
+
+        offset += sizeof(range);
+
+        if (range[0] > header.size || range[1] > header.size - range[0] || range[1] > fileSize - offset) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        memcpy(state->data + range[0], file + offset, range[1]);
+
+        offset += range[1];
+    }
+
+TERMINATE:
+
+    FMIUnmapFile(file, fileSize);
+    free(storedBaseFilename);
+    free(baseFilename);
+    freeFMUStateBuffer(&base);
+
+    if (status > FMIOK) {
+        freeFMUStateBuffer(state);
+    }
+
+    return status;
+}
+
+// find the next range of bytes starting at *offset that differs from the base
+static size_t nextDeltaRange(const char* base, size_t baseSize, const char* data, size_t size, size_t* offset) {
+
+    size_t i = *offset;
+
+    while (i < size && i < baseSize && base[i] == data[i]) {
+        i++;
+    }
+
+    if (i == size) {
+        return 0;
+    }
+
+    const size_t start = i;
+
+    size_t end = i;
+
+    while (i < size) {
+        if (i >= baseSize || base[i] != data[i]) {
+            end = ++i;
+        } else if (i - end >= FMU_STATE_DELTA_MIN_GAP) {
+            break;
+        } else {
+            i++;
+        }
+    }
+
+    *offset = start;
+
+    return end - start;
+}
+
+static FMIStatus writeFMUStateDelta(FILE* file, const char* baseFilename, const char* base, size_t baseSize, const char* data, size_t size) {
+
+    FMUStateDeltaHeader header;
+
+    memcpy(header.magic, FMU_STATE_DELTA_MAGIC, 8);
+    header.version = FMU_STATE_DELTA_VERSION;
+    header.baseFilenameLength = (uint32_t)strlen(baseFilename);
+    header.baseSize = baseSize;
+    header.baseHash = hashBytes(base, baseSize);
+    header.size = size;
+    header.nRanges = 0;
+
+    size_t offset = 0;
+    size_t length;
+
+    while ((length = nextDeltaRange(base, baseSize, data, size, &offset))) {
+        header.nRanges++;
+        offset += length;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(baseFilename, sizeof(char), header.baseFilenameLength, file) != header.baseFilenameLength) {
+        return FMIError;
+    }
+
+    offset = 0;
+
+    while ((length = nextDeltaRange(base, baseSize, data, size, &offset))) {
+
+        const uint64_t range[2] = { offset, length };
+
+        if (fwrite(range, sizeof(range), 1, file) != 1 || fwrite(data + offset, sizeof(char), length, file) != length) {
+            return FMIError;
+        }
+
+        offset += length;
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus getFMUState(FMIInstance* S, void** FMUState, size_t* size) {
+
+    FMIStatus status = FMIOK;
 
     if (S->fmiVersion == FMIVersion2) {
-        CALL(FMI2GetFMUstate(S, &FMUState));
+        CALL(FMI2GetFMUstate(S, FMUState));
+        CALL(FMI2SerializedFMUstateSize(S, *FMUState, size));
+    } else if (S->fmiVersion == FMIVersion3) {
+        CALL(FMI3GetFMUState(S, FMUState));
+        CALL(FMI3SerializedFMUStateSize(S, *FMUState, size));
     } else {
-        CALL(FMI3GetFMUState(S, &FMUState));
+        status = FMIError;
     }
 
-    size_t serializedFMUStateSize = 0;
+TERMINATE:
+    return status;
+}
+
+static FMIStatus serializeFMUState(FMIInstance* S, void* FMUState, char* data, size_t size) {
 
     if (S->fmiVersion == FMIVersion2) {
-        CALL(FMI2SerializedFMUstateSize(S, FMUState, &serializedFMUStateSize));
+        return FMI2SerializeFMUstate(S, FMUState, data, size);
     } else {
-        CALL(FMI3SerializedFMUStateSize(S, FMUState, &serializedFMUStateSize));
+        return FMI3SerializeFMUState(S, FMUState, data, size);
     }
+}
 
-    char* serializedFMUState = (char*)calloc(serializedFMUStateSize, sizeof(char));
+static void freeFMUState(FMIInstance* S, void** FMUState) {
 
-    if (!serializedFMUState) {
-        status = FMIError;
-        goto TERMINATE;
+    if (!*FMUState) {
+        return;
     }
 
     if (S->fmiVersion == FMIVersion2) {
-        CALL(FMI2SerializeFMUstate(S, FMUState, serializedFMUState, serializedFMUStateSize));
+        FMI2FreeFMUstate(S, FMUState);
     } else {
-        CALL(FMI3SerializeFMUState(S, FMUState, serializedFMUState, serializedFMUStateSize));
+        FMI3FreeFMUState(S, FMUState);
     }
+}
 
-    FILE* file = fopen(filename, "wb");
+FMIStatus FMIGetSerializedFMUState(FMIInstance* S, char** data, size_t* size) {
 
-    if (!file) {
+    FMIStatus status = FMIOK;
+
+    void* FMUState = NULL;
+
+    *data = NULL;
+    *size = 0;
+
+    CALL(getFMUState(S, &FMUState, size));
+
+    *data = (char*)calloc(*size, sizeof(char));
+
+    if (!*data) {
         status = FMIError;
         goto TERMINATE;
     }
 
-    const size_t written = fwrite(serializedFMUState, sizeof(char), serializedFMUStateSize, file);
+    CALL(serializeFMUState(S, FMUState, *data, *size));
+
+TERMINATE:
+
+    if (status > FMIOK) {
+        free(*data);
+        *data = NULL;
+        *size = 0;
+    }
+
+    freeFMUState(S, &FMUState);
+
+    return status;
+}
+
+FMIStatus FMISetSerializedFMUState(FMIInstance* S, const char* data, size_t size) {
+
+    FMIStatus status = FMIOK;
 
-    fclose(file);
+    void* FMUState = NULL;
 
-    if (written != serializedFMUStateSize) {
+    switch (S->fmiVersion) {
+    case FMIVersion2:
+        CALL(FMI2DeSerializeFMUstate(S, data, size, &FMUState));
+        CALL(FMI2SetFMUstate(S, FMUState));
+        CALL(FMI2FreeFMUstate(S, &FMUState));
+        break;
+    case FMIVersion3:
+        CALL(FMI3DeserializeFMUState(S, data, size, &FMUState));
+        CALL(FMI3SetFMUState(S, FMUState));
+        CALL(FMI3FreeFMUState(S, &FMUState));
+        break;
+    default:
         status = FMIError;
-        goto TERMINATE;
+        break;
     }
 
-    free(serializedFMUState);
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMIRestoreFMUStateFromFile(FMIInstance* S, const char* filename) {
+
+    FMIStatus status = FMIOK;
+
+    FMUStateBuffer state = { NULL, 0, false };
+
+    CALL(readFMUStateFile(filename, &state, 0));
+
+    CALL(FMISetSerializedFMUState(S, state.data, state.size));
+
+TERMINATE:
+
+    freeFMUStateBuffer(&state);
+
+    return status;
+}
+
+FMIStatus FMISaveFMUStateToFile(FMIInstance* S, const char* filename, const char* baseFilename) {
+
+    FMIStatus status = FMIOK;
+
+    void* FMUState = NULL;
+    FMUStateBuffer state = { NULL, 0, false };
+    FMUStateBuffer base = { NULL, 0, false };
+    FILE* file = NULL;
+    char* canonicalFilename = NULL;
+    char* canonicalBaseFilename = NULL;
+    char* storedBaseFilename = NULL;
+
+    CALL(getFMUState(S, &FMUState, &state.size));
+
+    if (baseFilename) {
+
+        canonicalFilename = canonicalPath(filename);
+        canonicalBaseFilename = canonicalPath(baseFilename);
+
+        if (!canonicalFilename || !canonicalBaseFilename) {
+            printf("Failed to resolve the path of the FMU state file %s or its base %s.\n", filename, baseFilename);
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        // the base file is mapped while the delta is written
+        if (isSamePath(canonicalFilename, canonicalBaseFilename)) {
+            printf("The FMU state file %s cannot be its own base.\n", filename);
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        // the base file is found relative to the delta file when it is read
+        storedBaseFilename = relativeBaseFilename(canonicalFilename, canonicalBaseFilename);
+
+        if (!storedBaseFilename) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(readFMUStateFile(baseFilename, &base, 0));
+
+        state.data = (char*)calloc(state.size, sizeof(char));
+
+        if (!state.data) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(serializeFMUState(S, FMUState, state.data, state.size));
+
+        file = fopen(filename, "wb");
+
+        if (!file) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(writeFMUStateDelta(file, storedBaseFilename, base.data, base.size, state.data, state.size));
 
-    if (S->fmiVersion == FMIVersion2) {
-        CALL(FMI2FreeFMUstate(S, FMUState));
     } else {
-        CALL(FMI3FreeFMUState(S, FMUState));
+
+        // serialize directly into the file
+        state.data = (char*)FMICreateMappedFile(filename, state.size);
+        state.mapped = true;
+
+        if (!state.data) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(serializeFMUState(S, FMUState, state.data, state.size));
     }
 
 TERMINATE:
 
+    if (file && fclose(file)) {
+        status = FMIError;
+    }
+
+    freeFMUStateBuffer(&state);
+    freeFMUStateBuffer(&base);
+    freeFMUState(S, &FMUState);
+
+    free(canonicalFilename);
+    free(canonicalBaseFilename);
+    free(storedBaseFilename);
+
     return status;
 }
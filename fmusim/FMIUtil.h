@@ -35,6 +35,20 @@ FMIStatus FMIParseStartValues(FMIVariableType type, const char* literal, size_t
 
 FMIStatus FMIHexToBinary(const char* hex, size_t* size, unsigned char** value);
 
+// map a file into memory for reading (returns NULL if the file does not exist or is empty)
+void* FMIMapFile(const char* filename, size_t* size);
+
+// create a file of the given size and map it into memory for writing
+void* FMICreateMappedFile(const char* filename, size_t size);
+
+void FMIUnmapFile(void* data, size_t size);
+
+// get the serialized FMU state (the caller must free the returned buffer)
+FMIStatus FMIGetSerializedFMUState(FMIInstance* S, char** data, size_t* size);
+
+FMIStatus FMISetSerializedFMUState(FMIInstance* S, const char* data, size_t size);
+
 FMIStatus FMIRestoreFMUStateFromFile(FMIInstance* S, const char* filename);
 
-FMIStatus FMISaveFMUStateToFile(FMIInstance* S, const char* filename);
+// write the FMU state to a file (delta encoded against the state in baseFilename if not NULL)
+FMIStatus FMISaveFMUStateToFile(FMIInstance* S, const char* filename, const char* baseFilename);
@@ -26,7 +26,10 @@
 #include "fmusim_fmi2_cs.h"
 #include "fmusim_fmi2_me.h"
 #include "fmusim_fmi3_cs.h"
+#include "fmusim_fmi3_ensemble.h"
+#include "fmusim_fmi3_se.h"
 #include "fmusim_fmi3_me.h"
+#include "fmusim_system.h"
 
 #include "fmusim_input.h"
 
@@ -105,14 +108,16 @@ void printUsage() {
         "Simulate a Functional Mock-up Unit and write the output to result.csv.\n"
         "\n"
         "  --help                           display this help and exit\n"
-        "  --interface-type [me|cs]         the interface type to use\n"
+        "  --interface-type [me|cs|se]      the interface type to use\n"
         "  --tolerance [TOLERANCE]          relative tolerance\n"
         "  --start-time [VALUE]             start time\n"
         "  --stop-time [VALUE]              stop time\n"
         "  --output-interval [VALUE]        set the output interval\n"
         "  --start-value [name] [value]     set a start value\n"
         "  --output-variable [name]         record a specific variable\n"
-        "  --input-file [FILE]              read input from a CSV file\n"
+        "  --input-file [FILE]              read input from a CSV or binary file\n"
+        "  --stream-input                   stream the input file instead of loading it\n"
+        "  --convert-input-file [FILE]      convert the input file to binary and exit\n"
         "  --output-file [FILE]             write output to a CSV file\n"
         "  --log-fmi-calls                  log FMI calls\n"
         "  --fmi-log-file [FILE]            set the FMI log file\n"
@@ -122,6 +127,13 @@ void printUsage() {
         "  --record-intermediate-values     record outputs in intermediate update\n"
         "  --initial-fmu-state-file [FILE]  file to read the serialized FMU state\n"
         "  --final-fmu-state-file [FILE]    file to save the serialized FMU state\n"
+        "  --fmu-state-base-file [FILE]     save the final FMU state as a delta to the state in FILE\n"
+        "  --checkpoint-interval [VALUE]    save a checkpoint every VALUE seconds of simulation time\n"
+        "  --checkpoint-file [FILE]         save checkpoints alternately to FILE.0 and FILE.1\n"
+        "  --resume-from-checkpoint         continue the simulation from the most recent checkpoint\n"
+        "  --ensemble [N]                   simulate N members (scalar start values may be lists of N values)\n"
+        "  --system                         simulate the FMUs of the system description [FMU] in parallel\n"
+        "  --master [gauss-seidel|jacobi]   order in which the FMUs of a system step\n"
         "\n"
         "Example:\n"
         "\n"
@@ -245,6 +257,73 @@ TERMINATE:
     return status;
 }
 
+char* ensembleStartValue(const char* literal, size_t nMembers, size_t member) {
+
+    const char* delimiters = " \t\r\n";
+
+    size_t nValues = 0;
+    const char* value = NULL;
+    size_t length = 0;
+
+    for (const char* p = literal + strspn(literal, delimiters); *p; p += strspn(p, delimiters)) {
+
+        const size_t n = strcspn(p, delimiters);
+
+        if (nValues == 0 || nValues == member) {
+            value = p;
+            length = n;
+        }
+
+        nValues++;
+        p += n;
+    }
+
+    if (nValues != 1 && nValues != nMembers) {
+        return NULL;
+    }
+
+    char* copy = (char*)calloc(length + 1, sizeof(char));
+
+    if (copy) {
+        memcpy(copy, value, length);
+    }
+
+    return copy;
+}
+
+// get the start time, stop time and output interval from the options or the default experiment
+static void getExperiment(const FMIModelDescription* modelDescription, const char* startTimeLiteral, const char* stopTimeLiteral,
+    double* startTime, double* stopTime, double* outputInterval) {
+
+    if (!startTimeLiteral) {
+        if (modelDescription->defaultExperiment && modelDescription->defaultExperiment->startTime) {
+            startTimeLiteral = modelDescription->defaultExperiment->startTime;
+        } else {
+            startTimeLiteral = "0";
+        }
+    }
+
+    *startTime = strtod(startTimeLiteral, NULL);
+
+    if (!stopTimeLiteral) {
+        if (modelDescription->defaultExperiment && modelDescription->defaultExperiment->stopTime) {
+            stopTimeLiteral = modelDescription->defaultExperiment->stopTime;
+        } else {
+            stopTimeLiteral = "1";
+        }
+    }
+
+    *stopTime = strtod(stopTimeLiteral, NULL);
+
+    if (*outputInterval == 0) {
+        if (modelDescription->defaultExperiment && modelDescription->defaultExperiment->stepSize) {
+            *outputInterval = strtod(modelDescription->defaultExperiment->stepSize, NULL);
+        } else {
+            *outputInterval = (*stopTime - *startTime) / 500;
+        }
+    }
+}
+
 static FMIStatus FMIRealloc(void** ptr, size_t new_size) {
 
     void* old_ptr = *ptr;
@@ -275,10 +354,19 @@ int main(int argc, const char* argv[]) {
     FMIInterfaceType interfaceType = -1;
 
     const char* inputFile = NULL;
+    bool streamInput = false;
+    const char* convertInputFile = NULL;
     const char* outputFile = NULL;
     const char* fmiLogFile = NULL;
     const char* initialFMUStateFile = NULL;
     const char* finalFMUStateFile = NULL;
+    const char* fmuStateBaseFile = NULL;
+    double checkpointInterval = 0;
+    const char* checkpointFile = "checkpoint";
+    bool resumeFromCheckpoint = false;
+    size_t nMembers = 0;
+    bool simulateSystemDescription = false;
+    FMIMasterAlgorithm masterAlgorithm = FMIGaussSeidel;
 
     const char* startTimeLiteral = NULL;
     const char* stopTimeLiteral = NULL;
@@ -288,14 +376,18 @@ int main(int argc, const char* argv[]) {
     size_t nStartValues = 0;
     const char** startNames = NULL;
     const char** startValues = NULL;
+    char** memberStartValues = NULL;
 
     size_t nOutputVariableNames = 0;
     const char** outputVariableNames = NULL;
 
     const char* solver = "euler";
 
+    FMIModelDescription* modelDescription = NULL;
+    FMISystem* system = NULL;
     FMIInstance* S = NULL;
     FMIRecorder* result = NULL;
+    FMUStaticInput* input = NULL;
     const char* unzipdir = NULL;
     FMIStatus status = FMIFatal;
     bool earlyReturnAllowed = false;
@@ -314,6 +406,8 @@ int main(int argc, const char* argv[]) {
                 interfaceType = FMICoSimulation;
             } else if (!strcmp(argv[i + 1], "me")) {
                 interfaceType = FMIModelExchange;
+            } else if (!strcmp(argv[i + 1], "se")) {
+                interfaceType = FMIScheduledExecution;
             } else {
                 printf(PROGNAME ": unrecognized interface type '%s'\n", argv[i + 1]);
                 printf("Try '" PROGNAME " --help' for more information.\n");
@@ -332,6 +426,10 @@ int main(int argc, const char* argv[]) {
             nOutputVariableNames++;
         } else if (!strcmp(v, "--input-file")) {
             inputFile = argv[++i];
+        } else if (!strcmp(v, "--stream-input")) {
+            streamInput = true;
+        } else if (!strcmp(v, "--convert-input-file")) {
+            convertInputFile = argv[++i];
         } else if (!strcmp(v, "--output-file")) {
             outputFile = argv[++i];
         } else if (!strcmp(v, "--fmi-log-file")) {
@@ -359,6 +457,33 @@ int main(int argc, const char* argv[]) {
             initialFMUStateFile = argv[++i];
         } else if (!strcmp(v, "--final-fmu-state-file")) {
             finalFMUStateFile = argv[++i];
+        } else if (!strcmp(v, "--fmu-state-base-file")) {
+            fmuStateBaseFile = argv[++i];
+        } else if (!strcmp(v, "--checkpoint-interval")) {
+            char* error;
+            checkpointInterval = strtod(argv[++i], &error);
+        } else if (!strcmp(v, "--checkpoint-file")) {
+            checkpointFile = argv[++i];
+        } else if (!strcmp(v, "--resume-from-checkpoint")) {
+            resumeFromCheckpoint = true;
+        } else if (!strcmp(v, "--ensemble")) {
+            nMembers = strtoul(argv[++i], NULL, 10);
+            if (nMembers == 0) {
+                printf(PROGNAME ": the ensemble size must be a positive integer\n");
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(v, "--system")) {
+            simulateSystemDescription = true;
+        } else if (!strcmp(v, "--master")) {
+            const char* master = argv[++i];
+            if (!strcmp(master, "gauss-seidel")) {
+                masterAlgorithm = FMIGaussSeidel;
+            } else if (!strcmp(master, "jacobi")) {
+                masterAlgorithm = FMIJacobi;
+            } else {
+                printf(PROGNAME ": the master algorithm must be gauss-seidel or jacobi\n");
+                return EXIT_FAILURE;
+            }
         } else {
             printf(PROGNAME ": unrecognized option '%s'\n", v);
             printf("Try '" PROGNAME " --help' for more information.\n");
@@ -376,6 +501,41 @@ int main(int argc, const char* argv[]) {
         }
     }
 
+    if (!outputFile) {
+        outputFile = "result.csv";
+    }
+
+    if (simulateSystemDescription) {
+
+        if (interfaceType == FMIModelExchange || interfaceType == FMIScheduledExecution || nStartValues > 0 || nOutputVariableNames > 0 || inputFile || convertInputFile || nMembers > 0 ||
+            initialFMUStateFile || finalFMUStateFile || checkpointInterval > 0 || resumeFromCheckpoint || earlyReturnAllowed || recordIntermediateValues) {
+            printf("Systems can only be simulated with the options --tolerance, --start-time, --stop-time, --output-interval, --output-file, --master, --log-fmi-calls and --fmi-log-file.\n");
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        system = FMIReadSystem(fmuPath, logMessage, logFMICalls ? logFunctionCall : NULL);
+
+        if (!system) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        FMISimulationSettings settings;
+
+        memset(&settings, 0, sizeof(settings));
+
+        // the FMUs use the default experiment of the first FMU
+        getExperiment(system->components[0].modelDescription, startTimeLiteral, stopTimeLiteral, &settings.startTime, &settings.stopTime, &outputInterval);
+
+        settings.tolerance      = tolerance;
+        settings.outputInterval = outputInterval;
+
+        status = simulateSystem(system, outputFile, &settings, masterAlgorithm);
+
+        goto TERMINATE;
+    }
+
     unzipdir = FMICreateTemporaryDirectory();
     
     if (!unzipdir) {
@@ -396,7 +556,7 @@ int main(int argc, const char* argv[]) {
         return EXIT_FAILURE;
     }
 
-    FMIModelDescription* modelDescription = FMIReadModelDescription(modelDescriptionPath);
+    modelDescription = FMIReadModelDescription(modelDescriptionPath);
 
     if (!modelDescription) {
         printf("Failed to read model description.\n");
@@ -426,6 +586,9 @@ int main(int argc, const char* argv[]) {
         } else if (interfaceType == FMICoSimulation && modelDescription->coSimulation) {
             interfaceType = FMICoSimulation;
             modelIdentifier = modelDescription->coSimulation->modelIdentifier;
+        } else if (interfaceType == FMIScheduledExecution && modelDescription->scheduledExecution) {
+            interfaceType = FMIScheduledExecution;
+            modelIdentifier = modelDescription->scheduledExecution->modelIdentifier;
         } else {
             printf("Selected interface type is not supported by the FMU.\n");
             return EXIT_FAILURE;
@@ -433,6 +596,21 @@ int main(int argc, const char* argv[]) {
 
     }
 
+    if (modelDescription->fmiVersion == FMIVersion1 && (checkpointInterval > 0 || resumeFromCheckpoint)) {
+        printf("Checkpoints require FMI 2.0 or later.\n");
+        goto TERMINATE;
+    }
+
+    if (nMembers > 0 && (checkpointInterval > 0 || resumeFromCheckpoint || finalFMUStateFile || streamInput)) {
+        printf("Ensembles cannot be combined with checkpoints, final FMU states or streamed input.\n");
+        goto TERMINATE;
+    }
+
+    if (interfaceType == FMIScheduledExecution && (inputFile || nMembers > 0 || initialFMUStateFile || finalFMUStateFile || checkpointInterval > 0 || resumeFromCheckpoint)) {
+        printf("Scheduled Execution cannot be combined with input files, ensembles, FMU states or checkpoints.\n");
+        goto TERMINATE;
+    }
+
     FMIModelVariable** startVariables = calloc(nStartValues, sizeof(FMIModelVariable*));
 
     for (size_t i = 0; i < nStartValues; i++) {
@@ -452,6 +630,31 @@ int main(int argc, const char* argv[]) {
         }
     }
 
+    if (inputFile) {
+
+        if (streamInput && !convertInputFile) {
+            input = FMIOpenInputStream(modelDescription, inputFile);
+        } else {
+            input = FMIReadInput(modelDescription, inputFile);
+        }
+
+        if (!input) {
+            printf("Failed to read input file %s.\n", inputFile);
+            goto TERMINATE;
+        }
+    }
+
+    if (convertInputFile) {
+
+        if (!input) {
+            printf("Missing option --input-file.\n");
+            goto TERMINATE;
+        }
+
+        status = FMIWriteBinaryInput(input, convertInputFile);
+        goto TERMINATE;
+    }
+
     FMIPlatformBinaryPath(unzipdir, modelIdentifier, modelDescription->fmiVersion, platformBinaryPath, FMI_PATH_MAX);
 
     S = FMICreateInstance("instance1", platformBinaryPath, logMessage, logFMICalls ? logFunctionCall : NULL);
@@ -479,17 +682,15 @@ int main(int argc, const char* argv[]) {
         }
     }
 
-    if (!outputFile) {
-        outputFile = "result.csv";
-    }
-
-    result = FMICreateRecorder(nOutputVariables, outputVariables, outputFile);
+    result = FMICreateRecorder(nOutputVariables, outputVariables, outputFile, resumeFromCheckpoint);
 
     if (!result) {
         printf("Failed to open result file %s for writing.\n", outputFile);
         goto TERMINATE;
     }
 
+    result->ensemble = nMembers > 0;
+
     char resourcePath[FMI_PATH_MAX] = "";
 
 #ifdef _WIN32
@@ -498,39 +699,9 @@ int main(int argc, const char* argv[]) {
     snprintf(resourcePath, FMI_PATH_MAX, "%s/resources/", unzipdir);
 #endif
     
-    FMUStaticInput* input = NULL;
-    
-    if (inputFile) {
-        input = FMIReadInput(modelDescription, inputFile);
-    }
+    double startTime, stopTime;
 
-    if (!startTimeLiteral) {
-        if (modelDescription->defaultExperiment && modelDescription->defaultExperiment->startTime) {
-            startTimeLiteral = modelDescription->defaultExperiment->startTime;
-        } else {
-            startTimeLiteral = "0";
-        }
-    }
-
-    const double startTime = strtod(startTimeLiteral, NULL);
-
-    if (!stopTimeLiteral) {
-        if (modelDescription->defaultExperiment && modelDescription->defaultExperiment->stopTime) {
-            stopTimeLiteral = modelDescription->defaultExperiment->stopTime;
-        } else {
-            stopTimeLiteral = "1";
-        }
-    }
-
-    const double stopTime = strtod(stopTimeLiteral, NULL);
-
-    if (outputInterval == 0) {
-        if (modelDescription->defaultExperiment && modelDescription->defaultExperiment->stepSize) {
-            outputInterval = strtod(modelDescription->defaultExperiment->stepSize, NULL);
-        } else {
-            outputInterval = (stopTime - startTime) / 500;
-        }
-    }
+    getExperiment(modelDescription, startTimeLiteral, stopTimeLiteral, &startTime, &stopTime, &outputInterval);
 
     FMISimulationSettings settings;
 
@@ -546,6 +717,10 @@ int main(int argc, const char* argv[]) {
     settings.recordIntermediateValues = recordIntermediateValues;
     settings.initialFMUStateFile      = initialFMUStateFile;
     settings.finalFMUStateFile        = finalFMUStateFile;
+    settings.fmuStateBaseFile         = fmuStateBaseFile;
+    settings.checkpointInterval       = checkpointInterval;
+    settings.checkpointFile           = checkpointFile;
+    settings.resumeFromCheckpoint     = resumeFromCheckpoint;
 
     if (!strcmp("euler", solver)) {
         settings.solverCreate = FMIEulerCreate;
@@ -562,41 +737,107 @@ int main(int argc, const char* argv[]) {
         return FMIError;
     }
 
-    if (modelDescription->fmiVersion == FMIVersion1) {
+    // simulate all members at once if the FMU supports it
+    if (nMembers > 0 && modelDescription->fmiVersion == FMIVersion3 && interfaceType == FMICoSimulation &&
+        !input && !initialFMUStateFile && !earlyReturnAllowed && !eventModeUsed && !recordIntermediateValues) {
 
-        if (interfaceType == FMICoSimulation) {
+        bool simulated;
 
-            char fmuLocation[FMI_PATH_MAX] = "";
-            CALL(FMIPathToURI(unzipdir, fmuLocation, FMI_PATH_MAX));
+        status = simulateFMI3Ensemble(S, modelDescription, result, &settings, nMembers, &simulated);
 
-            status = simulateFMI1CS(S, modelDescription, fmuLocation, result, input, &settings);
-        } else {
-            status = simulateFMI1ME(S, modelDescription, result, input, &settings);
+        if (simulated || status > FMIWarning) {
+            goto TERMINATE;
         }
+    }
 
-    } else if (modelDescription->fmiVersion == FMIVersion2) {
+    if (nMembers > 0) {
 
-        char resourceURI[FMI_PATH_MAX] = "";
-        CALL(FMIPathToURI(resourcePath, resourceURI, FMI_PATH_MAX));
+        memberStartValues = (char**)calloc(nStartValues, sizeof(char*));
 
-        if (interfaceType == FMICoSimulation) {
-            status = simulateFMI2CS(S, modelDescription, resourceURI, result, input, &settings);
-        } else {
-            status = simulateFMI2ME(S, modelDescription, resourceURI, result, input, &settings);
+        if (!memberStartValues) {
+            goto TERMINATE;
         }
 
-    } else {
+        settings.startValues = (const char**)memberStartValues;
+    }
+
+    // the members of an ensemble are simulated one after the other with the same instance and recorder
+    for (size_t member = 0; member < (nMembers > 0 ? nMembers : 1); member++) {
+
+        if (nMembers > 0) {
+
+            for (size_t i = 0; i < nStartValues; i++) {
+
+                const FMIModelVariable* variable = startVariables[i];
+
+                free(memberStartValues[i]);
+
+                if (variable->nDimensions > 0 || variable->type == FMIStringType || variable->type == FMIBinaryType) {
+                    memberStartValues[i] = strdup(startValues[i]);
+                } else {
+                    memberStartValues[i] = ensembleStartValue(startValues[i], nMembers, member);
+                }
+
+                if (!memberStartValues[i]) {
+                    printf("The start value of %s must be a single value or a list of %zu values.\n", variable->name, nMembers);
+                    status = FMIError;
+                    goto TERMINATE;
+                }
+            }
+
+            result->member = member;
+
+            if (input) {
+                FMIResetAppliedInput(input);
+            }
+        }
+
+        if (modelDescription->fmiVersion == FMIVersion1) {
+
+            if (interfaceType == FMICoSimulation) {
+
+                char fmuLocation[FMI_PATH_MAX] = "";
+                CALL(FMIPathToURI(unzipdir, fmuLocation, FMI_PATH_MAX));
+
+                status = simulateFMI1CS(S, modelDescription, fmuLocation, result, input, &settings);
+            } else {
+                status = simulateFMI1ME(S, modelDescription, result, input, &settings);
+            }
+
+        } else if (modelDescription->fmiVersion == FMIVersion2) {
+
+            char resourceURI[FMI_PATH_MAX] = "";
+            CALL(FMIPathToURI(resourcePath, resourceURI, FMI_PATH_MAX));
+
+            if (interfaceType == FMICoSimulation) {
+                status = simulateFMI2CS(S, modelDescription, resourceURI, result, input, &settings);
+            } else {
+                status = simulateFMI2ME(S, modelDescription, resourceURI, result, input, &settings);
+            }
 
-        if (interfaceType == FMICoSimulation) {
-            status = simulateFMI3CS(S, modelDescription, resourcePath, result, input, &settings);
         } else {
-            status = simulateFMI3ME(S, modelDescription, resourcePath, result, input, &settings);
+
+            if (interfaceType == FMICoSimulation) {
+                status = simulateFMI3CS(S, modelDescription, resourcePath, result, input, &settings);
+            } else if (interfaceType == FMIScheduledExecution) {
+                status = simulateFMI3SE(S, modelDescription, resourcePath, result, &settings);
+            } else {
+                status = simulateFMI3ME(S, modelDescription, resourcePath, result, input, &settings);
+            }
+
         }
 
+        if (status > FMIWarning) {
+            goto TERMINATE;
+        }
     }
 
 TERMINATE:
 
+    if (input) {
+        FMIFreeInput(input);
+    }
+
     if (result) {
         FMIFreeRecorder(result);
     }
@@ -605,6 +846,10 @@ TERMINATE:
         FMIFreeModelDescription(modelDescription);
     }
 
+    if (system) {
+        FMIFreeSystem(system);
+    }
+
     if (S) {
         FMIFreeInstance(S);
     }
@@ -621,6 +866,13 @@ TERMINATE:
         fclose(s_fmiLogFile);
     }
 
+    if (memberStartValues) {
+        for (size_t i = 0; i < nStartValues; i++) {
+            free(memberStartValues[i]);
+        }
+        free(memberStartValues);
+    }
+
     free(startNames);
     free(startValues);
     free(outputVariableNames);
@@ -15,6 +15,10 @@ typedef struct {
     double outputInterval;
     const char* initialFMUStateFile;
     const char* finalFMUStateFile;
+    const char* fmuStateBaseFile;
+    double checkpointInterval;
+    const char* checkpointFile;
+    bool resumeFromCheckpoint;
 
     // Co-Simulation
     bool earlyReturnAllowed;
@@ -30,3 +34,6 @@ typedef struct {
 } FMISimulationSettings;
 
 FMIStatus applyStartValues(FMIInstance* S, const FMISimulationSettings* settings);
+
+// select the start value of an ensemble member from a whitespace separated list of one or nMembers values
+char* ensembleStartValue(const char* literal, size_t nMembers, size_t member);
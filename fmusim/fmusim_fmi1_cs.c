@@ -9,7 +9,7 @@ FMIStatus simulateFMI1CS(
     const FMIModelDescription* modelDescription,
     const char* fmuLocation,
     FMIRecorder* result,
-    const FMUStaticInput * input,
+    FMUStaticInput* input,
     const FMISimulationSettings * settings) {
 
     FMIStatus status = FMIOK;
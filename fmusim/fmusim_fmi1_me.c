@@ -11,7 +11,7 @@ FMIStatus simulateFMI1ME(
     FMIInstance* S, 
     const FMIModelDescription* modelDescription, 
     FMIRecorder* result,
-    const FMUStaticInput * input,
+    FMUStaticInput* input,
     const FMISimulationSettings* settings) {
 
     FMIStatus status = FMIOK;
@@ -82,7 +82,7 @@ FMIStatus simulateFMI1ME(
 
         nextCommunicationPoint = nextRegularPoint;
 
-        nextInputEventTime = FMINextInputEvent(input, time);
+        CALL(FMINextInputEvent(input, time, &nextInputEventTime));
 
         inputEvent = nextCommunicationPoint >= nextInputEventTime;
 
@@ -11,5 +11,5 @@ FMIStatus simulateFMI1ME(
     FMIInstance* S,
     const FMIModelDescription* modelDescription,
     FMIRecorder* result,
-    const FMUStaticInput* input,
+    FMUStaticInput* input,
     const FMISimulationSettings* settings);
@@ -1,4 +1,7 @@
+#include <math.h>
+
 #include "FMIUtil.h"
+#include "FMICheckpoint.h"
 
 #include "fmusim_fmi2_cs.h"
 
@@ -11,11 +14,17 @@ FMIStatus simulateFMI2CS(
     const FMIModelDescription* modelDescription,
     const char* resourceURI,
     FMIRecorder* result,
-    const FMUStaticInput * input,
+    FMUStaticInput* input,
     const FMISimulationSettings * settings) {
 
     FMIStatus status = FMIOK;
 
+    FMICheckpoint checkpoint = {
+        .time               = settings->startTime,
+        .nextEventTime      = INFINITY,
+        .nextCheckpointTime = settings->startTime + settings->checkpointInterval
+    };
+
     CALL(FMI2Instantiate(S,
         resourceURI,                          // fmuResourceLocation
         fmi2CoSimulation,                     // fmuType
@@ -28,19 +37,27 @@ FMIStatus simulateFMI2CS(
         CALL(FMIRestoreFMUStateFromFile(S, settings->initialFMUStateFile));
     }
 
-    CALL(applyStartValues(S, settings));
-    CALL(FMIApplyInput(S, input, settings->startTime, true, true, false));
+    if (settings->resumeFromCheckpoint) {
+        CALL(FMIRestoreCheckpoint(S, settings, &checkpoint, result, input));
+    } else {
+        CALL(applyStartValues(S, settings));
+        CALL(FMIApplyInput(S, input, settings->startTime, true, true, false));
+    }
 
-    if (!settings->initialFMUStateFile) {
+    if (!settings->initialFMUStateFile && !settings->resumeFromCheckpoint) {
         CALL(FMI2SetupExperiment(S, settings->tolerance > 0, settings->tolerance, settings->startTime, fmi2False, 0));
         CALL(FMI2EnterInitializationMode(S));
         CALL(FMI2ExitInitializationMode(S));
     }
 
-    for (unsigned long step = 0;; step++) {
+    for (unsigned long step = (unsigned long)checkpoint.nSteps;; step++) {
         
         const fmi2Real time = settings->startTime + step * settings->outputInterval;
 
+        if (FMICheckpointDue(settings, &checkpoint, time)) {
+            CALL(FMISaveCheckpoint(S, settings, &checkpoint, time, step, INFINITY, result, input));
+        }
+
         CALL(FMISample(S, time, result));
 
         CALL(FMIApplyInput(S, input, time, true, true, false));
@@ -74,7 +91,7 @@ FMIStatus simulateFMI2CS(
     }
 
     if (settings->finalFMUStateFile) {
-        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile));
+        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile, settings->fmuStateBaseFile));
     }
 
 TERMINATE:
@@ -2,6 +2,7 @@
 #include <math.h>
 
 #include "FMIUtil.h"
+#include "FMICheckpoint.h"
 
 #include "fmusim_fmi2_me.h"
 
@@ -14,7 +15,7 @@ FMIStatus simulateFMI2ME(
     const FMIModelDescription* modelDescription, 
     const char* resourceURI,
     FMIRecorder* result,
-    const FMUStaticInput * input,
+    FMUStaticInput* input,
     const FMISimulationSettings* settings) {
 
     FMIStatus status = FMIOK;
@@ -45,6 +46,12 @@ FMIStatus simulateFMI2ME(
         .nextEventTime                     = INFINITY
     };
 
+    FMICheckpoint checkpoint = {
+        .time               = settings->startTime,
+        .nextEventTime      = INFINITY,
+        .nextCheckpointTime = settings->startTime + settings->checkpointInterval
+    };
+
     CALL(FMI2Instantiate(S,
         resourceURI,                          // fmuResourceLocation
         fmi2ModelExchange,                    // fmuType
@@ -59,15 +66,25 @@ FMIStatus simulateFMI2ME(
         CALL(FMIRestoreFMUStateFromFile(S, settings->initialFMUStateFile));
     }
 
-    // set start values
-    CALL(applyStartValues(S, settings));
-    CALL(FMIApplyInput(S, input, time,
-        true,  // discrete
-        true,  // continous
-        false  // after event
-    ));
+    if (settings->resumeFromCheckpoint) {
+
+        CALL(FMIRestoreCheckpoint(S, settings, &checkpoint, result, input));
 
-    if (!settings->initialFMUStateFile) {
+        time = checkpoint.time;
+        eventInfo.nextEventTime = checkpoint.nextEventTime;
+
+    } else {
+
+        // set start values
+        CALL(applyStartValues(S, settings));
+        CALL(FMIApplyInput(S, input, time,
+            true,  // discrete
+            true,  // continous
+            false  // after event
+        ));
+    }
+
+    if (!settings->initialFMUStateFile && !settings->resumeFromCheckpoint) {
 
         // initialize
         CALL(FMI2SetupExperiment(S, settings->tolerance > 0, settings->tolerance, time, fmi2False, 0));
@@ -98,6 +115,8 @@ FMIStatus simulateFMI2ME(
         CALL(FMI2EnterContinuousTimeMode(S));
     }
 
+    // the solver history is not part of the checkpoint, so a resumed simulation starts with a new solver
+    // and its results can differ from those of an uninterrupted simulation (e.g. with CVode)
     solver = settings->solverCreate(S, modelDescription, input, settings->tolerance, time);
 
     if (!solver) {
@@ -105,10 +124,15 @@ FMIStatus simulateFMI2ME(
         goto TERMINATE;
     }
 
-    nSteps = 0;
+    nSteps = checkpoint.nSteps;
 
     for (;;) {
 
+        if (FMICheckpointDue(settings, &checkpoint, time)) {
+
+            CALL(FMISaveCheckpoint(S, settings, &checkpoint, time, nSteps, eventInfo.nextEventTime, result, input));
+        }
+
         CALL(FMISample(S, time, result));
 
         if (time >= settings->stopTime) {
@@ -119,7 +143,7 @@ FMIStatus simulateFMI2ME(
 
         nextCommunicationPoint = nextRegularPoint;
 
-        nextInputEventTime = FMINextInputEvent(input, time);
+        CALL(FMINextInputEvent(input, time, &nextInputEventTime));
 
         inputEvent = nextCommunicationPoint >= nextInputEventTime;
 
@@ -193,7 +217,7 @@ FMIStatus simulateFMI2ME(
     }
 
     if (settings->finalFMUStateFile) {
-        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile));
+        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile, settings->fmuStateBaseFile));
     }
 
 TERMINATE:
@@ -12,5 +12,5 @@ FMIStatus simulateFMI2ME(
     const FMIModelDescription* modelDescription,
     const char* resourceURI,
     FMIRecorder* result,
-    const FMUStaticInput* input,
+    FMUStaticInput* input,
     const FMISimulationSettings* settings);
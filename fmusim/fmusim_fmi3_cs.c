@@ -2,6 +2,7 @@
 #include <math.h>
 
 #include "FMIUtil.h"
+#include "FMICheckpoint.h"
 
 #include "fmusim_fmi3_cs.h"
 
@@ -34,7 +35,7 @@ FMIStatus simulateFMI3CS(FMIInstance* S,
     const FMIModelDescription * modelDescription,
     const char* resourcePath,
     FMIRecorder* recorder,
-    const FMUStaticInput * input,
+    FMUStaticInput* input,
     const FMISimulationSettings * settings) {
 
     FMIStatus status = FMIOK;
@@ -55,6 +56,12 @@ FMIStatus simulateFMI3CS(FMIInstance* S,
     fmi3Boolean nextEventTimeDefined = fmi3False;
     fmi3Float64 nextEventTime = INFINITY;
 
+    FMICheckpoint checkpoint = {
+        .time               = settings->startTime,
+        .nextEventTime      = INFINITY,
+        .nextCheckpointTime = settings->startTime + settings->checkpointInterval
+    };
+
     fmi3ValueReference* requiredIntermediateVariables = NULL;
     size_t nRequiredIntermediateVariables = 0;
     fmi3IntermediateUpdateCallback intermediateUpdate = NULL;
@@ -96,10 +103,19 @@ FMIStatus simulateFMI3CS(FMIInstance* S,
         CALL(FMIRestoreFMUStateFromFile(S, settings->initialFMUStateFile));
     }
 
-    CALL(applyStartValues(S, settings));
-    CALL(FMIApplyInput(S, input, settings->startTime, true, true, false));
+    if (settings->resumeFromCheckpoint) {
+
+        CALL(FMIRestoreCheckpoint(S, settings, &checkpoint, recorder, input));
 
-    if (!settings->initialFMUStateFile) {
+        time = checkpoint.time;
+        nextEventTime = checkpoint.nextEventTime;
+
+    } else {
+        CALL(applyStartValues(S, settings));
+        CALL(FMIApplyInput(S, input, settings->startTime, true, true, false));
+    }
+
+    if (!settings->initialFMUStateFile && !settings->resumeFromCheckpoint) {
 
         CALL(FMI3EnterInitializationMode(S, settings->tolerance > 0, settings->tolerance, settings->startTime, fmi3False, 0));
         CALL(FMI3ExitInitializationMode(S));
@@ -130,10 +146,14 @@ FMIStatus simulateFMI3CS(FMIInstance* S,
         }
     }
 
-    size_t nSteps = 0;
+    size_t nSteps = checkpoint.nSteps;
 
     for (;;) {
 
+        if (FMICheckpointDue(settings, &checkpoint, time)) {
+            CALL(FMISaveCheckpoint(S, settings, &checkpoint, time, nSteps, nextEventTime, recorder, input));
+        }
+
         CALL(FMISample(S, time, recorder));
 
         if (time >= settings->stopTime) {
@@ -144,7 +164,7 @@ FMIStatus simulateFMI3CS(FMIInstance* S,
 
         nextCommunicationPoint = nextRegularPoint;
 
-        nextInputEventTime = FMINextInputEvent(input, time);
+        CALL(FMINextInputEvent(input, time, &nextInputEventTime));
 
         inputEvent = nextCommunicationPoint > nextInputEventTime;
 
@@ -228,7 +248,7 @@ FMIStatus simulateFMI3CS(FMIInstance* S,
     }
 
     if (settings->finalFMUStateFile) {
-        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile));
+        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile, settings->fmuStateBaseFile));
     }
 
 TERMINATE:
@@ -0,0 +1,246 @@
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include "FMIUtil.h"
+#include "refEnsembleFunctions.h"
+
+#include "fmusim_fmi3_ensemble.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIOK) goto TERMINATE; } while (0)
+
+#define LOG_CALL(f, m, ...) \
+do { \
+    if (S->logFunctionCall) { \
+        FMIClearLogMessageBuffer(S); \
+        FMIAppendToLogMessageBuffer(S, #f "(" m ")", __VA_ARGS__); \
+        S->logFunctionCall(S, status, S->logMessageBuffer); \
+    } \
+} while (0)
+
+
+static void* loadSymbol(FMIInstance* S, const char* name) {
+#ifdef _WIN32
+    return (void*)GetProcAddress(S->libraryHandle, name);
+#else
+    return dlsym(S->libraryHandle, name);
+#endif
+}
+
+static bool isScalarFloat64(const FMIModelVariable* variable) {
+    return variable->nDimensions == 0 && (variable->type == FMIFloat64Type || variable->type == FMIDiscreteFloat64Type);
+}
+
+FMIStatus simulateFMI3Ensemble(
+    FMIInstance* S,
+    const FMIModelDescription* modelDescription,
+    FMIRecorder* result,
+    const FMISimulationSettings* settings,
+    size_t nMembers,
+    bool* simulated) {
+
+    FMIStatus status = FMIOK;
+
+    refEnsemble ensemble = NULL;
+
+    const size_t nVariables = result->nVariables;
+
+    double* values = NULL;
+    double* row = NULL;
+
+    // sampled values of all members in the order [sample][variable][member]
+    double* times = NULL;
+    double* samples = NULL;
+    size_t nSamples = 0;
+    size_t capacity = 0;
+
+    *simulated = false;
+
+    refInstantiateEnsembleTYPE* instantiateEnsemble = (refInstantiateEnsembleTYPE*)loadSymbol(S, "refInstantiateEnsemble");
+    refFreeEnsembleTYPE*        freeEnsemble        = (refFreeEnsembleTYPE*)loadSymbol(S, "refFreeEnsemble");
+    refGetEnsembleFloat64TYPE*  getEnsembleFloat64  = (refGetEnsembleFloat64TYPE*)loadSymbol(S, "refGetEnsembleFloat64");
+    refSetEnsembleFloat64TYPE*  setEnsembleFloat64  = (refSetEnsembleFloat64TYPE*)loadSymbol(S, "refSetEnsembleFloat64");
+    refDoStepEnsembleTYPE*      doStepEnsemble      = (refDoStepEnsembleTYPE*)loadSymbol(S, "refDoStepEnsemble");
+
+    if (!instantiateEnsemble || !freeEnsemble || !getEnsembleFloat64 || !setEnsembleFloat64 || !doStepEnsemble) {
+        return FMIOK;
+    }
+
+    for (size_t i = 0; i < settings->nStartValues; i++) {
+        if (!isScalarFloat64(settings->startVariables[i])) {
+            return FMIOK;
+        }
+    }
+
+    for (size_t i = 0; i < nVariables; i++) {
+        if (!isScalarFloat64(result->variables[i])) {
+            return FMIOK;
+        }
+    }
+
+    ensemble = instantiateEnsemble(modelDescription->instantiationToken, nMembers, settings->startTime);
+
+    status = ensemble ? FMIOK : FMIError;
+
+    LOG_CALL(refInstantiateEnsemble, "instantiationToken=\"%s\", nMembers=%zu, startTime=%.16g",
+        modelDescription->instantiationToken, nMembers, settings->startTime);
+
+    if (!ensemble) {
+        printf("Failed to instantiate the ensemble.\n");
+        goto TERMINATE;
+    }
+
+    values = (double*)calloc(nMembers, sizeof(double));
+    row = (double*)calloc(nVariables + 1, sizeof(double));
+
+    if (!values || !row) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // the variables that are not part of the ensemble are simulated with individual instances
+    for (size_t i = 0; i < settings->nStartValues; i++) {
+        if (getEnsembleFloat64(ensemble, settings->startVariables[i]->valueReference, values, nMembers) != fmi3OK) {
+            goto TERMINATE;
+        }
+    }
+
+    for (size_t i = 0; i < nVariables; i++) {
+        if (getEnsembleFloat64(ensemble, result->variables[i]->valueReference, values, nMembers) != fmi3OK) {
+            goto TERMINATE;
+        }
+    }
+
+    *simulated = true;
+
+    for (size_t i = 0; i < settings->nStartValues; i++) {
+
+        const FMIModelVariable* variable = settings->startVariables[i];
+
+        for (size_t member = 0; member < nMembers; member++) {
+
+            char* literal = ensembleStartValue(settings->startValues[i], nMembers, member);
+
+            if (!literal) {
+                printf("The start value of %s must be a single value or a list of %zu values.\n", variable->name, nMembers);
+                status = FMIError;
+                goto TERMINATE;
+            }
+
+            status = FMIParseStartValues(variable->type, literal, 1, &values[member]);
+
+            free(literal);
+
+            if (status > FMIOK) {
+                goto TERMINATE;
+            }
+        }
+
+        status = (FMIStatus)setEnsembleFloat64(ensemble, variable->valueReference, values, nMembers);
+
+        LOG_CALL(refSetEnsembleFloat64, "valueReference=%u, values=..., nValues=%zu", variable->valueReference, nMembers);
+
+        if (status > FMIOK) {
+            goto TERMINATE;
+        }
+    }
+
+    double time = settings->startTime;
+    size_t nSteps = 0;
+
+    // same communication points as simulateFMI3CS()
+    for (;;) {
+
+        if (nSamples == capacity) {
+
+            capacity = capacity ? 2 * capacity : 1024;
+
+            double* t = (double*)realloc(times, capacity * sizeof(double));
+
+            if (t) {
+                times = t;
+            }
+
+            double* s = (double*)realloc(samples, (capacity * nVariables * nMembers + 1) * sizeof(double));
+
+            if (s) {
+                samples = s;
+            }
+
+            if (!t || !s) {
+                printf("Failed to allocate buffer.\n");
+                status = FMIError;
+                goto TERMINATE;
+            }
+        }
+
+        times[nSamples] = time;
+
+        for (size_t i = 0; i < nVariables; i++) {
+
+            double* v = &samples[(nSamples * nVariables + i) * nMembers];
+
+            status = (FMIStatus)getEnsembleFloat64(ensemble, result->variables[i]->valueReference, v, nMembers);
+
+            if (status > FMIOK) {
+                goto TERMINATE;
+            }
+        }
+
+        nSamples++;
+
+        if (time >= settings->stopTime) {
+            break;
+        }
+
+        const double nextCommunicationPoint = settings->startTime + (nSteps + 1) * settings->outputInterval;
+
+        status = (FMIStatus)doStepEnsemble(ensemble, time, nextCommunicationPoint - time);
+
+        LOG_CALL(refDoStepEnsemble, "currentCommunicationPoint=%.16g, communicationStepSize=%.16g", time, nextCommunicationPoint - time);
+
+        if (status > FMIOK) {
+            goto TERMINATE;
+        }
+
+        time = nextCommunicationPoint;
+        nSteps++;
+    }
+
+    // write the results in the same order as members that are simulated one after the other
+    for (size_t member = 0; member < nMembers; member++) {
+
+        result->member = member;
+
+        for (size_t j = 0; j < nSamples; j++) {
+
+            for (size_t i = 0; i < nVariables; i++) {
+                row[i] = samples[(j * nVariables + i) * nMembers + member];
+            }
+
+            CALL(FMISampleFloat64(S, times[j], row, result));
+        }
+    }
+
+TERMINATE:
+
+    if (ensemble) {
+
+        freeEnsemble(ensemble);
+
+        if (S->logFunctionCall) {
+            S->logFunctionCall(S, FMIOK, "refFreeEnsemble()");
+        }
+    }
+
+    free(values);
+    free(row);
+    free(times);
+    free(samples);
+
+    return status;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "FMI3.h"
+#include "FMIModelDescription.h"
+#include "FMIRecorder.h"
+#include "fmusim.h"
+
+
+// simulate all members of an ensemble at once with the ensemble functions of the FMU (simulated is false if the FMU
+// does not export them or the start values and recorded variables are not scalar Float64 variables of the ensemble)
+FMIStatus simulateFMI3Ensemble(
+    FMIInstance* S,
+    const FMIModelDescription* modelDescription,
+    FMIRecorder* result,
+    const FMISimulationSettings* settings,
+    size_t nMembers,
+    bool* simulated);
@@ -2,6 +2,7 @@
 #include <math.h>
 
 #include "FMIUtil.h"
+#include "FMICheckpoint.h"
 
 #include "fmusim_fmi3_me.h"
 
@@ -14,7 +15,7 @@ FMIStatus simulateFMI3ME(
     const FMIModelDescription* modelDescription, 
     const char* resourcePath,
     FMIRecorder* result,
-    const FMUStaticInput * input,
+    FMUStaticInput* input,
     const FMISimulationSettings * settings) {
 
     FMIStatus status = FMIOK;
@@ -44,6 +45,12 @@ FMIStatus simulateFMI3ME(
 
     Solver* solver = NULL;
 
+    FMICheckpoint checkpoint = {
+        .time               = settings->startTime,
+        .nextEventTime      = INFINITY,
+        .nextCheckpointTime = settings->startTime + settings->checkpointInterval
+    };
+
     CALL(FMI3InstantiateModelExchange(S,
         modelDescription->instantiationToken,  // instantiationToken
         resourcePath,                          // resourcePath
@@ -57,15 +64,25 @@ FMIStatus simulateFMI3ME(
         CALL(FMIRestoreFMUStateFromFile(S, settings->initialFMUStateFile));
     }
 
-    // set start values
-    CALL(applyStartValues(S, settings));
-    CALL(FMIApplyInput(S, input, time,
-        true,  // discrete
-        true,  // continous
-        false  // after event
-    ));
+    if (settings->resumeFromCheckpoint) {
+
+        CALL(FMIRestoreCheckpoint(S, settings, &checkpoint, result, input));
+
+        time = checkpoint.time;
+        nextEventTime = checkpoint.nextEventTime;
+
+    } else {
+
+        // set start values
+        CALL(applyStartValues(S, settings));
+        CALL(FMIApplyInput(S, input, time,
+            true,  // discrete
+            true,  // continous
+            false  // after event
+        ));
+    }
 
-    if (!settings->initialFMUStateFile) {
+    if (!settings->initialFMUStateFile && !settings->resumeFromCheckpoint) {
 
         // initialize
         CALL(FMI3EnterInitializationMode(S, settings->tolerance > 0, settings->tolerance, time, fmi3False, 0));
@@ -101,6 +118,8 @@ FMIStatus simulateFMI3ME(
         CALL(FMI3EnterContinuousTimeMode(S));
     }
 
+    // the solver history is not part of the checkpoint, so a resumed simulation starts with a new solver
+    // and its results can differ from those of an uninterrupted simulation (e.g. with CVode)
     solver = settings->solverCreate(S, modelDescription, input, settings->tolerance, time);
     
     if (!solver) {
@@ -108,10 +127,15 @@ FMIStatus simulateFMI3ME(
         goto TERMINATE;
     }
 
-    nSteps = 0;
+    nSteps = checkpoint.nSteps;
 
     for (;;) {
 
+        if (FMICheckpointDue(settings, &checkpoint, time)) {
+
+            CALL(FMISaveCheckpoint(S, settings, &checkpoint, time, nSteps, nextEventTime, result, input));
+        }
+
         CALL(FMISample(S, time, result));
 
         if (time >= settings->stopTime) {
@@ -122,7 +146,7 @@ FMIStatus simulateFMI3ME(
 
         nextCommunicationPoint = nextRegularPoint;
 
-        nextInputEventTime = FMINextInputEvent(input, time);
+        CALL(FMINextInputEvent(input, time, &nextInputEventTime));
 
         inputEvent = nextCommunicationPoint >= nextInputEventTime;
 
@@ -200,7 +224,7 @@ FMIStatus simulateFMI3ME(
     }
 
     if (settings->finalFMUStateFile) {
-        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile));
+        CALL(FMISaveFMUStateToFile(S, settings->finalFMUStateFile, settings->fmuStateBaseFile));
     }
 
 TERMINATE:
@@ -0,0 +1,228 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include "FMIScheduler.h"
+
+#include "fmusim_fmi3_se.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIOK) goto TERMINATE; } while (0)
+
+
+// the model partitions of an FMU (one per input clock)
+typedef struct {
+
+    FMIInstance* S;
+    FMIScheduler* scheduler;
+
+    size_t nPartitions;
+    fmi3ValueReference* clocks;
+    int* priorities;
+
+    // countdown clocks are activated by clockUpdate
+    bool* countdown;
+
+    // interval and shift of the periodic clocks (interval == 0 for aperiodic clocks)
+    double* intervals;
+    double* shifts;
+
+} FMIPartitions;
+
+static FMIStatus activatePartition(void* context, size_t partition, double activationTime) {
+
+    FMIPartitions* partitions = (FMIPartitions*)context;
+
+    return FMI3ActivateModelPartition(partitions->S, partitions->clocks[partition], activationTime);
+}
+
+// schedule the activations of the countdown clocks whose intervals have been set by the calling partition
+static void clockUpdate(fmi3InstanceEnvironment instanceEnvironment) {
+
+    FMIInstance* S = (FMIInstance*)instanceEnvironment;
+    FMIPartitions* partitions = (FMIPartitions*)S->userData;
+
+    const double activationTime = FMIActivationTime(partitions->scheduler);
+
+    // get the intervals under the lock the partitions use to update them
+    FMILockPreemption();
+
+    for (size_t i = 0; i < partitions->nPartitions; i++) {
+
+        if (!partitions->countdown[i]) {
+            continue;
+        }
+
+        fmi3Float64 interval = 0;
+        fmi3IntervalQualifier qualifier = fmi3IntervalNotYetKnown;
+
+        if (FMI3GetIntervalDecimal(S, &partitions->clocks[i], 1, &interval, &qualifier) > FMIWarning) {
+            break;
+        }
+
+        if (qualifier == fmi3IntervalChanged) {
+            FMIScheduleActivation(partitions->scheduler, i, activationTime + interval);
+        }
+    }
+
+    FMIUnlockPreemption();
+}
+
+FMIStatus simulateFMI3SE(FMIInstance* S,
+    const FMIModelDescription* modelDescription,
+    const char* resourcePath,
+    FMIRecorder* recorder,
+    const FMISimulationSettings* settings) {
+
+    FMIStatus status = FMIOK;
+
+    FMIPartitions partitions = { .S = S };
+
+    const FMIModelVariable** clockVariables = NULL;
+    bool instantiated = false;
+
+    for (size_t i = 0; i < modelDescription->nModelVariables; i++) {
+        const FMIModelVariable* variable = &modelDescription->modelVariables[i];
+        if (variable->type == FMIClockType && variable->causality == FMIInput) {
+            partitions.nPartitions++;
+        }
+    }
+
+    partitions.clocks       = (fmi3ValueReference*)calloc(partitions.nPartitions, sizeof(fmi3ValueReference));
+    partitions.priorities   = (int*)calloc(partitions.nPartitions, sizeof(int));
+    partitions.countdown    = (bool*)calloc(partitions.nPartitions, sizeof(bool));
+    partitions.intervals    = (double*)calloc(partitions.nPartitions, sizeof(double));
+    partitions.shifts       = (double*)calloc(partitions.nPartitions, sizeof(double));
+
+    clockVariables          = (const FMIModelVariable**)calloc(partitions.nPartitions, sizeof(FMIModelVariable*));
+
+    if (partitions.nPartitions > 0 && (!partitions.clocks || !partitions.priorities || !partitions.countdown ||
+        !partitions.intervals || !partitions.shifts || !clockVariables)) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0, j = 0; i < modelDescription->nModelVariables; i++) {
+
+        const FMIModelVariable* variable = &modelDescription->modelVariables[i];
+
+        if (variable->type == FMIClockType && variable->causality == FMIInput) {
+            partitions.clocks[j] = variable->valueReference;
+            partitions.priorities[j] = variable->priority;
+            partitions.countdown[j] = variable->intervalVariability == FMICountdownInterval;
+            clockVariables[j++] = variable;
+        }
+    }
+
+    // the calls are logged with the buffer of the instance so the partitions must not run concurrently
+    partitions.scheduler = FMICreateScheduler(partitions.nPartitions, partitions.priorities, activatePartition, &partitions, S->logFunctionCall == NULL);
+
+    if (!partitions.scheduler) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    S->userData = &partitions;
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        modelDescription->instantiationToken,  // instantiationToken
+        resourcePath,                          // resourcePath
+        fmi3False,                             // visible
+        fmi3False,                             // loggingOn
+        NULL,                                  // requiredIntermediateVariables
+        0,                                     // nRequiredIntermediateVariables
+        clockUpdate,                           // clockUpdate
+        FMILockPreemption,                     // lockPreemption
+        FMIUnlockPreemption                    // unlockPreemption
+    ));
+
+    instantiated = true;
+
+    CALL(applyStartValues(S, settings));
+
+    CALL(FMI3EnterInitializationMode(S, settings->tolerance > 0, settings->tolerance, settings->startTime, fmi3True, settings->stopTime));
+    CALL(FMI3ExitInitializationMode(S));
+
+    for (size_t i = 0; i < partitions.nPartitions; i++) {
+
+        const FMIModelVariable* variable = clockVariables[i];
+
+        switch (variable->intervalVariability) {
+
+        case FMIConstantInterval:
+        case FMIFixedInterval:
+            partitions.intervals[i] = variable->intervalDecimal;
+            partitions.shifts[i] = variable->shiftDecimal;
+            break;
+
+        case FMICalculatedInterval:
+        case FMITunableInterval:
+        case FMIChangingInterval: {
+
+            fmi3IntervalQualifier qualifier = fmi3IntervalNotYetKnown;
+
+            CALL(FMI3GetIntervalDecimal(S, &partitions.clocks[i], 1, &partitions.intervals[i], &qualifier));
+
+            if (qualifier == fmi3IntervalNotYetKnown) {
+                partitions.intervals[i] = 0;
+            } else if (FMI3GetShiftDecimal(S, &partitions.clocks[i], 1, &partitions.shifts[i]) > FMIWarning) {
+                // FMUs that don't provide the shift use the one from the model description (0 by default)
+                partitions.shifts[i] = variable->shiftDecimal;
+            }
+
+            break;
+        }
+
+        default:
+            // countdown clocks are activated by clockUpdate and triggered clocks are not activated
+            break;
+        }
+
+        if (partitions.intervals[i] > 0) {
+            CALL(FMISchedulePeriodicActivations(partitions.scheduler, i, settings->startTime + partitions.shifts[i], partitions.intervals[i]));
+        }
+    }
+
+    for (unsigned long step = 0;; step++) {
+
+        const double time = settings->startTime + step * settings->outputInterval;
+
+        // the partitions are only woken for the activations up to the current communication point
+        CALL(FMIRunPartitions(partitions.scheduler, time));
+
+        CALL(FMISample(S, time, recorder));
+
+        if (time >= settings->stopTime) {
+            break;
+        }
+    }
+
+TERMINATE:
+
+    // stop the partition threads before the instance is freed
+    FMIFreeScheduler(partitions.scheduler);
+
+    if (instantiated) {
+
+        if (status < FMIError) {
+
+            const FMIStatus terminateStatus = FMI3Terminate(S);
+
+            if (terminateStatus > status) {
+                status = terminateStatus;
+            }
+        }
+
+        if (status != FMIFatal) {
+            FMI3FreeInstance(S);
+        }
+    }
+
+    free(clockVariables);
+    free(partitions.clocks);
+    free(partitions.priorities);
+    free(partitions.countdown);
+    free(partitions.intervals);
+    free(partitions.shifts);
+
+    return status;
+}
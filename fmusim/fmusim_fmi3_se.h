@@ -0,0 +1,14 @@
+#pragma once
+
+#include "FMI3.h"
+#include "FMIModelDescription.h"
+#include "FMIRecorder.h"
+#include "fmusim.h"
+
+
+FMIStatus simulateFMI3SE(
+    FMIInstance* S,
+    const FMIModelDescription* modelDescription,
+    const char* resourcePath,
+    FMIRecorder* result,
+    const FMISimulationSettings* settings);
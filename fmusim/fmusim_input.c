@@ -1,26 +1,494 @@
 #include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "csv.h"
 #include "FMI1.h"
 #include "FMI2.h"
 #include "FMI3.h"
+#include "FMIUtil.h"
 #include "fmusim_input.h"
 
 
 #define CALL(f) do { status = f; if (status > FMIOK) goto TERMINATE; } while (0)
 
+// initial number of rows in the sliding window of a streamed input
+#define INPUT_STREAM_CAPACITY 1024
+
+// Columns are stored in the native type of the variable. Boolean and Clock columns are
+// bitsets with one bit per row. String and Binary columns hold indices into a table of
+// interned values that are stored back to back in a single arena. Binary values are
+// given as hex strings in CSV files.
+//
+// Binary input files are written in native byte order and all sections are 8-byte aligned:
+//
+//   char     magic[8]                 "FMIINPUT"
+//   uint32_t version                  BINARY_INPUT_VERSION
+//   uint32_t nVariables
+//   uint64_t nRows
+//   nVariables x {
+//     uint32_t columnType             BinaryInputColumnType
+//     uint32_t nameLength
+//     char     name[nameLength]       zero padded to a multiple of 8 bytes
+//   }
+//   double   time[nRows]
+//   nVariables x {
+//     values[nRows]                   zero padded to a multiple of 8 bytes
+//   }
+//   uint64_t nStrings
+//   uint64_t dataSize
+//   uint64_t offsets[nStrings]
+//   uint64_t sizes[nStrings]
+//   char     data[dataSize]           zero padded to a multiple of 8 bytes
+#define BINARY_INPUT_MAGIC "FMIINPUT"
+#define BINARY_INPUT_VERSION 3
+
+typedef enum {
+	BinaryInputFloat32Column,
+	BinaryInputFloat64Column,
+	BinaryInputInt8Column,
+	BinaryInputUInt8Column,
+	BinaryInputInt16Column,
+	BinaryInputUInt16Column,
+	BinaryInputInt32Column,
+	BinaryInputUInt32Column,
+	BinaryInputInt64Column,
+	BinaryInputUInt64Column,
+	BinaryInputBooleanColumn,
+	BinaryInputStringColumn,
+	BinaryInputBinaryColumn
+} BinaryInputColumnType;
+
+#define PADDED_SIZE(size) (((size) + 7) & ~(size_t)7)
+
+#define VALUE(type, column, row) (((type*)(column))[row])
+
+#define GET_BIT(column, row) ((((const uint8_t*)(column))[(row) / 8] >> ((row) % 8)) & 1)
+
+struct FMUInputStream {
+
+	// window
+	CsvHandle handle;
+	size_t capacity;
+	size_t firstRow;
+	bool endOfFile;
+
+	// look-ahead for discrete events (two rows per column, alternating)
+	CsvHandle lookAheadHandle;
+	size_t nLookAheadRows;
+	bool lookAheadEndOfFile;
+	double lookAheadTime;
+	void** lookAheadValues;
+	double nextEventTime;
+
+};
+
+// initial number of buckets of the hash table for interning
+#define INPUT_STRINGS_CAPACITY 64
+
+// maximum number of interned values
+#define INPUT_STRINGS_MAX UINT32_MAX
+
+struct FMUInputStrings {
+
+	// interned values (arrays point into the mapped file for binary input files)
+	size_t nStrings;
+	uint64_t* offsets;
+	uint64_t* sizes;
+	size_t dataSize;
+	char* data;
+
+	// hash table for interning (index + 1, 0 for empty buckets)
+	size_t nBuckets;
+	uint32_t* buckets;
+
+	// buffer for decoding hex strings
+	size_t bufferSize;
+	unsigned char* buffer;
+
+};
+
+// number of bytes per value (0 for bitsets)
+static size_t valueSize(FMIVariableType type) {
+
+	switch (type) {
+	case FMIFloat32Type:
+	case FMIDiscreteFloat32Type:
+		return sizeof(float);
+	case FMIInt8Type:
+	case FMIUInt8Type:
+		return sizeof(int8_t);
+	case FMIInt16Type:
+	case FMIUInt16Type:
+		return sizeof(int16_t);
+	case FMIInt32Type:
+	case FMIUInt32Type:
+		return sizeof(int32_t);
+	case FMIInt64Type:
+	case FMIUInt64Type:
+		return sizeof(int64_t);
+	case FMIBooleanType:
+	case FMIClockType:
+		return 0;
+	case FMIStringType:
+	case FMIBinaryType:
+		return sizeof(uint32_t);
+	default:
+		return sizeof(double);
+	}
+}
 
-FMUStaticInput* FMIReadInput(const FMIModelDescription* modelDescription, const char* filename) {
+// number of bytes required to store nRows values
+static size_t columnSize(FMIVariableType type, size_t nRows) {
+	const size_t size = valueSize(type);
+	return size ? nRows * size : (nRows + 7) / 8;
+}
 
-	FMUStaticInput* input = (FMUStaticInput*)calloc(1, sizeof(FMUStaticInput));
+static BinaryInputColumnType binaryColumnType(FMIVariableType type) {
+
+	switch (type) {
+	case FMIFloat32Type:
+	case FMIDiscreteFloat32Type:
+		return BinaryInputFloat32Column;
+	case FMIInt8Type:
+		return BinaryInputInt8Column;
+	case FMIUInt8Type:
+		return BinaryInputUInt8Column;
+	case FMIInt16Type:
+		return BinaryInputInt16Column;
+	case FMIUInt16Type:
+		return BinaryInputUInt16Column;
+	case FMIInt32Type:
+		return BinaryInputInt32Column;
+	case FMIUInt32Type:
+		return BinaryInputUInt32Column;
+	case FMIInt64Type:
+		return BinaryInputInt64Column;
+	case FMIUInt64Type:
+		return BinaryInputUInt64Column;
+	case FMIBooleanType:
+	case FMIClockType:
+		return BinaryInputBooleanColumn;
+	case FMIStringType:
+		return BinaryInputStringColumn;
+	case FMIBinaryType:
+		return BinaryInputBinaryColumn;
+	default:
+		return BinaryInputFloat64Column;
+	}
+}
 
-	char* row = NULL;
-	int cols = 0;
+static bool isContinuous(FMIVariableType type) {
+	return type == FMIFloat32Type || type == FMIFloat64Type;
+}
 
-	CsvHandle handle = CsvOpen(filename);
+static void freeColumns(size_t nVariables, void** values) {
 
-	// variable names
-	row = CsvReadNextRow(handle);
+	if (!values) {
+		return;
+	}
+
+	for (size_t i = 0; i < nVariables; i++) {
+		free(values[i]);
+	}
+
+	free(values);
+}
+
+static void** allocateColumns(const FMUStaticInput* input, size_t nRows) {
+
+	void** values = (void**)calloc(input->nVariables + 1, sizeof(void*));
+
+	if (!values) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < input->nVariables; i++) {
+
+		values[i] = calloc(columnSize(input->variables[i]->type, nRows), 1);
+
+		if (!values[i]) {
+			freeColumns(input->nVariables, values);
+			return NULL;
+		}
+	}
+
+	return values;
+}
+
+static FMIStatus resizeColumns(const FMUStaticInput* input, void** values, size_t nRows) {
+
+	for (size_t i = 0; i < input->nVariables; i++) {
+
+		void* column = realloc(values[i], columnSize(input->variables[i]->type, nRows));
+
+		if (!column) {
+			return FMIError;
+		}
+
+		values[i] = column;
+	}
+
+	return FMIOK;
+}
+
+static FMUInputStrings* createStrings(void) {
+	return (FMUInputStrings*)calloc(1, sizeof(FMUInputStrings));
+}
+
+static void freeStrings(FMUInputStrings* strings, bool mapped) {
+
+	if (!strings) {
+		return;
+	}
+
+	if (!mapped) {
+		free(strings->offsets);
+		free(strings->sizes);
+		free(strings->data);
+	}
+
+	free(strings->buckets);
+	free(strings->buffer);
+	free(strings);
+}
+
+// FNV-1a
+static uint64_t hashValue(const void* value, size_t size) {
+
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < size; i++) {
+		hash ^= ((const uint8_t*)value)[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+static FMIStatus growBuckets(FMUInputStrings* strings) {
+
+	const size_t nBuckets = strings->nBuckets ? 2 * strings->nBuckets : INPUT_STRINGS_CAPACITY;
+
+	uint32_t* buckets = (uint32_t*)calloc(nBuckets, sizeof(uint32_t));
+
+	if (!buckets) {
+		return FMIError;
+	}
+
+	for (size_t i = 0; i < strings->nStrings; i++) {
+
+		size_t bucket = hashValue(&strings->data[strings->offsets[i]], strings->sizes[i]) & (nBuckets - 1);
+
+		while (buckets[bucket]) {
+			bucket = (bucket + 1) & (nBuckets - 1);
+		}
+
+		buckets[bucket] = (uint32_t)(i + 1);
+	}
+
+	free(strings->buckets);
+
+	strings->nBuckets = nBuckets;
+	strings->buckets = buckets;
+
+	return FMIOK;
+}
+
+// get the index of a value in the string table and add it if necessary
+static FMIStatus internValue(FMUInputStrings* strings, const void* value, size_t size, uint32_t* index) {
+
+	// keep the load factor below 1/2
+	if (2 * (strings->nStrings + 1) > strings->nBuckets && growBuckets(strings) > FMIOK) {
+		return FMIError;
+	}
+
+	size_t bucket = hashValue(value, size) & (strings->nBuckets - 1);
+
+	while (strings->buckets[bucket]) {
+
+		const size_t i = strings->buckets[bucket] - 1;
+
+		if (strings->sizes[i] == size && !memcmp(&strings->data[strings->offsets[i]], value, size)) {
+			*index = (uint32_t)i;
+			return FMIOK;
+		}
+
+		bucket = (bucket + 1) & (strings->nBuckets - 1);
+	}
+
+	if (strings->nStrings >= INPUT_STRINGS_MAX) {
+		printf("Too many distinct String and Binary input values.\n");
+		return FMIError;
+	}
+
+	uint64_t* offsets = (uint64_t*)realloc(strings->offsets, (strings->nStrings + 1) * sizeof(uint64_t));
+
+	if (!offsets) {
+		return FMIError;
+	}
+
+	strings->offsets = offsets;
+
+	uint64_t* sizes = (uint64_t*)realloc(strings->sizes, (strings->nStrings + 1) * sizeof(uint64_t));
+
+	if (!sizes) {
+		return FMIError;
+	}
+
+	strings->sizes = sizes;
+
+	// values are zero terminated so strings can be passed directly
+	char* data = (char*)realloc(strings->data, strings->dataSize + size + 1);
+
+	if (!data) {
+		return FMIError;
+	}
+
+	strings->data = data;
+
+	memcpy(&strings->data[strings->dataSize], value, size);
+	strings->data[strings->dataSize + size] = '\0';
+
+	strings->offsets[strings->nStrings] = strings->dataSize;
+	strings->sizes[strings->nStrings] = size;
+	strings->buckets[bucket] = (uint32_t)(strings->nStrings + 1);
+
+	strings->dataSize += size + 1;
+
+	*index = (uint32_t)strings->nStrings++;
+
+	return FMIOK;
+}
+
+static int hexDigit(char c) {
+
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	} else if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+
+	return -1;
+}
+
+static FMIStatus internHex(FMUInputStrings* strings, const char* hex, uint32_t* index) {
+
+	const size_t length = strlen(hex);
+
+	if (length % 2) {
+		printf("The binary value %s has an odd number of digits.\n", hex);
+		return FMIError;
+	}
+
+	const size_t size = length / 2;
+
+	if (size > strings->bufferSize) {
+
+		unsigned char* buffer = (unsigned char*)realloc(strings->buffer, size);
+
+		if (!buffer) {
+			return FMIError;
+		}
+
+		strings->buffer = buffer;
+		strings->bufferSize = size;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+
+		const int high = hexDigit(hex[2 * i]);
+		const int low  = hexDigit(hex[2 * i + 1]);
+
+		if (high < 0 || low < 0) {
+			printf("The binary value %s is not a valid hex string.\n", hex);
+			return FMIError;
+		}
+
+		strings->buffer[i] = (unsigned char)((high << 4) | low);
+	}
+
+	return internValue(strings, strings->buffer, size, index);
+}
+
+static int64_t parseInteger(FMIVariableType type, const char* literal) {
+
+	char* eptr;
+
+	const int64_t value = type == FMIUInt64Type ? (int64_t)strtoull(literal, &eptr, 10) : strtoll(literal, &eptr, 10);
 
+	if (*eptr == '.' || *eptr == 'e' || *eptr == 'E') {
+		return (int64_t)strtod(literal, &eptr);  // e.g. "1.0" or "1e3"
+	}
+
+	return value;
+}
+
+static FMIStatus parseValue(FMUInputStrings* strings, FMIVariableType type, const char* literal, void* column, size_t row) {
+
+	switch (type) {
+	case FMIFloat32Type:
+	case FMIDiscreteFloat32Type:
+		VALUE(float, column, row) = strtof(literal, NULL);
+		break;
+	case FMIInt8Type:
+		VALUE(int8_t, column, row) = (int8_t)parseInteger(type, literal);
+		break;
+	case FMIUInt8Type:
+		VALUE(uint8_t, column, row) = (uint8_t)parseInteger(type, literal);
+		break;
+	case FMIInt16Type:
+		VALUE(int16_t, column, row) = (int16_t)parseInteger(type, literal);
+		break;
+	case FMIUInt16Type:
+		VALUE(uint16_t, column, row) = (uint16_t)parseInteger(type, literal);
+		break;
+	case FMIInt32Type:
+		VALUE(int32_t, column, row) = (int32_t)parseInteger(type, literal);
+		break;
+	case FMIUInt32Type:
+		VALUE(uint32_t, column, row) = (uint32_t)parseInteger(type, literal);
+		break;
+	case FMIInt64Type:
+		VALUE(int64_t, column, row) = parseInteger(type, literal);
+		break;
+	case FMIUInt64Type:
+		VALUE(uint64_t, column, row) = (uint64_t)parseInteger(type, literal);
+		break;
+	case FMIBooleanType:
+	case FMIClockType:
+		if (parseInteger(type, literal)) {
+			((uint8_t*)column)[row / 8] |= (uint8_t)(1 << (row % 8));
+		} else {
+			((uint8_t*)column)[row / 8] &= (uint8_t)~(1 << (row % 8));
+		}
+		break;
+	case FMIStringType:
+		return internValue(strings, literal, strlen(literal), &VALUE(uint32_t, column, row));
+	case FMIBinaryType:
+		return internHex(strings, literal, &VALUE(uint32_t, column, row));
+	default:
+		VALUE(double, column, row) = strtod(literal, NULL);
+		break;
+	}
+
+	return FMIOK;
+}
+
+static FMIStatus readHeader(const FMIModelDescription* modelDescription, CsvHandle handle, FMUStaticInput* input) {
+
+	char* row = CsvReadNextRow(handle);
+
+	if (!row) {
+		printf("The input file is empty.\n");
+		return FMIError;
+	}
+
+	// skip the time column
 	const char* col = CsvReadNextCol(row, handle);
 
 	while (col = CsvReadNextCol(row, handle)) {
@@ -29,7 +497,7 @@ FMUStaticInput* FMIReadInput(const FMIModelDescription* modelDescription, const
 
 		if (!variable) {
 			printf("Variable %s not found.\n", col);
-			return NULL;
+			return FMIError;
 		}
 
 		input->variables = realloc(input->variables, (input->nVariables + 1) * sizeof(FMIModelVariable*));
@@ -37,53 +505,646 @@ FMUStaticInput* FMIReadInput(const FMIModelDescription* modelDescription, const
 		input->nVariables++;
 	}
 
+	return FMIOK;
+}
+
+static FMIStatus readRow(CsvHandle handle, const FMUStaticInput* input, size_t row, double time[], void** values, bool* endOfFile) {
+
+	char* line = CsvReadNextRow(handle);
+
+	*endOfFile = line == NULL;
+
+	if (*endOfFile) {
+		return FMIOK;
+	}
+
+	char* eptr;
+
+	const char* col = CsvReadNextCol(line, handle);
+
+	time[row] = strtod(col, &eptr);
+
+	size_t i = 0;
+
+	while (col = CsvReadNextCol(line, handle)) {
+
+		if (i >= input->nVariables) {
+			printf("The number of columns must be equal to the number of variables.\n");
+			return FMIError;
+		}
+
+		if (parseValue(input->strings, input->variables[i]->type, col, values[i], row) > FMIOK) {
+			return FMIError;
+		}
+
+		i++;
+	}
+
+	return FMIOK;
+}
+
+static bool isBinaryInput(const char* filename) {
+
+	char magic[8] = "";
+
+	FILE* file = fopen(filename, "rb");
+
+	if (!file) {
+		return false;
+	}
+
+	const size_t n = fread(magic, 1, sizeof(magic), file);
+
+	fclose(file);
+
+	return n == sizeof(magic) && !memcmp(magic, BINARY_INPUT_MAGIC, sizeof(magic));
+}
+
+static FMUStaticInput* mapBinaryInput(const FMIModelDescription* modelDescription, const char* filename) {
+
+	FMUStaticInput* input = (FMUStaticInput*)calloc(1, sizeof(FMUStaticInput));
+
+	char* name = NULL;
+
+	if (!input) {
+		goto FAIL;
+	}
+
+	input->mapping = FMIMapFile(filename, &input->mappingSize);
+
+	if (!input->mapping) {
+		printf("Failed to map input file %s.\n", filename);
+		goto FAIL;
+	}
+
+	const char* data = (const char*)input->mapping;
+	const size_t size = input->mappingSize;
+
+	uint32_t version;
+	uint32_t nVariables;
+	uint64_t nRows;
+
+	if (size < 24) {
+		goto INVALID;
+	}
+
+	memcpy(&version,    &data[8],  sizeof(uint32_t));
+	memcpy(&nVariables, &data[12], sizeof(uint32_t));
+	memcpy(&nRows,      &data[16], sizeof(uint64_t));
+
+	if (version != BINARY_INPUT_VERSION) {
+		printf("Unsupported binary input version %u.\n", version);
+		goto FAIL;
+	}
+
+	size_t offset = 24;
+
+	input->variables = (const FMIModelVariable**)calloc(nVariables + 1, sizeof(FMIModelVariable*));
+	input->values = (void**)calloc(nVariables + 1, sizeof(void*));
+
+	if (!input->variables || !input->values) {
+		goto FAIL;
+	}
+
+	for (size_t i = 0; i < nVariables; i++) {
+
+		uint32_t columnType;
+		uint32_t nameLength;
+
+		if (offset + 8 > size) {
+			goto INVALID;
+		}
+
+		memcpy(&columnType, &data[offset],     sizeof(uint32_t));
+		memcpy(&nameLength, &data[offset + 4], sizeof(uint32_t));
+
+		offset += 8;
+
+		if (offset + PADDED_SIZE((size_t)nameLength) > size) {
+			goto INVALID;
+		}
+
+		name = (char*)realloc(name, nameLength + 1);
+
+		if (!name) {
+			goto FAIL;
+		}
+
+		memcpy(name, &data[offset], nameLength);
+		name[nameLength] = '\0';
+
+		offset += PADDED_SIZE((size_t)nameLength);
+
+		const FMIModelVariable* variable = FMIModelVariableForName(modelDescription, name);
+
+		if (!variable) {
+			printf("Variable %s not found.\n", name);
+			goto FAIL;
+		}
+
+		if (columnType != binaryColumnType(variable->type)) {
+			printf("The column type of variable %s does not match its type.\n", name);
+			goto FAIL;
+		}
+
+		input->variables[i] = variable;
+	}
+
+	input->nVariables = nVariables;
+
+	// the time column must fit into the file
+	if (nRows > (size - offset) / sizeof(double)) {
+		goto INVALID;
+	}
+
+	input->nRows = (size_t)nRows;
+
+	// point the columns into the mapped file
+	input->time = (double*)&data[offset];
+
+	offset += input->nRows * sizeof(double);
+
+	for (size_t i = 0; i < nVariables; i++) {
+		input->values[i] = (void*)&data[offset];
+		offset += PADDED_SIZE(columnSize(input->variables[i]->type, input->nRows));
+	}
+
+	if (offset + 2 * sizeof(uint64_t) > size) {
+		goto INVALID;
+	}
+
+	// string table
+	uint64_t nStrings;
+	uint64_t dataSize;
+
+	memcpy(&nStrings, &data[offset],                    sizeof(uint64_t));
+	memcpy(&dataSize, &data[offset + sizeof(uint64_t)], sizeof(uint64_t));
+
+	offset += 2 * sizeof(uint64_t);
+
+	if (nStrings > (size - offset) / (2 * sizeof(uint64_t))) {
+		goto INVALID;
+	}
+
+	input->strings = createStrings();
+
+	if (!input->strings) {
+		goto FAIL;
+	}
+
+	FMUInputStrings* strings = input->strings;
+
+	strings->nStrings = (size_t)nStrings;
+	strings->offsets  = (uint64_t*)&data[offset];
+	strings->sizes    = (uint64_t*)&data[offset + strings->nStrings * sizeof(uint64_t)];
+
+	offset += 2 * strings->nStrings * sizeof(uint64_t);
+
+	if (dataSize > size - offset) {
+		goto INVALID;
+	}
+
+	strings->dataSize = (size_t)dataSize;
+	strings->data     = (char*)&data[offset];
+
+	// every value must be inside the string data and zero terminated
+	for (size_t i = 0; i < strings->nStrings; i++) {
+		if (strings->offsets[i] >= dataSize || strings->sizes[i] >= dataSize - strings->offsets[i] ||
+			strings->data[strings->offsets[i] + strings->sizes[i]] != '\0') {
+			goto INVALID;
+		}
+	}
+
+	// the String and Binary columns must only contain indices of the string table
+	for (size_t i = 0; i < nVariables; i++) {
+
+		const FMIVariableType type = input->variables[i]->type;
+
+		if (type != FMIStringType && type != FMIBinaryType) {
+			continue;
+		}
+
+		for (size_t j = 0; j < input->nRows; j++) {
+			if (VALUE(uint32_t, input->values[i], j) >= strings->nStrings) {
+				goto INVALID;
+			}
+		}
+	}
+
+	free(name);
+
+	return input;
+
+INVALID:
+	printf("The binary input file %s is invalid.\n", filename);
+
+FAIL:
+	free(name);
+	FMIFreeInput(input);
+	return NULL;
+}
+
+FMUStaticInput* FMIReadInput(const FMIModelDescription* modelDescription, const char* filename) {
+
+	if (isBinaryInput(filename)) {
+		return mapBinaryInput(modelDescription, filename);
+	}
+
+	FMUStaticInput* input = (FMUStaticInput*)calloc(1, sizeof(FMUStaticInput));
+
+	CsvHandle handle = CsvOpen(filename);
+
+	if (!input || !handle) {
+		printf("Failed to open input file %s.\n", filename);
+		goto FAIL;
+	}
+
+	// variable names
+	if (readHeader(modelDescription, handle, input) > FMIOK) {
+		goto FAIL;
+	}
+
+	input->strings = createStrings();
+
+	if (!input->strings) {
+		goto FAIL;
+	}
+
+	size_t capacity = 0;
+
 	// data
-	while (row = CsvReadNextRow(handle)) {
+	for (;;) {
 
-		input->time   = realloc(input->time,   (input->nRows + 1) * sizeof(double));
-		input->values = realloc(input->values, (input->nRows + 1) * input->nVariables * sizeof(double));
+		if (input->nRows == capacity) {
 
-		char* eptr;
+			capacity = capacity ? 2 * capacity : INPUT_STREAM_CAPACITY;
 
-		// time
-		col = CsvReadNextCol(row, handle);
+			input->time = (double*)realloc(input->time, capacity * sizeof(double));
 
-		input->time[input->nRows] = strtod(col, &eptr);
+			if (!input->values) {
+				input->values = (void**)calloc(input->nVariables + 1, sizeof(void*));
+			}
 
-		size_t i = 0;
+			if (!input->time || !input->values) {
+				goto FAIL;
+			}
 
-		while (col = CsvReadNextCol(row, handle)) {
-			
-			if (i >= input->nVariables) {
-				printf("The number of columns must be equal to the number of variables.\n");
-				return NULL;
+			if (resizeColumns(input, input->values, capacity) > FMIOK) {
+				goto FAIL;
 			}
+		}
+
+		bool endOfFile;
 
-			size_t index = (input->nRows * input->nVariables) + i;
+		if (readRow(handle, input, input->nRows, input->time, input->values, &endOfFile) > FMIOK) {
+			goto FAIL;
+		}
 
-			input->values[index] = strtod(col, &eptr);
-			
-			i++;
+		if (endOfFile) {
+			break;
 		}
 
 		input->nRows++;
 	}
 
+	CsvClose(handle);
+
 	return input;
+
+FAIL:
+	CsvClose(handle);
+	FMIFreeInput(input);
+	return NULL;
 }
 
-void FMIFreeInput(FMUStaticInput* input) {
-	// TODO
+FMUStaticInput* FMIOpenInputStream(const FMIModelDescription* modelDescription, const char* filename) {
+
+	// binary files are mapped and paged in on demand
+	if (isBinaryInput(filename)) {
+		return mapBinaryInput(modelDescription, filename);
+	}
+
+	FMUStaticInput* input = (FMUStaticInput*)calloc(1, sizeof(FMUStaticInput));
+
+	if (!input) {
+		return NULL;
+	}
+
+	FMUInputStream* stream = (FMUInputStream*)calloc(1, sizeof(FMUInputStream));
+
+	input->stream = stream;
+
+	if (!stream) {
+		goto FAIL;
+	}
+
+	stream->handle          = CsvOpen(filename);
+	stream->lookAheadHandle = CsvOpen(filename);
+
+	if (!stream->handle || !stream->lookAheadHandle) {
+		printf("Failed to open input file %s.\n", filename);
+		goto FAIL;
+	}
+
+	if (readHeader(modelDescription, stream->handle, input) > FMIOK) {
+		goto FAIL;
+	}
+
+	// skip the header of the look-ahead cursor
+	CsvReadNextRow(stream->lookAheadHandle);
+
+	stream->capacity        = INPUT_STREAM_CAPACITY;
+	stream->nextEventTime   = -INFINITY;
+	stream->lookAheadValues = allocateColumns(input, 2);
+
+	input->time    = (double*)calloc(stream->capacity, sizeof(double));
+	input->values  = allocateColumns(input, stream->capacity);
+	input->strings = createStrings();
+
+	if (!input->time || !input->values || !input->strings || !stream->lookAheadValues) {
+		goto FAIL;
+	}
+
+	return input;
+
+FAIL:
+	FMIFreeInput(input);
+	return NULL;
+}
+
+FMIStatus FMIWriteBinaryInput(const FMUStaticInput* input, const char* filename) {
+
+	FMIStatus status = FMIOK;
+
+	const char padding[8] = { 0 };
+
+	if (input->stream) {
+		printf("Streamed input cannot be written to a binary file.\n");
+		return FMIError;
+	}
+
+	FILE* file = fopen(filename, "wb");
+
+	if (!file) {
+		printf("Failed to open %s for writing.\n", filename);
+		return FMIError;
+	}
+
+	const uint32_t version    = BINARY_INPUT_VERSION;
+	const uint32_t nVariables = (uint32_t)input->nVariables;
+	const uint64_t nRows      = input->nRows;
+
+	bool success =
+		fwrite(BINARY_INPUT_MAGIC, 1, 8, file) == 8 &&
+		fwrite(&version, sizeof(version), 1, file) == 1 &&
+		fwrite(&nVariables, sizeof(nVariables), 1, file) == 1 &&
+		fwrite(&nRows, sizeof(nRows), 1, file) == 1;
+
+	for (size_t i = 0; success && i < input->nVariables; i++) {
+
+		const FMIModelVariable* variable = input->variables[i];
+
+		const uint32_t columnType = binaryColumnType(variable->type);
+		const uint32_t nameLength = (uint32_t)strlen(variable->name);
+		const size_t   nPadding   = PADDED_SIZE((size_t)nameLength) - nameLength;
+
+		success =
+			fwrite(&columnType, sizeof(columnType), 1, file) == 1 &&
+			fwrite(&nameLength, sizeof(nameLength), 1, file) == 1 &&
+			fwrite(variable->name, 1, nameLength, file) == nameLength &&
+			fwrite(padding, 1, nPadding, file) == nPadding;
+	}
+
+	if (success && input->nRows > 0) {
+
+		success = fwrite(input->time, sizeof(double), input->nRows, file) == input->nRows;
+
+		for (size_t i = 0; success && i < input->nVariables; i++) {
+
+			const size_t size     = columnSize(input->variables[i]->type, input->nRows);
+			const size_t nPadding = PADDED_SIZE(size) - size;
+
+			success =
+				fwrite(input->values[i], 1, size, file) == size &&
+				fwrite(padding, 1, nPadding, file) == nPadding;
+		}
+	}
+
+	if (success) {
+
+		const FMUInputStrings* strings = input->strings;
+
+		const uint64_t nStrings = strings->nStrings;
+		const uint64_t dataSize = strings->dataSize;
+		const size_t   nPadding = PADDED_SIZE(strings->dataSize) - strings->dataSize;
+
+		success =
+			fwrite(&nStrings, sizeof(nStrings), 1, file) == 1 &&
+			fwrite(&dataSize, sizeof(dataSize), 1, file) == 1 &&
+			fwrite(strings->offsets, sizeof(uint64_t), strings->nStrings, file) == strings->nStrings &&
+			fwrite(strings->sizes, sizeof(uint64_t), strings->nStrings, file) == strings->nStrings &&
+			fwrite(strings->data, 1, strings->dataSize, file) == strings->dataSize &&
+			fwrite(padding, 1, nPadding, file) == nPadding;
+	}
+
+	if (fclose(file) || !success) {
+		printf("Failed to write binary input file %s.\n", filename);
+		status = FMIError;
+	}
+
+	return status;
 }
 
-double FMINextInputEvent(const FMUStaticInput* input, double time) {
+void FMIFreeInput(FMUStaticInput* input) {
 
 	if (!input) {
+		return;
+	}
+
+	FMUInputStream* stream = input->stream;
+
+	if (stream) {
+		CsvClose(stream->handle);
+		CsvClose(stream->lookAheadHandle);
+		freeColumns(input->nVariables, stream->lookAheadValues);
+		free(stream);
+	}
+
+	freeStrings(input->strings, input->mapping != NULL);
+
+	if (input->mapping) {
+		// the columns point into the mapped file
+		FMIUnmapFile(input->mapping, input->mappingSize);
+		free(input->values);
+	} else {
+		free(input->time);
+		freeColumns(input->nVariables, input->values);
+	}
+
+	free(input->applied);
+	free(input->appliedValues);
+	free(input->variables);
+	free(input);
+}
+
+// make room for the next row by discarding rows well behind the current time or by growing the window
+static FMIStatus reserveRow(FMUStaticInput* input, double time) {
+
+	FMUInputStream* stream = input->stream;
+
+	if (input->nRows < stream->capacity) {
+		return FMIOK;
+	}
+
+	size_t row = 0;
+
+	while (row + 1 < input->nRows && input->time[row + 1] < time) {
+		row++;
+	}
+
+	// keep half of the window as history for solvers that evaluate the input slightly in the past
+	const size_t history = stream->capacity / 2;
+
+	// discard whole bytes of the bitsets
+	const size_t nDiscard = row > history ? (row - history) & ~(size_t)7 : 0;
+
+	if (nDiscard > 0) {
+
+		input->nRows -= nDiscard;
+		stream->firstRow += nDiscard;
+
+		memmove(input->time, &input->time[nDiscard], input->nRows * sizeof(double));
+
+		for (size_t i = 0; i < input->nVariables; i++) {
+			const FMIVariableType type = input->variables[i]->type;
+			memmove(input->values[i], (uint8_t*)input->values[i] + columnSize(type, nDiscard), columnSize(type, input->nRows));
+		}
+
+		return FMIOK;
+	}
+
+	const size_t capacity = 2 * stream->capacity;
+
+	double* t = (double*)realloc(input->time, capacity * sizeof(double));
+
+	if (!t) {
+		return FMIError;
+	}
+
+	input->time = t;
+
+	if (resizeColumns(input, input->values, capacity) > FMIOK) {
+		return FMIError;
+	}
+
+	stream->capacity = capacity;
+
+	return FMIOK;
+}
+
+// refill the window so it covers the interval around time
+static FMIStatus advanceStream(FMUStaticInput* input, double time) {
+
+	FMIStatus status = FMIOK;
+
+	FMUInputStream* stream = input->stream;
+
+	while (!stream->endOfFile && (input->nRows == 0 || input->time[input->nRows - 1] <= time)) {
+
+		CALL(reserveRow(input, time));
+
+		CALL(readRow(stream->handle, input, input->nRows, input->time, input->values, &stream->endOfFile));
+
+		if (!stream->endOfFile) {
+			input->nRows++;
+		}
+	}
+
+	if (stream->firstRow > 0 && time <= input->time[0]) {
+		printf("Input at time %g has already been discarded from the stream window.\n", time);
+		status = FMIError;
+	}
+
+TERMINATE:
+	return status;
+}
+
+static bool discreteValueChanged(FMIVariableType type, const void* column, size_t row0, size_t row1) {
+
+	const size_t size = valueSize(type);
+
+	if (size == 0) {
+		return GET_BIT(column, row0) != GET_BIT(column, row1);
+	}
+
+	return memcmp((const uint8_t*)column + row0 * size, (const uint8_t*)column + row1 * size, size) != 0;
+}
+
+static double float64Value(FMIVariableType type, const void* column, size_t row) {
+	return valueSize(type) == sizeof(float) ? VALUE(float, column, row) : VALUE(double, column, row);
+}
+
+static FMIStatus nextStreamEvent(FMUStaticInput* input, double time, double* nextEventTime) {
+
+	FMUInputStream* stream = input->stream;
+
+	while (stream->nextEventTime <= time) {
+
+		if (stream->lookAheadEndOfFile) {
+			stream->nextEventTime = INFINITY;
+			break;
+		}
+
+		const size_t previousRow = (stream->nLookAheadRows + 1) % 2;
+		const size_t currentRow  = stream->nLookAheadRows % 2;
+
+		double t1[2];
+
+		if (readRow(stream->lookAheadHandle, input, currentRow, t1, stream->lookAheadValues, &stream->lookAheadEndOfFile) > FMIOK) {
+			printf("Failed to read row %zu of the input file.\n", stream->nLookAheadRows + 1);
+			return FMIError;
+		}
+
+		if (stream->lookAheadEndOfFile) {
+			continue;
+		}
+
+		if (stream->nLookAheadRows > 0) {
+
+			if (stream->lookAheadTime == t1[currentRow]) {
+				stream->nextEventTime = t1[currentRow];  // discrete change of a continuous variable
+			}
+
+			for (size_t j = 0; j < input->nVariables; j++) {
+
+				if (isContinuous(input->variables[j]->type)) {
+					continue;  // skip continuous variables
+				}
+
+				if (discreteValueChanged(input->variables[j]->type, stream->lookAheadValues[j], previousRow, currentRow)) {
+					stream->nextEventTime = t1[currentRow];  // discrete variable change
+				}
+			}
+		}
+
+		// the current row becomes the previous row
+		stream->lookAheadTime = t1[currentRow];
+		stream->nLookAheadRows++;
+	}
+
+	*nextEventTime = stream->nextEventTime;
+
+	return FMIOK;
+}
+
+static double nextStaticEvent(const FMUStaticInput* input, double time) {
+
+	if (input->nRows < 2) {
 		return INFINITY;
 	}
 
 	for (size_t i = 0; i < input->nRows - 1; i++) {
-		
+
 		const double t0 = input->time[i];
 		const double t1 = input->time[i + 1];
 
@@ -96,18 +1157,12 @@ double FMINextInputEvent(const FMUStaticInput* input, double time) {
 		}
 
 		for (size_t j = 0; j < input->nVariables; j++) {
-			
-			const FMIModelVariable* variable = input->variables[j];
-			const FMIVariableType   type     = variable->type;
 
-			if (type == FMIFloat32Type || type == FMIFloat64Type) {
+			if (isContinuous(input->variables[j]->type)) {
 				continue;  // skip continuous variables
 			}
 
-			const double v0 = input->values[i * input->nVariables + j];
-			const double v1 = input->values[(i + 1) * input->nVariables + j];
-
-			if (v0 != v1) {
+			if (discreteValueChanged(input->variables[j]->type, input->values[j], i, i + 1)) {
 				return t1;  // discrete variable change
 			}
 		}
@@ -117,7 +1172,88 @@ double FMINextInputEvent(const FMUStaticInput* input, double time) {
 	return INFINITY;
 }
 
-FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, double time, bool discrete, bool continuous, bool afterEvent) {
+FMIStatus FMINextInputEvent(FMUStaticInput* input, double time, double* nextEventTime) {
+
+	if (!input) {
+		*nextEventTime = INFINITY;
+		return FMIOK;
+	}
+
+	if (input->stream) {
+		return nextStreamEvent(input, time, nextEventTime);
+	}
+
+	*nextEventTime = nextStaticEvent(input, time);
+
+	return FMIOK;
+}
+
+
+static FMIStatus applyString(FMIInstance* instance, FMUStaticInput* input, size_t column, uint32_t index) {
+
+	FMIStatus status = FMIOK;
+
+	const FMUInputStrings* strings = input->strings;
+
+	const FMIModelVariable* variable = input->variables[column];
+	const FMIValueReference vr       = variable->valueReference;
+	const char*             value    = &strings->data[strings->offsets[index]];
+
+	if (variable->type == FMIBinaryType) {
+
+		if (instance->fmiVersion == FMIVersion3) {
+			const size_t size = (size_t)strings->sizes[index];
+			const fmi3Binary binaryValue = (fmi3Binary)value;
+			CALL(FMI3SetBinary(instance, &vr, 1, &size, &binaryValue, 1));
+		}
+
+	} else if (instance->fmiVersion == FMIVersion1) {
+		CALL(FMI1SetString(instance, &vr, 1, &value));
+	} else if (instance->fmiVersion == FMIVersion2) {
+		CALL(FMI2SetString(instance, &vr, 1, &value));
+	} else if (instance->fmiVersion == FMIVersion3) {
+		CALL(FMI3SetString(instance, &vr, 1, &value, 1));
+	}
+
+TERMINATE:
+	return status;
+}
+
+static FMIStatus allocateApplied(FMUStaticInput* input) {
+
+	if (!input->appliedValues) {
+
+		input->applied       = (bool*)calloc(input->nVariables + 1, sizeof(bool));
+		input->appliedValues = (uint64_t*)calloc(input->nVariables + 1, sizeof(uint64_t));
+
+		if (!input->applied || !input->appliedValues) {
+			return FMIError;
+		}
+	}
+
+	return FMIOK;
+}
+
+FMIStatus FMIRestoreAppliedInput(FMUStaticInput* input, const bool* applied, const uint64_t* appliedValues) {
+
+	if (allocateApplied(input) > FMIOK) {
+		return FMIError;
+	}
+
+	memcpy(input->applied, applied, input->nVariables * sizeof(bool));
+	memcpy(input->appliedValues, appliedValues, input->nVariables * sizeof(uint64_t));
+
+	return FMIOK;
+}
+
+void FMIResetAppliedInput(FMUStaticInput* input) {
+
+	if (input->applied) {
+		memset(input->applied, 0, input->nVariables * sizeof(bool));
+	}
+}
+
+FMIStatus FMIApplyInput(FMIInstance* instance, FMUStaticInput* input, double time, bool discrete, bool continuous, bool afterEvent) {
 
 	FMIStatus status = FMIOK;
 
@@ -125,6 +1261,16 @@ FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, doub
 		goto TERMINATE;
 	}
 
+	if (input->stream) {
+		CALL(advanceStream(input, time));
+	}
+
+	CALL(allocateApplied(input));
+
+	if (input->nRows == 0) {
+		goto TERMINATE;
+	}
+
 	size_t row = 0;
 
 	for (size_t i = 1; i < input->nRows; i++) {
@@ -138,7 +1284,7 @@ FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, doub
 		row = i;
 	}
 
-	if (afterEvent) {
+	if (afterEvent && input->nRows >= 2) {
 
 		while (row < input->nRows - 2) {
 
@@ -155,20 +1301,55 @@ FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, doub
 		const FMIModelVariable* variable = input->variables[i];
 		const FMIVariableType   type     = variable->type;
 		const FMIValueReference vr       = variable->valueReference;
-		const double            value    = input->values[(input->nVariables * row) + i];
+		const void*             column   = input->values[i];
 
-		double interpolatedValue;
+		// pointer to the value in the column (NULL for bitsets)
+		const void* value = valueSize(type) ? (const uint8_t*)column + row * valueSize(type) : NULL;
 
-		if (row >= input->nRows - 1) {
-			interpolatedValue = input->values[(input->nVariables * row) + i];
-		} else {
-			const double t0 = input->time[row];
-			const double t1 = input->time[row + 1];
+		const bool booleanValue = !value && GET_BIT(column, row);
+
+		if (!isContinuous(type)) {
+
+			if (!discrete) {
+				continue;
+			}
 
-			const double x0 = input->values[(input->nVariables * row) + i];
-			const double x1 = input->values[(input->nVariables * (row + 1)) + i];
+			// skip discrete values that have not changed since the last call
+			uint64_t rawValue = booleanValue;
+
+			if (value) {
+				memcpy(&rawValue, value, valueSize(type));
+			}
+
+			if (input->applied[i] && input->appliedValues[i] == rawValue) {
+				continue;
+			}
 
-			interpolatedValue = x0 + (time - t0) * (x1 - x0) / (t1 - t0);
+			input->applied[i] = true;
+			input->appliedValues[i] = rawValue;
+		}
+
+		if (type == FMIStringType || type == FMIBinaryType) {
+			CALL(applyString(instance, input, i, VALUE(uint32_t, column, row)));
+			continue;
+		}
+
+		double interpolatedValue = 0;
+
+		if (type == FMIFloat32Type || type == FMIFloat64Type) {
+
+			const double x0 = float64Value(type, column, row);
+
+			if (row >= input->nRows - 1) {
+				interpolatedValue = x0;
+			} else {
+				const double t0 = input->time[row];
+				const double t1 = input->time[row + 1];
+
+				const double x1 = float64Value(type, column, row + 1);
+
+				interpolatedValue = x0 + (time - t0) * (x1 - x0) / (t1 - t0);
+			}
 		}
 
 		if (instance->fmiVersion == FMIVersion1) {
@@ -179,17 +1360,16 @@ FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, doub
 
 			} else if (type == FMIDiscreteRealType && discrete) {
 
-				CALL(FMI1SetReal(instance, &vr, 1, (fmi1Real*)&value));
+				CALL(FMI1SetReal(instance, &vr, 1, (const fmi1Real*)value));
 
 			} else if (type == FMIIntegerType && discrete) {
 
-				const fmi1Integer integerValue = (fmi1Integer)value;
-				CALL(FMI1SetInteger(instance, &vr, 1, (fmi1Integer*)&integerValue));
+				CALL(FMI1SetInteger(instance, &vr, 1, (const fmi1Integer*)value));
 
 			} else if (type == FMIBooleanType && discrete) {
 
-				const fmi1Boolean booleanValue = value != fmi1False ? fmi1True : fmi1False;
-				CALL(FMI1SetBoolean(instance, &vr, 1, (fmi1Boolean*)&booleanValue));
+				const fmi1Boolean fmi1BooleanValue = booleanValue ? fmi1True : fmi1False;
+				CALL(FMI1SetBoolean(instance, &vr, 1, &fmi1BooleanValue));
 
 			}
 
@@ -201,17 +1381,16 @@ FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, doub
 
 			} else if (type == FMIDiscreteRealType && discrete) {
 
-				CALL(FMI2SetReal(instance, &vr, 1, (fmi2Real*)&value));
+				CALL(FMI2SetReal(instance, &vr, 1, (const fmi2Real*)value));
 
 			} else if (type == FMIIntegerType && discrete) {
 
-				const fmi2Integer integerValue = (fmi2Integer)value;
-				CALL(FMI2SetInteger(instance, &vr, 1, (fmi2Integer*)&integerValue));
+				CALL(FMI2SetInteger(instance, &vr, 1, (const fmi2Integer*)value));
 
 			} else if (type == FMIBooleanType && discrete) {
 
-				const fmi2Boolean booleanValue = value != fmi2False ? fmi2True : fmi2False;
-				CALL(FMI2SetBoolean(instance, &vr, 1, (fmi2Boolean*)&booleanValue));
+				const fmi2Boolean fmi2BooleanValue = booleanValue ? fmi2True : fmi2False;
+				CALL(FMI2SetBoolean(instance, &vr, 1, &fmi2BooleanValue));
 
 			}
 
@@ -230,68 +1409,59 @@ FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, doub
 
 				}
 			}
-			
+
 			if (discrete) {
-		
+
 				if (type == FMIDiscreteFloat32Type) {
 
-					const fmi3Float32 float32Value = (fmi3Float32)value;
-					CALL(FMI3SetFloat32(instance, &vr, 1, &float32Value, 1));
+					CALL(FMI3SetFloat32(instance, &vr, 1, (const fmi3Float32*)value, 1));
 
 				} else if (type == FMIDiscreteFloat64Type) {
 
-					CALL(FMI3SetFloat64(instance, &vr, 1, (fmi3Float64*)&value, 1));
+					CALL(FMI3SetFloat64(instance, &vr, 1, (const fmi3Float64*)value, 1));
 
 				} else if (type == FMIInt8Type) {
 
-					const fmi3Int8 int8Value = (fmi3Int8)value;
-					CALL(FMI3SetInt8(instance, &vr, 1, &int8Value, 1));
+					CALL(FMI3SetInt8(instance, &vr, 1, (const fmi3Int8*)value, 1));
 
 				} else if (type == FMIUInt8Type) {
 
-					const fmi3UInt8 uint8Value = (fmi3UInt8)value;
-					CALL(FMI3SetUInt8(instance, &vr, 1, &uint8Value, 1));
+					CALL(FMI3SetUInt8(instance, &vr, 1, (const fmi3UInt8*)value, 1));
 
 				} else if (type == FMIInt16Type) {
 
-					const fmi3Int16 int16Value = (fmi3Int16)value;
-					CALL(FMI3SetInt16(instance, &vr, 1, &int16Value, 1));
+					CALL(FMI3SetInt16(instance, &vr, 1, (const fmi3Int16*)value, 1));
 
 				} else if (type == FMIUInt16Type) {
 
-					const fmi3UInt16 uint16Value = (fmi3UInt16)value;
-					CALL(FMI3SetUInt16(instance, &vr, 1, &uint16Value, 1));
+					CALL(FMI3SetUInt16(instance, &vr, 1, (const fmi3UInt16*)value, 1));
 
 				} else if (type == FMIInt32Type) {
 
-					const fmi3Int32 int32Value = (fmi3Int32)value;
-					CALL(FMI3SetInt32(instance, &vr, 1, &int32Value, 1));
+					CALL(FMI3SetInt32(instance, &vr, 1, (const fmi3Int32*)value, 1));
 
 				} else if (type == FMIUInt32Type) {
 
-					const fmi3UInt32 uint32Value = (fmi3UInt32)value;
-					CALL(FMI3SetUInt32(instance, &vr, 1, &uint32Value, 1));
+					CALL(FMI3SetUInt32(instance, &vr, 1, (const fmi3UInt32*)value, 1));
 
 				} else if (type == FMIInt64Type) {
 
-					const fmi3Int64 int64Value = (fmi3Int64)value;
-					CALL(FMI3SetInt64(instance, &vr, 1, &int64Value, 1));
+					CALL(FMI3SetInt64(instance, &vr, 1, (const fmi3Int64*)value, 1));
 
 				} else if (type == FMIUInt64Type) {
 
-					const fmi3UInt64 uint64Value = (fmi3UInt64)value;
-					CALL(FMI3SetUInt64(instance, &vr, 1, &uint64Value, 1));
+					CALL(FMI3SetUInt64(instance, &vr, 1, (const fmi3UInt64*)value, 1));
 
 				} else if (type == FMIBooleanType) {
 
-					const fmi3Boolean booleanValue = value != fmi3False ? fmi3True : fmi3False;
-					CALL(FMI3SetBoolean(instance, &vr, 1, &booleanValue, 1));
+					const fmi3Boolean fmi3BooleanValue = booleanValue;
+					CALL(FMI3SetBoolean(instance, &vr, 1, &fmi3BooleanValue, 1));
 
 				}
 
 			}
 		}
-		
+
 	}
 
 TERMINATE:
@@ -1,22 +1,54 @@
 #pragma once
 
+#include <stdint.h>
+
 #include "FMIModelDescription.h"
 
 
+typedef struct FMUInputStream FMUInputStream;
+
+typedef struct FMUInputStrings FMUInputStrings;
+
 typedef struct {
-	
+
 	size_t nVariables;
 	const FMIModelVariable** variables;
 	size_t nRows;
 	double* time;
-	double* values;
+
+	// one column per variable in the native type of the variable (bitsets for Boolean and Clock)
+	void** values;
+
+	// interned values of the String and Binary columns
+	FMUInputStrings* strings;
+
+	// memory mapped binary input file (NULL if the input has been parsed)
+	void* mapping;
+	size_t mappingSize;
+
+	// last value set for each discrete column (set calls are skipped if the value has not changed)
+	bool* applied;
+	uint64_t* appliedValues;
+
+	// sliding window state (NULL if all rows are resident)
+	FMUInputStream* stream;
 
 } FMUStaticInput;
 
 FMUStaticInput* FMIReadInput(const FMIModelDescription* modelDescription, const char* filename);
 
+FMUStaticInput* FMIOpenInputStream(const FMIModelDescription* modelDescription, const char* filename);
+
+FMIStatus FMIWriteBinaryInput(const FMUStaticInput* input, const char* filename);
+
 void FMIFreeInput(FMUStaticInput* input);
 
-double FMINextInputEvent(const FMUStaticInput* input, double time);
+FMIStatus FMINextInputEvent(FMUStaticInput* input, double time, double* nextEventTime);
+
+FMIStatus FMIApplyInput(FMIInstance* instance, FMUStaticInput* input, double time, bool discrete, bool continuous, bool afterEvent);
+
+// restore the discrete input values that have been set (e.g. from a checkpoint)
+FMIStatus FMIRestoreAppliedInput(FMUStaticInput* input, const bool* applied, const uint64_t* appliedValues);
 
-FMIStatus FMIApplyInput(FMIInstance* instance, const FMUStaticInput* input, double time, bool discrete, bool continuous, bool afterEvent);
+// forget the discrete input values that have been set (e.g. before the next ensemble member is simulated)
+void FMIResetAppliedInput(FMUStaticInput* input);
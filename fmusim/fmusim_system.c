@@ -0,0 +1,762 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI2.h"
+#include "FMI3.h"
+#include "FMIThreadPool.h"
+
+#include "fmusim_system.h"
+
+
+#define FMI_PATH_MAX 4096
+
+#define CALL(f) do { status = f; if (status > FMIOK) goto TERMINATE; } while (0)
+
+
+typedef struct {
+
+    FMISystem* system;
+    const FMISimulationSettings* settings;
+    double time;
+
+    // the components of level i are order[levelStart[i]] ... order[levelStart[i + 1] - 1]
+    size_t nLevels;
+    size_t* levelStart;
+    size_t* order;
+
+    // the connections to the components of level i are connectionOrder[connectionStart[i]] ... connectionOrder[connectionStart[i + 1] - 1]
+    size_t* connectionStart;
+    size_t* connectionOrder;
+
+    // components of the current step tasks and whether they have to get their outputs for the next level
+    const size_t* tasks;
+    bool getOutputs;
+
+    // whether cycles have been broken at connections that use the outputs of the previous communication point
+    bool brokenCycles;
+
+} FMIMaster;
+
+typedef struct {
+
+    const FMISystem* system;
+    unsigned char* state;
+    size_t* path;
+    size_t nPath;
+    size_t nLoops;
+
+} FMILoopSearch;
+
+// get the connected outputs of one type with a single call
+static FMIStatus getOutputs(FMIInstance* S, FMIConnectionType type, FMIConnectionBuffer* buffer) {
+
+    const size_t n = buffer->nValues;
+
+    if (n == 0) {
+        return FMIOK;
+    }
+
+    if (S->fmiVersion == FMIVersion2) {
+        switch (type) {
+        case FMIRealConnection:    return FMI2GetReal(S, buffer->valueReferences, n, (fmi2Real*)buffer->values);
+        case FMIIntegerConnection: return FMI2GetInteger(S, buffer->valueReferences, n, (fmi2Integer*)buffer->values);
+        default:                   return FMI2GetBoolean(S, buffer->valueReferences, n, (fmi2Boolean*)buffer->values);
+        }
+    } else {
+        switch (type) {
+        case FMIRealConnection:    return FMI3GetFloat64(S, buffer->valueReferences, n, (fmi3Float64*)buffer->values, n);
+        case FMIIntegerConnection: return FMI3GetInt32(S, buffer->valueReferences, n, (fmi3Int32*)buffer->values, n);
+        default:                   return FMI3GetBoolean(S, buffer->valueReferences, n, (fmi3Boolean*)buffer->values, n);
+        }
+    }
+}
+
+// set the connected inputs of one type with a single call
+static FMIStatus setInputs(FMIInstance* S, FMIConnectionType type, const FMIConnectionBuffer* buffer) {
+
+    const size_t n = buffer->nValues;
+
+    if (n == 0) {
+        return FMIOK;
+    }
+
+    if (S->fmiVersion == FMIVersion2) {
+        switch (type) {
+        case FMIRealConnection:    return FMI2SetReal(S, buffer->valueReferences, n, (const fmi2Real*)buffer->values);
+        case FMIIntegerConnection: return FMI2SetInteger(S, buffer->valueReferences, n, (const fmi2Integer*)buffer->values);
+        default:                   return FMI2SetBoolean(S, buffer->valueReferences, n, (const fmi2Boolean*)buffer->values);
+        }
+    } else {
+        switch (type) {
+        case FMIRealConnection:    return FMI3SetFloat64(S, buffer->valueReferences, n, (const fmi3Float64*)buffer->values, n);
+        case FMIIntegerConnection: return FMI3SetInt32(S, buffer->valueReferences, n, (const fmi3Int32*)buffer->values, n);
+        default:                   return FMI3SetBoolean(S, buffer->valueReferences, n, (const fmi3Boolean*)buffer->values, n);
+        }
+    }
+}
+
+static FMIStatus getConnectedOutputs(FMIComponent* component) {
+
+    FMIStatus status = FMIOK;
+
+    for (FMIConnectionType type = 0; type < FMINConnectionTypes; type++) {
+        CALL(getOutputs(component->instance, type, &component->outputs[type]));
+    }
+
+TERMINATE:
+    return status;
+}
+
+static FMIStatus setConnectedInputs(FMIComponent* component) {
+
+    FMIStatus status = FMIOK;
+
+    for (FMIConnectionType type = 0; type < FMINConnectionTypes; type++) {
+        CALL(setInputs(component->instance, type, &component->inputs[type]));
+    }
+
+TERMINATE:
+    return status;
+}
+
+// copy the output values to the connected input values of the components of a level
+static void transferValues(const FMIMaster* master, size_t level) {
+
+    FMISystem* system = master->system;
+
+    for (size_t i = master->connectionStart[level]; i < master->connectionStart[level + 1]; i++) {
+
+        const FMIConnection* connection = &system->connections[master->connectionOrder[i]];
+
+        const FMIComponent* start = &system->components[connection->startComponent];
+        FMIComponent* end = &system->components[connection->endComponent];
+
+        const void* src = start->outputs[connection->type].values;
+        void* dst = end->inputs[connection->type].values;
+
+        const size_t j = connection->startIndex;
+        const size_t k = connection->endIndex;
+
+        if (connection->type == FMIRealConnection) {
+            ((double*)dst)[k] = ((const double*)src)[j];
+        } else if (connection->type == FMIIntegerConnection) {
+            ((int32_t*)dst)[k] = ((const int32_t*)src)[j];
+        } else {
+
+            // the size of Booleans differs between FMI 2.0 and FMI 3.0
+            const bool value = start->instance->fmiVersion == FMIVersion3 ? ((const fmi3Boolean*)src)[j] : ((const fmi2Boolean*)src)[j] != fmi2False;
+
+            if (end->instance->fmiVersion == FMIVersion3) {
+                ((fmi3Boolean*)dst)[k] = value;
+            } else {
+                ((fmi2Boolean*)dst)[k] = value ? fmi2True : fmi2False;
+            }
+        }
+    }
+}
+
+// instantiate the FMU, apply the start values and enter initialization mode
+static FMIStatus initialize(FMIComponent* component, const FMISimulationSettings* settings) {
+
+    FMIStatus status = FMIOK;
+
+    FMIInstance* S = component->instance;
+    const FMIModelDescription* modelDescription = component->modelDescription;
+
+    char resourcePath[FMI_PATH_MAX] = "";
+
+#ifdef _WIN32
+    snprintf(resourcePath, FMI_PATH_MAX, "%s\\resources\\", component->unzipdir);
+#else
+    snprintf(resourcePath, FMI_PATH_MAX, "%s/resources/", component->unzipdir);
+#endif
+
+    FMISimulationSettings componentSettings = *settings;
+
+    componentSettings.nStartValues   = component->nStartValues;
+    componentSettings.startVariables = component->startVariables;
+    componentSettings.startValues    = component->startValues;
+
+    if (modelDescription->fmiVersion == FMIVersion2) {
+
+        char resourceURI[FMI_PATH_MAX] = "";
+
+        CALL(FMIPathToURI(resourcePath, resourceURI, FMI_PATH_MAX));
+
+        CALL(FMI2Instantiate(S,
+            resourceURI,                          // fmuResourceLocation
+            fmi2CoSimulation,                     // fmuType
+            modelDescription->instantiationToken, // fmuGUID
+            fmi2False,                            // visible
+            fmi2False                             // loggingOn
+        ));
+
+        CALL(applyStartValues(S, &componentSettings));
+        CALL(FMI2SetupExperiment(S, settings->tolerance > 0, settings->tolerance, settings->startTime, fmi2False, 0));
+        CALL(FMI2EnterInitializationMode(S));
+
+    } else {
+
+        CALL(FMI3InstantiateCoSimulation(S,
+            modelDescription->instantiationToken,  // instantiationToken
+            resourcePath,                          // resourcePath
+            fmi3False,                             // visible
+            fmi3False,                             // loggingOn
+            fmi3False,                             // eventModeUsed
+            fmi3False,                             // earlyReturnAllowed
+            NULL,                                  // requiredIntermediateVariables
+            0,                                     // nRequiredIntermediateVariables
+            NULL                                   // intermediateUpdate
+        ));
+
+        CALL(applyStartValues(S, &componentSettings));
+        CALL(FMI3EnterInitializationMode(S, settings->tolerance > 0, settings->tolerance, settings->startTime, fmi3False, 0));
+    }
+
+TERMINATE:
+    return status;
+}
+
+// record the outputs of an FMU and get the values of its connected outputs
+static void sampleComponent(void* context, size_t index) {
+
+    FMIMaster* master = (FMIMaster*)context;
+    FMIComponent* component = &master->system->components[index];
+
+    component->status = FMISample(component->instance, master->time, component->recorder);
+
+    if (component->status <= FMIWarning) {
+        component->status = getConnectedOutputs(component);
+    }
+}
+
+// set the connected inputs of an FMU and compute the next communication step
+static void stepComponent(void* context, size_t index) {
+
+    FMIMaster* master = (FMIMaster*)context;
+    FMIComponent* component = &master->system->components[master->tasks[index]];
+    FMIInstance* S = component->instance;
+    const double stepSize = master->settings->outputInterval;
+
+    FMIStatus status = FMIOK;
+
+    CALL(setConnectedInputs(component));
+
+    if (S->fmiVersion == FMIVersion2) {
+
+        status = FMI2DoStep(S, master->time, stepSize, fmi2True);
+
+        if (status == FMIDiscard) {
+
+            fmi2Boolean terminated = fmi2False;
+
+            CALL(FMI2GetBooleanStatus(S, fmi2Terminated, &terminated));
+
+            component->terminated = terminated;
+        }
+
+    } else {
+
+        fmi3Boolean eventEncountered, terminateSimulation, earlyReturn;
+        fmi3Float64 lastSuccessfulTime;
+
+        CALL(FMI3DoStep(S,
+            master->time,          // currentCommunicationPoint
+            stepSize,              // communicationStepSize
+            fmi3True,              // noSetFMUStatePriorToCurrentPoint
+            &eventEncountered,     // eventEncountered
+            &terminateSimulation,  // terminate
+            &earlyReturn,          // earlyReturn
+            &lastSuccessfulTime    // lastSuccessfulTime
+        ));
+
+        component->terminated = terminateSimulation;
+    }
+
+    if (master->getOutputs && status <= FMIWarning) {
+        CALL(getConnectedOutputs(component));
+    }
+
+TERMINATE:
+    component->status = status;
+}
+
+// the worst status of the last tasks (a Discard only ends the simulation if an FMU has terminated)
+static FMIStatus taskStatus(const FMISystem* system, bool* terminated) {
+
+    FMIStatus status = FMIOK;
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        const FMIComponent* component = &system->components[i];
+
+        if (component->status > status && component->status != FMIDiscard) {
+            status = component->status;
+        }
+
+        if (component->terminated) {
+            *terminated = true;
+        }
+    }
+
+    return status;
+}
+
+// whether an output of an FMU depends directly on one of its inputs
+static bool hasDirectFeedthrough(const FMIModelDescription* modelDescription, const FMIModelVariable* output, const FMIModelVariable* input) {
+
+    for (size_t i = 0; i < modelDescription->nOutputs; i++) {
+
+        const FMIUnknown* unknown = &modelDescription->outputs[i];
+
+        if (unknown->modelVariable != output) {
+            continue;
+        }
+
+        if (!unknown->hasDependencies) {
+            return true;
+        }
+
+        for (size_t j = 0; j < unknown->nDependencies; j++) {
+            if (unknown->dependencies[j] == input) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // an output that is not listed in the model structure may depend on all inputs
+    return true;
+}
+
+// depth-first search for cycles of connections that are closed by direct feedthrough
+static void findAlgebraicLoops(FMILoopSearch* search, size_t index) {
+
+    const FMISystem* system = search->system;
+    const FMIConnection* connection = &system->connections[index];
+    const FMIComponent* component = &system->components[connection->endComponent];
+
+    search->state[index] = 1;
+    search->path[search->nPath++] = index;
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* next = &system->connections[i];
+
+        if (next->startComponent != connection->endComponent ||
+            !hasDirectFeedthrough(component->modelDescription, next->startVariable, connection->endVariable)) {
+            continue;
+        }
+
+        if (search->state[i] == 0) {
+
+            findAlgebraicLoops(search, i);
+
+        } else if (search->state[i] == 1) {
+
+            printf("Algebraic loop:");
+
+            size_t j = search->nPath;
+
+            while (search->path[j - 1] != i) {
+                j--;
+            }
+
+            for (size_t k = j - 1; k < search->nPath; k++) {
+                const FMIConnection* c = &system->connections[search->path[k]];
+                printf("%s %s.%s -> %s.%s", k < j ? "" : ",", system->components[c->startComponent].name, c->startVariable->name,
+                    system->components[c->endComponent].name, c->endVariable->name);
+            }
+
+            printf("\n");
+
+            search->nLoops++;
+        }
+    }
+
+    search->nPath--;
+    search->state[index] = 2;
+}
+
+// whether an output of an FMU depends directly on one of its inputs that are connected to the unsorted components
+static bool dependsOnUnsortedInputs(const FMISystem* system, const size_t* levels, const bool* broken, size_t index, const FMIModelVariable* output) {
+
+    const FMIComponent* component = &system->components[index];
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        if (connection->endComponent != index || broken[i] || levels[connection->startComponent] != SIZE_MAX) {
+            continue;
+        }
+
+        if (hasDirectFeedthrough(component->modelDescription, output, connection->endVariable)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Break a cycle of the unsorted components at a connection whose output does not depend directly on the inputs
+   of its FMU in the cycle, so the output of the previous communication point is the current value. If every
+   output in the cycle has direct feedthrough, all unresolved inputs of the component with the fewest of them are
+   broken. */
+static void breakCycle(const FMISystem* system, const size_t* levels, size_t* nInputs, bool* broken) {
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        if (broken[i] || connection->startComponent == connection->endComponent ||
+            levels[connection->startComponent] != SIZE_MAX || levels[connection->endComponent] != SIZE_MAX) {
+            continue;
+        }
+
+        if (!dependsOnUnsortedInputs(system, levels, broken, connection->startComponent, connection->startVariable)) {
+            broken[i] = true;
+            nInputs[connection->endComponent]--;
+            return;
+        }
+    }
+
+    size_t next = SIZE_MAX;
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+        if (levels[i] == SIZE_MAX && (next == SIZE_MAX || nInputs[i] < nInputs[next])) {
+            next = i;
+        }
+    }
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        if (connection->endComponent == next && !broken[i] && connection->startComponent != next &&
+            levels[connection->startComponent] == SIZE_MAX) {
+            broken[i] = true;
+            nInputs[next]--;
+        }
+    }
+}
+
+/* Sort the components into levels. With Gauss-Seidel every component is in a later level than the components
+   connected to its inputs, the components of a level step in parallel and the levels one after another. A cycle
+   is broken at a connection that then uses the outputs of the previous communication point (see breakCycle()).
+   With Jacobi all components are in the same level. */
+static FMIStatus computeLevels(FMIMaster* master, FMIMasterAlgorithm algorithm) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISystem* system = master->system;
+    const size_t nComponents = system->nComponents;
+    const size_t nConnections = system->nConnections;
+
+    size_t* levels = (size_t*)calloc(nComponents, sizeof(size_t));
+    size_t* nInputs = (size_t*)calloc(nComponents, sizeof(size_t));
+    bool* broken = (bool*)calloc(nConnections, sizeof(bool));
+
+    master->levelStart = (size_t*)calloc(nComponents + 1, sizeof(size_t));
+    master->order = (size_t*)calloc(nComponents, sizeof(size_t));
+    master->connectionStart = (size_t*)calloc(nComponents + 1, sizeof(size_t));
+    master->connectionOrder = (size_t*)calloc(nConnections, sizeof(size_t));
+
+    if (!levels || !nInputs || !master->levelStart || !master->order || !master->connectionStart || (nConnections > 0 && (!master->connectionOrder || !broken))) {
+        printf("Failed to allocate the levels of the system.\n");
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    if (algorithm == FMIJacobi) {
+
+        master->nLevels = 1;
+
+    } else {
+
+        for (size_t i = 0; i < nComponents; i++) {
+            levels[i] = SIZE_MAX;
+        }
+
+        for (size_t i = 0; i < nConnections; i++) {
+            const FMIConnection* connection = &system->connections[i];
+            if (connection->startComponent != connection->endComponent) {
+                nInputs[connection->endComponent]++;
+            }
+        }
+
+        for (size_t nSorted = 0; nSorted < nComponents;) {
+
+            const size_t level = master->nLevels;
+
+            size_t nReady = 0;
+
+            for (size_t i = 0; i < nComponents; i++) {
+                if (levels[i] == SIZE_MAX && nInputs[i] == 0) {
+                    levels[i] = level;
+                    nReady++;
+                }
+            }
+
+            // all remaining components are part of a cycle
+            if (nReady == 0) {
+                breakCycle(system, levels, nInputs, broken);
+                master->brokenCycles = true;
+                continue;
+            }
+
+            nSorted += nReady;
+            master->nLevels++;
+
+            // resolve the inputs of the components in later levels
+            for (size_t i = 0; i < nConnections; i++) {
+
+                const FMIConnection* connection = &system->connections[i];
+
+                if (!broken[i] && levels[connection->startComponent] == level && levels[connection->endComponent] == SIZE_MAX) {
+                    nInputs[connection->endComponent]--;
+                }
+            }
+        }
+    }
+
+    // sort the components and connections by level
+    for (size_t i = 0; i < nComponents; i++) {
+        master->levelStart[levels[i] + 1]++;
+    }
+
+    for (size_t i = 0; i < nConnections; i++) {
+        master->connectionStart[levels[system->connections[i].endComponent] + 1]++;
+    }
+
+    for (size_t i = 0; i < master->nLevels; i++) {
+        master->levelStart[i + 1] += master->levelStart[i];
+        master->connectionStart[i + 1] += master->connectionStart[i];
+    }
+
+    memset(nInputs, 0, nComponents * sizeof(size_t));
+
+    for (size_t i = 0; i < nComponents; i++) {
+        master->order[master->levelStart[levels[i]] + nInputs[levels[i]]++] = i;
+    }
+
+    memset(nInputs, 0, nComponents * sizeof(size_t));
+
+    for (size_t i = 0; i < nConnections; i++) {
+        const size_t level = levels[system->connections[i].endComponent];
+        master->connectionOrder[master->connectionStart[level] + nInputs[level]++] = i;
+    }
+
+TERMINATE:
+    free(levels);
+    free(nInputs);
+    free(broken);
+
+    return status;
+}
+
+// insert "_[name]" before the extension of the output file
+static void componentOutputFile(const char* outputFile, const char* name, char* path, size_t size) {
+
+    const char* extension = strrchr(outputFile, '.');
+    const char* separator = strrchr(outputFile, '/');
+
+    if (!extension || (separator && separator > extension)) {
+        extension = outputFile + strlen(outputFile);
+    }
+
+    snprintf(path, size, "%.*s_%s%s", (int)(extension - outputFile), outputFile, name, extension);
+}
+
+FMIStatus simulateSystem(FMISystem* system, const char* outputFile, const FMISimulationSettings* settings, FMIMasterAlgorithm algorithm) {
+
+    FMIStatus status = FMIOK;
+
+    size_t nInstantiated = 0;
+    bool terminated = false;
+    FMIThreadPool* pool = NULL;
+
+    FMIMaster master = {
+        .system   = system,
+        .settings = settings,
+        .time     = settings->startTime
+    };
+
+    FMILoopSearch search = {
+        .system = system,
+        .state  = (unsigned char*)calloc(system->nConnections, sizeof(unsigned char)),
+        .path   = (size_t*)calloc(system->nConnections, sizeof(size_t))
+    };
+
+    if (system->nConnections > 0 && (!search.state || !search.path)) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+        if (search.state[i] == 0) {
+            findAlgebraicLoops(&search, i);
+        }
+    }
+
+    if (search.nLoops > 0) {
+        printf("The algebraic loops are broken by using the outputs of the previous communication point.\n");
+    }
+
+    CALL(computeLevels(&master, algorithm));
+
+    size_t nThreads = 0;
+
+    for (size_t i = 0; i < master.nLevels; i++) {
+        const size_t nTasks = master.levelStart[i + 1] - master.levelStart[i];
+        if (nTasks > nThreads + 1) {
+            nThreads = nTasks - 1;
+        }
+    }
+
+    // the calling thread steps one of the FMUs of a level
+    pool = FMICreateThreadPool(nThreads);
+
+    if (!pool) {
+        printf("Failed to create the thread pool.\n");
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+        const FMIModelDescription* modelDescription = component->modelDescription;
+
+        size_t nOutputVariables = 0;
+        const FMIModelVariable** outputVariables = (const FMIModelVariable**)calloc(modelDescription->nModelVariables, sizeof(FMIModelVariable*));
+
+        if (!outputVariables) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        for (size_t j = 0; j < modelDescription->nModelVariables; j++) {
+            if (modelDescription->modelVariables[j].causality == FMIOutput) {
+                outputVariables[nOutputVariables++] = &modelDescription->modelVariables[j];
+            }
+        }
+
+        char path[FMI_PATH_MAX] = "";
+
+        componentOutputFile(outputFile, component->name, path, FMI_PATH_MAX);
+
+        component->recorder = FMICreateRecorder(nOutputVariables, outputVariables, path, false);
+
+        if (!component->recorder) {
+            free(outputVariables);
+            printf("Failed to open result file %s for writing.\n", path);
+            status = FMIError;
+            goto TERMINATE;
+        }
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+        nInstantiated++;
+        CALL(initialize(&system->components[i], settings));
+    }
+
+    // propagate the initial outputs to the connected inputs level by level
+    for (size_t i = 0; i < system->nComponents; i++) {
+        CALL(getConnectedOutputs(&system->components[i]));
+    }
+
+    // the outputs at the broken connections are only up to date after the first pass
+    for (int pass = 0; pass < (master.brokenCycles ? 2 : 1); pass++) {
+
+        for (size_t i = 0; i < master.nLevels; i++) {
+
+            transferValues(&master, i);
+
+            for (size_t j = master.levelStart[i]; j < master.levelStart[i + 1]; j++) {
+                FMIComponent* component = &system->components[master.order[j]];
+                CALL(setConnectedInputs(component));
+                CALL(getConnectedOutputs(component));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        if (component->instance->fmiVersion == FMIVersion2) {
+            CALL(FMI2ExitInitializationMode(component->instance));
+        } else {
+            CALL(FMI3ExitInitializationMode(component->instance));
+        }
+    }
+
+    for (unsigned long step = 0;; step++) {
+
+        master.time = settings->startTime + step * settings->outputInterval;
+
+        FMIRunTasks(pool, sampleComponent, &master, system->nComponents);
+
+        CALL(taskStatus(system, &terminated));
+
+        if (terminated || master.time >= settings->stopTime) {
+            break;
+        }
+
+        // the levels step one after another with the latest outputs of the previous levels
+        for (size_t i = 0; i < master.nLevels; i++) {
+
+            transferValues(&master, i);
+
+            master.tasks = &master.order[master.levelStart[i]];
+            master.getOutputs = i + 1 < master.nLevels;
+
+            FMIRunTasks(pool, stepComponent, &master, master.levelStart[i + 1] - master.levelStart[i]);
+
+            CALL(taskStatus(system, &terminated));
+        }
+    }
+
+TERMINATE:
+
+    for (size_t i = 0; i < nInstantiated; i++) {
+
+        FMIInstance* S = system->components[i].instance;
+
+        if (!S->component) {
+            continue;
+        }
+
+        if (S->fmiVersion == FMIVersion2) {
+            if (status < FMIError) {
+                FMI2Terminate(S);
+            }
+            if (status != FMIFatal) {
+                FMI2FreeInstance(S);
+            }
+        } else {
+            if (status < FMIError) {
+                FMI3Terminate(S);
+            }
+            if (status != FMIFatal) {
+                FMI3FreeInstance(S);
+            }
+        }
+    }
+
+    FMIFreeThreadPool(pool);
+
+    free(search.state);
+    free(search.path);
+
+    free(master.levelStart);
+    free(master.order);
+    free(master.connectionStart);
+    free(master.connectionOrder);
+
+    return status;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FMISystem.h"
+#include "fmusim.h"
+
+
+typedef enum {
+
+    // all FMUs step in parallel with the outputs of the previous communication point
+    FMIJacobi,
+
+    // the FMUs step in the order of their connections, independent FMUs in parallel
+    FMIGaussSeidel
+
+} FMIMasterAlgorithm;
+
+// simulate the FMUs of a system and write the outputs of each FMU to outputFile with the name of the FMU appended
+FMIStatus simulateSystem(FMISystem* system, const char* outputFile, const FMISimulationSettings* settings, FMIMasterAlgorithm algorithm);
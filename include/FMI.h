@@ -108,6 +108,8 @@ typedef void FMILogFunctionCall(FMIInstance *instance, FMIStatus status, const c
 
 typedef void FMILogMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message);
 
+typedef void FMIStepFinished(FMIInstance *instance, FMIStatus status);
+
 struct FMIInstance_ {
 
     FMI1Functions *fmi1Functions;
@@ -125,6 +127,9 @@ struct FMIInstance_ {
     FMILogMessage      *logMessage;
     FMILogFunctionCall *logFunctionCall;
 
+    // called when an asynchronous fmi2DoStep() has finished (set before FMI2Instantiate() to enable it)
+    FMIStepFinished    *stepFinished;
+
     double time;
 
     char* logMessageBuffer;
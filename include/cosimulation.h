@@ -5,3 +5,8 @@
 #define EPSILON (FIXED_SOLVER_STEP * 1e-6)
 
 void doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent);
+
+// integrate up to the next communication point without the event checks and intermediate updates of
+// doFixedStep() (if the model defines FAST_FIXED_STEPS and has no event indicators, every step still
+// exchanges the derivatives and states with getDerivatives() and setContinuousStates())
+void doFixedSteps(ModelInstance *comp, double nextCommunicationPoint);
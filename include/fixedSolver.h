@@ -0,0 +1,10 @@
+#pragma once
+
+// internal solvers of the Co-Simulation interface (selected with FIXED_SOLVER)
+#define FIXED_SOLVER_EULER 0  // forward Euler
+#define FIXED_SOLVER_RK4   1  // classic Runge-Kutta of order 4
+#define FIXED_SOLVER_RK45  2  // Dormand-Prince 5(4) with adaptive sub-steps
+
+#ifndef FIXED_SOLVER
+#define FIXED_SOLVER FIXED_SOLVER_EULER
+#endif
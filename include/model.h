@@ -10,8 +10,25 @@
 #include <stdbool.h> // for bool
 #include <stdint.h>
 
+#include "fixedSolver.h"
 #include "config.h"
 
+#if defined(ENSEMBLE_VARIABLES) && !defined(EQUATION_BLOCKS)
+#error "ENSEMBLE_VARIABLES requires EQUATION_BLOCKS"
+#endif
+
+#if defined(ENSEMBLE) && !defined(EQUATION_BLOCKS)
+#error "ENSEMBLE requires EQUATION_BLOCKS"
+#endif
+
+#if defined(ENSEMBLE) && !defined(ENSEMBLE_VARIABLES)
+#error "ENSEMBLE requires ENSEMBLE_VARIABLES"
+#endif
+
+#if defined(ENSEMBLE) && FIXED_SOLVER != FIXED_SOLVER_EULER
+#error "ENSEMBLE requires FIXED_SOLVER=EULER"
+#endif
+
 #if FMI_VERSION == 1
 
 #define not_modelError (Instantiated| Initialized | Terminated)
@@ -101,6 +118,65 @@ typedef void (*intermediateUpdateType) (void *instanceEnvironment,
 
 typedef void(*clockUpdateType) (void *instanceEnvironment);
 
+// the part of a model instance that is saved and restored by getFMUState() and setFMUState()
+typedef struct FMUStateSnapshot {
+
+    double startTime;
+    double stopTime;
+    double time;
+    Status status;
+    ModelState state;
+
+    // event info
+    bool newDiscreteStatesNeeded;
+    bool terminateSimulation;
+    bool nominalsOfContinuousStatesChanged;
+    bool valuesOfContinuousStatesChanged;
+    bool nextEventTimeDefined;
+    double nextEventTime;
+    bool clocksTicked;
+
+    uint32_t dirtyBlocks;
+
+    ModelData modelData;
+
+#ifdef MODEL_BUFFER
+    char* buffer;
+    size_t bufferSize;
+#endif
+
+#if NZ > 0
+    double z[NZ];
+#endif
+
+    uint64_t nSteps;
+    double solverStepSize;
+
+    // next snapshot in the pool of free snapshots
+    struct FMUStateSnapshot* next;
+
+} FMUStateSnapshot;
+
+#ifdef RESOURCE_FILES
+// index of the resource files listed in RESOURCE_FILES(X) as X(name, filename)
+typedef enum {
+#define RESOURCE_INDEX(name, filename) resource_##name,
+    RESOURCE_FILES(RESOURCE_INDEX)
+#undef RESOURCE_INDEX
+    NR
+} ResourceIndex;
+
+// read-only contents of a resource file that is mapped into memory when the model is instantiated
+// (the mapping is shared by all instances in the process that use the same file)
+typedef struct {
+    const char *data;
+    size_t size;
+} ResourceFile;
+
+// the resource file "name" of the current instance
+#define R(name) (comp->resources[resource_##name])
+#endif
+
 typedef struct {
 
     double startTime;
@@ -135,10 +211,17 @@ typedef struct {
     double nextEventTime;
     bool clocksTicked;
 
-    bool isDirtyValues;
+    // equation blocks that have to be recalculated before dependent variables can be read
+    uint32_t dirtyBlocks;
 
     ModelData modelData;
 
+#ifdef MODEL_BUFFER
+    // variables whose size depends on structural parameters (allocated with resizeModelBuffer())
+    char* buffer;
+    size_t bufferSize;
+#endif
+
 #if NZ > 0
     // event indicators
     double z[NZ];
@@ -147,12 +230,60 @@ typedef struct {
     // internal solver steps
     uint64_t nSteps;
 
+    // step size of the adaptive solver for the next step
+    double solverStepSize;
+
     // Co-Simulation
     bool earlyReturnAllowed;
     bool eventModeUsed;
 
+    // worker thread of the asynchronous fmi2DoStep() (NULL if steps are computed synchronously)
+    void *asyncStep;
+
+#ifdef RESOURCE_FILES
+    const ResourceFile *resources[NR];
+#endif
+
+    // snapshots freed by freeFMUState() that are reused by getFMUState()
+    FMUStateSnapshot* freeFMUStates;
+
 } ModelInstance;
 
+// all equation blocks (models that don't define EQUATION_BLOCKS have a single block)
+#define ALL_BLOCKS UINT32_MAX
+
+typedef enum {
+    Float32Type,
+    Float64Type,
+    Int8Type,
+    UInt8Type,
+    Int16Type,
+    UInt16Type,
+    Int32Type,
+    UInt32Type,
+    Int64Type,
+    UInt64Type,
+    BooleanType,
+    StringType  // always uses the get / set functions
+} VariableType;
+
+// location of a variable in ModelData (size = 0: use the get / set functions)
+typedef struct {
+    VariableType type;
+    size_t offset;
+    size_t size;
+    bool settable;
+} VariableInfo;
+
+// entry of the variable table for the variable "name" in ModelData
+#define VARIABLE(T, name, settable) { T ## Type, offsetof(ModelData, name), sizeof(((ModelData*)0)->name), settable }
+
+#ifdef VARIABLE_TABLE
+// indexed by value reference
+extern const VariableInfo variableTable[];
+extern const size_t nVariableTable;
+#endif
+
 ModelInstance *createModelInstance(
     loggerType logger,
     intermediateUpdateType intermediateUpdate,
@@ -165,12 +296,20 @@ ModelInstance *createModelInstance(
 
 void freeModelInstance(ModelInstance *comp);
 
-void reset(ModelInstance* comp);
+Status reset(ModelInstance* comp);
 
-void setStartValues(ModelInstance* comp);
+Status setStartValues(ModelInstance* comp);
 
 Status calculateValues(ModelInstance *comp);
 
+// equation blocks that depend on / are required to get the variable vr
+uint32_t dependentBlocks(ModelInstance* comp, ValueReference vr);
+uint32_t requiredBlocks(ModelInstance* comp, ValueReference vr);
+Status calculateBlocks(ModelInstance* comp, uint32_t blocks);
+
+// recalculate the dirty blocks in blocks
+Status updateValues(ModelInstance* comp, uint32_t blocks);
+
 Status getFloat32 (ModelInstance* comp, ValueReference vr, float       values[], size_t nValues, size_t *index);
 Status getFloat64 (ModelInstance* comp, ValueReference vr, double      values[], size_t nValues, size_t *index);
 Status getInt8    (ModelInstance* comp, ValueReference vr, int8_t      values[], size_t nValues, size_t *index);
@@ -199,11 +338,16 @@ Status setBoolean (ModelInstance* comp, ValueReference vr, const bool        val
 Status setString  (ModelInstance* comp, ValueReference vr, const char* const values[], size_t nValues, size_t *index);
 Status setBinary  (ModelInstance* comp, ValueReference vr, const size_t sizes[], const char* const values[], size_t nValues, size_t *index);
 
+// copy variables from / to ModelData using the variable table (returns false if the get / set functions have to be used)
+bool getVariable(ModelInstance* comp, VariableType type, ValueReference vr, void* values, size_t valueSize, size_t nValues, size_t* index);
+bool setVariable(ModelInstance* comp, VariableType type, ValueReference vr, const void* values, size_t valueSize, size_t nValues, size_t* index);
+
 Status activateClock(ModelInstance* comp, ValueReference vr);
 Status getClock(ModelInstance* comp, ValueReference vr, bool* value);
 Status setClock(ModelInstance* comp, ValueReference vr, const bool* value);
 
 Status getInterval(ModelInstance* comp, ValueReference vr, double* interval, int* qualifier);
+Status getShift(ModelInstance* comp, ValueReference vr, double* shift);
 
 Status activateModelPartition(ModelInstance* comp, ValueReference vr, double activationTime);
 
@@ -212,6 +356,8 @@ void setContinuousStates(ModelInstance *comp, const double x[], size_t nx);
 void getDerivatives(ModelInstance *comp, double dx[], size_t nx);
 Status getOutputDerivative(ModelInstance *comp, ValueReference valueReference, int order, double *value);
 Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueReference known, double *partialDerivative);
+Status getDirectionalDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, const double seed[], size_t nSeed, double sensitivity[], size_t nSensitivity);
+Status getAdjointDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, const double seed[], size_t nSeed, double sensitivity[], size_t nSensitivity);
 void getEventIndicators(ModelInstance *comp, double z[], size_t nz);
 void eventUpdate(ModelInstance *comp);
 //void updateEventTime(ModelInstance *comp);
@@ -224,12 +370,65 @@ Status setDebugLogging(ModelInstance *comp, bool loggingOn, size_t nCategories,
 void logEvent(ModelInstance *comp, const char *message, ...);
 void logError(ModelInstance *comp, const char *message, ...);
 
-void* getFMUState(ModelInstance* comp);
-void setFMUState(ModelInstance* comp, void* FMUState);
+void* allocateFMUState(ModelInstance* comp);
+void* getFMUState(ModelInstance* comp, void* FMUState);
+Status setFMUState(ModelInstance* comp, void* FMUState);
+void freeFMUState(ModelInstance* comp, void* FMUState);
+
+size_t serializedFMUStateSize(const void* FMUState);
+void serializeFMUState(const void* FMUState, char* buffer);
+Status deserializeFMUState(ModelInstance* comp, const char* buffer, size_t size, void* FMUState);
+
+#ifdef MODEL_BUFFER
+// resize the buffer of the variables whose size depends on structural parameters (the model initializes the contents)
+Status resizeModelBuffer(ModelInstance* comp, size_t size);
+#endif
+
+#ifdef ENSEMBLE_VARIABLES
+// variables of an ensemble of model instances in structure-of-arrays layout
+// (one array of doubles for every field listed in ENSEMBLE_VARIABLES)
+typedef struct {
+#define ENSEMBLE_ARRAY(name) double* name;
+    ENSEMBLE_VARIABLES(ENSEMBLE_ARRAY)
+#undef ENSEMBLE_ARRAY
+} EnsembleData;
+
+// calculate the equation blocks of the members [begin, end) (implemented by the model, calculateBlocks()
+// calls it with a single member whose arrays point to the model data)
+void calculateEnsembleBlocks(EnsembleData* data, uint32_t blocks, size_t begin, size_t end);
+#endif
+
+#ifdef ENSEMBLE
+typedef struct {
+
+    size_t size;
+    double startTime;
+    double time;
+    uint64_t nSteps;
+    uint32_t dirtyBlocks;
+    EnsembleData data;
+
+} Ensemble;
+
+// create an ensemble of size members that are initialized with the start values of the model
+Ensemble* createEnsemble(size_t size, double startTime);
+void freeEnsemble(Ensemble* ensemble);
+
+// get and set the values of the variable vr (listed in ENSEMBLE_VARIABLES) of all members
+Status getEnsembleFloat64(Ensemble* ensemble, ValueReference vr, double values[], size_t nValues);
+Status setEnsembleFloat64(Ensemble* ensemble, ValueReference vr, const double values[], size_t nValues);
+
+// advance all members to the next communication point with the forward Euler method
+// (integrates the states and derivatives listed in ENSEMBLE_STATES)
+void doStepEnsemble(Ensemble* ensemble, double currentCommunicationPoint, double communicationStepSize);
+#endif
 
 // shorthand to access the variables
 #define M(v) (comp->modelData.v)
 
+// shorthand to access the arrays of an ensemble
+#define E(v) (ensemble->data.v)
+
 // "stringification" macros
 #define xstr(s) str(s)
 #define str(s) #s
@@ -0,0 +1,52 @@
+#ifndef refEnsembleFunctions_h
+#define refEnsembleFunctions_h
+
+/*
+This header file declares the functions that the Co-Simulation FMUs of models that define ENSEMBLE
+export in addition to the FMI 3.0 API. They are not part of the standard.
+
+An ensemble holds many members of the same model in structure-of-arrays layout that differ only in
+their Float64 values. refDoStepEnsemble() advances all members at once with the forward Euler
+method and produces the same results as calling fmi3DoStep() on one instance per member.
+
+The functions are exported by FMUs that use the forward Euler method (FIXED_SOLVER=EULER), which
+model.h enforces for models that define ENSEMBLE.
+To declare the functions, include this file after fmi3Functions.h.
+*/
+
+#include <stddef.h>
+
+#include "fmi3PlatformTypes.h"
+#include "fmi3FunctionTypes.h"
+
+typedef void* refEnsemble;
+
+/* Create an ensemble of nMembers members that start with the start values of the model
+   (returns NULL if the instantiationToken does not match or nMembers is 0) */
+typedef refEnsemble refInstantiateEnsembleTYPE(fmi3String instantiationToken, size_t nMembers, fmi3Float64 startTime);
+
+typedef void refFreeEnsembleTYPE(refEnsemble ensemble);
+
+/* Get and set the values of a scalar Float64 variable of all members (nValues must be nMembers) */
+typedef fmi3Status refGetEnsembleFloat64TYPE(refEnsemble ensemble, fmi3ValueReference valueReference, fmi3Float64 values[], size_t nValues);
+typedef fmi3Status refSetEnsembleFloat64TYPE(refEnsemble ensemble, fmi3ValueReference valueReference, const fmi3Float64 values[], size_t nValues);
+
+typedef fmi3Status refDoStepEnsembleTYPE(refEnsemble ensemble, fmi3Float64 currentCommunicationPoint, fmi3Float64 communicationStepSize);
+
+#ifdef fmi3Functions_h
+
+#define refInstantiateEnsemble fmi3FullName(refInstantiateEnsemble)
+#define refFreeEnsemble        fmi3FullName(refFreeEnsemble)
+#define refGetEnsembleFloat64  fmi3FullName(refGetEnsembleFloat64)
+#define refSetEnsembleFloat64  fmi3FullName(refSetEnsembleFloat64)
+#define refDoStepEnsemble      fmi3FullName(refDoStepEnsemble)
+
+FMI3_Export refInstantiateEnsembleTYPE refInstantiateEnsemble;
+FMI3_Export refFreeEnsembleTYPE        refFreeEnsemble;
+FMI3_Export refGetEnsembleFloat64TYPE  refGetEnsembleFloat64;
+FMI3_Export refSetEnsembleFloat64TYPE  refSetEnsembleFloat64;
+FMI3_Export refDoStepEnsembleTYPE      refDoStepEnsemble;
+
+#endif
+
+#endif /* refEnsembleFunctions_h */
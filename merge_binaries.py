@@ -37,6 +37,9 @@ parameters = {
     'Resource': [
         '--output-interval', '1',
     ],
+    'SparseLinearTransform': [
+        '--output-interval', '1',
+    ],
     'Stair':  [
         '--output-interval', '1',
     ],
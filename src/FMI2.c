@@ -36,6 +36,17 @@ static void cb_logMessage2(fmi2ComponentEnvironment componentEnvironment, fmi2St
     instance->logMessage(instance, (FMIStatus)status, category, buf);
 }
 
+static void cb_stepFinished2(fmi2ComponentEnvironment componentEnvironment, fmi2Status status) {
+
+    if (!componentEnvironment) return;
+
+    FMIInstance *instance = componentEnvironment;
+
+    if (!instance->stepFinished) return;
+
+    instance->stepFinished(instance, (FMIStatus)status);
+}
+
 #if defined(FMI2_FUNCTION_PREFIX)
 #define LOAD_SYMBOL(f) \
 do { \
@@ -230,7 +241,7 @@ FMIStatus FMI2Instantiate(FMIInstance *instance, const char *fmuResourceLocation
     instance->fmi2Functions->callbacks.logger               = cb_logMessage2;
     instance->fmi2Functions->callbacks.allocateMemory       = calloc;
     instance->fmi2Functions->callbacks.freeMemory           = free;
-    instance->fmi2Functions->callbacks.stepFinished         = NULL;
+    instance->fmi2Functions->callbacks.stepFinished         = instance->stepFinished ? cb_stepFinished2 : NULL;
     instance->fmi2Functions->callbacks.componentEnvironment = instance;
 
     instance->component = instance->fmi2Functions->fmi2Instantiate(instance->name, fmuType, fmuGUID, fmuResourceLocation, &instance->fmi2Functions->callbacks, visible, loggingOn);
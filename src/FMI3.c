@@ -28,6 +28,22 @@ static void cb_logMessage3(fmi3InstanceEnvironment instanceEnvironment,
     instance->logMessage(instance, (FMIStatus)status, category, message);
 }
 
+// raise the status of the instance with a compare-and-swap loop because model partitions can be activated concurrently
+static void updateStatus(FMIInstance *instance, FMIStatus status) {
+#ifdef _WIN32
+    volatile LONG *target = (volatile LONG *)&instance->status;
+    LONG current = *target;
+    while ((LONG)status > current) {
+        const LONG previous = InterlockedCompareExchange(target, (LONG)status, current);
+        if (previous == current) break;
+        current = previous;
+    }
+#else
+    FMIStatus current = __atomic_load_n(&instance->status, __ATOMIC_RELAXED);
+    while (status > current && !__atomic_compare_exchange_n(&instance->status, &current, status, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+#endif
+}
+
 #if defined(FMI3_FUNCTION_PREFIX)
 #define LOAD_SYMBOL(f) \
 do { \
@@ -59,7 +75,7 @@ do { \
     if (instance->logFunctionCall) { \
         instance->logFunctionCall(instance, status, "fmi3" #f "()"); \
     } \
-    instance->status = status > instance->status ? status : instance->status; \
+    updateStatus(instance, status); \
     return status; \
 } while (0)
 
@@ -71,7 +87,7 @@ do { \
         FMIAppendToLogMessageBuffer(instance, "fmi3" #f "(" m ")", __VA_ARGS__); \
         instance->logFunctionCall(instance, status, instance->logMessageBuffer); \
     } \
-    instance->status = status > instance->status ? status : instance->status; \
+    updateStatus(instance, status); \
     return status; \
 } while (0)
 
@@ -87,7 +103,7 @@ do { \
         FMIAppendToLogMessageBuffer(instance, "}, nValues=%zu)", nValues); \
         instance->logFunctionCall(instance, status, instance->logMessageBuffer); \
     } \
-    instance->status = status > instance->status ? status : instance->status; \
+    updateStatus(instance, status); \
     return status; \
 } while (0)
 
@@ -15,6 +15,319 @@
 #define strdup _strdup
 #endif
 
+#ifdef RESOURCE_FILES
+#ifdef _WIN32
+#include <windows.h>
+#include "shlwapi.h"
+#pragma comment(lib, "shlwapi.lib")
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+// relative and absolute tolerance of the adaptive solver
+#ifndef FIXED_SOLVER_TOLERANCE
+#define FIXED_SOLVER_TOLERANCE 1e-6
+#endif
+
+#ifdef RESOURCE_FILES
+
+#define MAX_PATH_LENGTH 4096
+
+// file system path of the resource file filename
+static Status resourcePath(ModelInstance *comp, const char *filename, char *path) {
+
+    if (!comp->resourceLocation) {
+        logError(comp, "Resource location must not be NULL.");
+        return Error;
+    }
+
+#ifdef _WIN32
+
+#if FMI_VERSION < 3
+    DWORD pathLen = MAX_PATH_LENGTH;
+
+    if (PathCreateFromUrlA(comp->resourceLocation, path, &pathLen, 0) != S_OK) {
+        logError(comp, "Failed to convert resource location to file system path.");
+        return Error;
+    }
+#else
+    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH-1);
+#endif
+
+#if FMI_VERSION == 1
+    if (!PathAppendA(path, "resources") || !PathAppendA(path, filename)) return Error;
+#elif FMI_VERSION == 2
+    if (!PathAppendA(path, filename)) return Error;
+#else
+    strncat(path, filename, MAX_PATH_LENGTH-strlen(path)-1);
+#endif
+
+#else
+
+#if FMI_VERSION < 3
+    const char *scheme1 = "file:///";
+    const char *scheme2 = "file:/";
+
+    if (strncmp(comp->resourceLocation, scheme1, strlen(scheme1)) == 0) {
+        strncpy(path, &comp->resourceLocation[strlen(scheme1)] - 1, MAX_PATH_LENGTH-1);
+    } else if (strncmp(comp->resourceLocation, scheme2, strlen(scheme2)) == 0) {
+        strncpy(path, &comp->resourceLocation[strlen(scheme2) - 1], MAX_PATH_LENGTH-1);
+    } else {
+        logError(comp, "The resourceLocation must start with \"file:/\" or \"file:///\"");
+        return Error;
+    }
+
+    // decode percent encoded characters
+    char* src = path;
+    char* dst = path;
+
+    char buf[3] = { '\0', '\0', '\0' };
+
+    while (*src) {
+
+        if (*src == '%' && (buf[0] = src[1]) && (buf[1] = src[2])) {
+            *dst = (char)strtol(buf, NULL, 16);
+            src += 3;
+        } else {
+            *dst = *src;
+            src++;
+        }
+
+        dst++;
+    }
+
+    *dst = '\0';
+#else
+    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH-1);
+#endif
+
+#if FMI_VERSION == 1
+    strncat(path, "/resources/", MAX_PATH_LENGTH-strlen(path)-1);
+#elif FMI_VERSION == 2
+    strncat(path, "/", MAX_PATH_LENGTH-strlen(path)-1);
+#endif
+    strncat(path, filename, MAX_PATH_LENGTH-strlen(path)-1);
+
+#endif
+
+    path[MAX_PATH_LENGTH-1] = '\0';
+
+    return OK;
+}
+
+// map the resource file read-only into memory (empty files are not mapped)
+static Status mapResourceFile(ModelInstance *comp, const char *path, ResourceFile *resource) {
+
+    const char *data = NULL;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        logError(comp, "Failed to open resource file %s.", path);
+        return Error;
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if (mapping) {
+            // the view keeps the mapping alive after the handles have been closed
+            data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+
+        size = (size_t)fileSize.QuadPart;
+    }
+
+    CloseHandle(file);
+#else
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        logError(comp, "Failed to open resource file %s.", path);
+        return Error;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+
+        void *view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (view != MAP_FAILED) {
+            data = (const char *)view;
+        }
+
+        size = (size_t)st.st_size;
+    }
+
+    close(fd);
+#endif
+
+    if (size > 0 && !data) {
+        logError(comp, "Failed to map resource file %s.", path);
+        return Error;
+    }
+
+    resource->data = size > 0 ? data : "";
+    resource->size = size;
+
+    return OK;
+}
+
+static void unmapResourceFile(ResourceFile *resource) {
+
+    if (resource->size > 0) {
+#ifdef _WIN32
+        UnmapViewOfFile(resource->data);
+#else
+        munmap((void *)resource->data, resource->size);
+#endif
+    }
+
+    resource->data = NULL;
+    resource->size = 0;
+}
+
+// resource file that is shared by all instances in the process that use the same file
+typedef struct SharedResource {
+    ResourceFile file;
+    char *path;  // canonical path of the file
+    size_t refCount;
+    struct SharedResource *next;
+} SharedResource;
+
+// registry of the mapped resource files (guarded by resourceLock)
+static SharedResource *sharedResources = NULL;
+
+#ifdef _WIN32
+static SRWLOCK resourceLock = SRWLOCK_INIT;
+#define LOCK_RESOURCES()   AcquireSRWLockExclusive(&resourceLock)
+#define UNLOCK_RESOURCES() ReleaseSRWLockExclusive(&resourceLock)
+#else
+static pthread_mutex_t resourceLock = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_RESOURCES()   pthread_mutex_lock(&resourceLock)
+#define UNLOCK_RESOURCES() pthread_mutex_unlock(&resourceLock)
+#endif
+
+// get the shared mapping of the resource file filename and map it if it's not in the registry
+static const ResourceFile *acquireResourceFile(ModelInstance *comp, const char *filename) {
+
+    char path[MAX_PATH_LENGTH] = "";
+    char canonicalPath[MAX_PATH_LENGTH] = "";
+
+    if (resourcePath(comp, filename, path) > Warning) {
+        return NULL;
+    }
+
+    // resolve relative paths, "." and ".." (and symbolic links) to identify the file
+#ifdef _WIN32
+    if (!GetFullPathNameA(path, MAX_PATH_LENGTH, canonicalPath, NULL)) {
+        logError(comp, "Failed to open resource file %s.", path);
+        return NULL;
+    }
+#else
+    char *resolvedPath = realpath(path, NULL);
+
+    if (!resolvedPath) {
+        logError(comp, "Failed to open resource file %s.", path);
+        return NULL;
+    }
+
+    strncpy(canonicalPath, resolvedPath, MAX_PATH_LENGTH-1);
+    free(resolvedPath);
+#endif
+
+    LOCK_RESOURCES();
+
+    SharedResource *resource = sharedResources;
+
+    while (resource && strcmp(resource->path, canonicalPath)) {
+        resource = resource->next;
+    }
+
+    if (!resource) {
+
+        resource = (SharedResource *)calloc(1, sizeof(SharedResource));
+
+        if (!resource || !(resource->path = strdup(canonicalPath))) {
+            free(resource);
+            UNLOCK_RESOURCES();
+            logError(comp, "Out of memory.");
+            return NULL;
+        }
+
+        if (mapResourceFile(comp, canonicalPath, &resource->file) > Warning) {
+            free(resource->path);
+            free(resource);
+            UNLOCK_RESOURCES();
+            return NULL;
+        }
+
+        resource->next = sharedResources;
+        sharedResources = resource;
+    }
+
+    resource->refCount++;
+
+    UNLOCK_RESOURCES();
+
+    return &resource->file;
+}
+
+// release the shared mapping and unmap the file if it isn't used by any other instance
+static void releaseResourceFile(const ResourceFile *file) {
+
+    LOCK_RESOURCES();
+
+    SharedResource **link = &sharedResources;
+
+    while (*link && &(*link)->file != file) {
+        link = &(*link)->next;
+    }
+
+    SharedResource *resource = *link;
+
+    if (resource && --resource->refCount == 0) {
+        *link = resource->next;
+        unmapResourceFile(&resource->file);
+        free(resource->path);
+        free(resource);
+    }
+
+    UNLOCK_RESOURCES();
+}
+
+// map all files listed in RESOURCE_FILES for the lifetime of the instance
+static Status loadResources(ModelInstance *comp) {
+
+    const char *filenames[NR] = {
+#define RESOURCE_FILENAME(name, filename) filename,
+        RESOURCE_FILES(RESOURCE_FILENAME)
+#undef RESOURCE_FILENAME
+    };
+
+    for (size_t i = 0; i < NR; i++) {
+        if (!(comp->resources[i] = acquireResourceFile(comp, filenames[i]))) {
+            return Error;
+        }
+    }
+
+    return OK;
+}
+
+#endif
+
 
 ModelInstance *createModelInstance(
     loggerType cbLogger,
@@ -75,6 +388,7 @@ ModelInstance *createModelInstance(
         comp->logEvents            = loggingOn;
         comp->logErrors            = true; // always log errors
         comp->nSteps               = 0;
+        comp->solverStepSize       = FIXED_SOLVER_STEP;
         comp->earlyReturnAllowed   = false;
         comp->eventModeUsed        = false;
     }
@@ -96,26 +410,60 @@ ModelInstance *createModelInstance(
     comp->nextEventTimeDefined              = false;
     comp->nextEventTime                     = 0;
 
-    setStartValues(comp);
+#ifdef RESOURCE_FILES
+    if (loadResources(comp) > Warning) {
+        freeModelInstance(comp);
+        return NULL;
+    }
+#endif
+
+    if (setStartValues(comp) > Warning) {
+        freeModelInstance(comp);
+        return NULL;
+    }
 
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
 
     return comp;
 }
 
 void freeModelInstance(ModelInstance *comp) {
+
+#ifdef RESOURCE_FILES
+    for (size_t i = 0; i < NR; i++) {
+        if (comp->resources[i]) {
+            releaseResourceFile(comp->resources[i]);
+        }
+    }
+#endif
+
+    while (comp->freeFMUStates) {
+        FMUStateSnapshot* next = comp->freeFMUStates->next;
+#ifdef MODEL_BUFFER
+        free(comp->freeFMUStates->buffer);
+#endif
+        free(comp->freeFMUStates);
+        comp->freeFMUStates = next;
+    }
+
+#ifdef MODEL_BUFFER
+    free(comp->buffer);
+#endif
+
     free((void *)comp->instanceName);
+    free((void *)comp->resourceLocation);
     free(comp);
 }
 
-void reset(ModelInstance* comp) {
+Status reset(ModelInstance* comp) {
     comp->state = Instantiated;
     comp->startTime = 0.0;
     comp->time = 0.0;
     comp->nSteps = 0;
+    comp->solverStepSize = FIXED_SOLVER_STEP;
     comp->status = OK;
-    setStartValues(comp);
-    comp->isDirtyValues = true;
+    comp->dirtyBlocks = ALL_BLOCKS;
+    return setStartValues(comp);
 }
 
 bool invalidNumber(ModelInstance *comp, const char *f, const char *arg, size_t actual, size_t expected) {
@@ -254,6 +602,118 @@ void getEventIndicators(ModelInstance *comp, double z[], size_t nz) {
 }
 #endif
 
+#ifndef EQUATION_BLOCKS
+uint32_t dependentBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    UNUSED(vr);
+    return ALL_BLOCKS;
+}
+
+uint32_t requiredBlocks(ModelInstance* comp, ValueReference vr) {
+    UNUSED(comp);
+    UNUSED(vr);
+    return ALL_BLOCKS;
+}
+
+Status calculateBlocks(ModelInstance* comp, uint32_t blocks) {
+    UNUSED(blocks);
+    return calculateValues(comp);
+}
+#endif
+
+#ifdef ENSEMBLE_VARIABLES
+Status calculateBlocks(ModelInstance* comp, uint32_t blocks) {
+
+    // a single member ensemble whose arrays point to the model data
+    EnsembleData data;
+
+#define MAP_MODEL_DATA(name) data.name = &M(name);
+    ENSEMBLE_VARIABLES(MAP_MODEL_DATA)
+#undef MAP_MODEL_DATA
+
+    calculateEnsembleBlocks(&data, blocks, 0, 1);
+
+    return OK;
+}
+#endif
+
+Status updateValues(ModelInstance* comp, uint32_t blocks) {
+
+    blocks &= comp->dirtyBlocks;
+
+    if (!blocks) return OK;
+
+    Status status = calculateBlocks(comp, blocks);
+
+    if (status <= Warning) {
+        comp->dirtyBlocks &= ~blocks;
+    }
+
+    return status;
+}
+
+#ifdef VARIABLE_TABLE
+static const VariableInfo* variableInfo(VariableType type, ValueReference vr, size_t valueSize, size_t nValues, size_t index) {
+
+    if (type == StringType || (size_t)vr >= nVariableTable) return NULL;
+
+    const VariableInfo* info = &variableTable[vr];
+
+    if (info->size == 0 || info->type != type || info->size % valueSize != 0) return NULL;
+
+    // let the get / set functions report the error
+    if (index + info->size / valueSize > nValues) return NULL;
+
+    return info;
+}
+#endif
+
+bool getVariable(ModelInstance* comp, VariableType type, ValueReference vr, void* values, size_t valueSize, size_t nValues, size_t* index) {
+#ifdef VARIABLE_TABLE
+    const VariableInfo* info = variableInfo(type, vr, valueSize, nValues, *index);
+
+    if (!info) return false;
+
+    memcpy((char*)values + *index * valueSize, (const char*)&comp->modelData + info->offset, info->size);
+
+    *index += info->size / valueSize;
+
+    return true;
+#else
+    UNUSED(comp);
+    UNUSED(type);
+    UNUSED(vr);
+    UNUSED(values);
+    UNUSED(valueSize);
+    UNUSED(nValues);
+    UNUSED(index);
+    return false;
+#endif
+}
+
+bool setVariable(ModelInstance* comp, VariableType type, ValueReference vr, const void* values, size_t valueSize, size_t nValues, size_t* index) {
+#ifdef VARIABLE_TABLE
+    const VariableInfo* info = variableInfo(type, vr, valueSize, nValues, *index);
+
+    if (!info || !info->settable) return false;
+
+    memcpy((char*)&comp->modelData + info->offset, (const char*)values + *index * valueSize, info->size);
+
+    *index += info->size / valueSize;
+
+    return true;
+#else
+    UNUSED(comp);
+    UNUSED(type);
+    UNUSED(vr);
+    UNUSED(values);
+    UNUSED(valueSize);
+    UNUSED(nValues);
+    UNUSED(index);
+    return false;
+#endif
+}
+
 #define GET_NOT_ALLOWED(t) do { \
     UNUSED(vr); \
     UNUSED(values); \
@@ -452,6 +912,15 @@ Status getInterval(ModelInstance* comp, ValueReference vr, double* interval, int
 }
 #endif
 
+#ifndef GET_SHIFT
+Status getShift(ModelInstance* comp, ValueReference vr, double* shift) {
+    UNUSED(comp);
+    UNUSED(vr);
+    UNUSED(shift);
+    return Error;
+}
+#endif
+
 #ifndef ACTIVATE_MODEL_PARTITION
 Status activateModelPartition(ModelInstance* comp, ValueReference vr, double activationTime) {
     UNUSED(comp);
@@ -492,57 +961,708 @@ Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueRe
 }
 #endif
 
-void* getFMUState(ModelInstance* comp) {
+#ifndef GET_DIRECTIONAL_DERIVATIVE
+// the default implementations assemble the derivatives of scalar variables from getPartialDerivative()
+static Status checkScalarVariables(ModelInstance* comp, const unsigned int valueReferences[], size_t nValueReferences) {
+
+    for (size_t i = 0; i < nValueReferences; i++) {
 
-    ModelInstance* fmuState = (ModelInstance*)calloc(1, sizeof(ModelInstance));
+        double value;
+        size_t index = 0;
 
-    if (fmuState) {
-        memcpy(fmuState, comp, sizeof(ModelInstance));
+        // fails for value references that do not belong to a scalar Float64 variable
+        Status status = getFloat64(comp, (ValueReference)valueReferences[i], &value, 1, &index);
+
+        if (status > Warning) {
+            logError(comp, "Value reference %u does not belong to a scalar Float64 variable.", valueReferences[i]);
+            return status;
+        }
     }
 
-    return fmuState;
+    return OK;
 }
 
-void setFMUState(ModelInstance* comp, void* FMUState) {
+static Status checkDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, size_t nSeed, size_t nSensitivity, size_t nExpectedSeed, size_t nExpectedSensitivity) {
 
-    ModelInstance* s = (ModelInstance*)FMUState;
+    if (nSeed != nExpectedSeed || nSensitivity != nExpectedSensitivity) {
+        logError(comp, "Expected nSeed = %zu and nSensitivity = %zu but was %zu and %zu.", nExpectedSeed, nExpectedSensitivity, nSeed, nSensitivity);
+        return Error;
+    }
 
-    comp->startTime = s->startTime;
-    comp->stopTime = s->stopTime;
-    comp->time = s->time;
-    comp->status = s->status;
-    comp->state = s->state;
-    comp->newDiscreteStatesNeeded = s->newDiscreteStatesNeeded;
-    comp->terminateSimulation = s->terminateSimulation;
-    comp->nominalsOfContinuousStatesChanged = s->nominalsOfContinuousStatesChanged;
-    comp->valuesOfContinuousStatesChanged = s->valuesOfContinuousStatesChanged;
-    comp->nextEventTimeDefined = s->nextEventTimeDefined;
-    comp->nextEventTime = s->nextEventTime;
-    comp->clocksTicked = s->clocksTicked;
-    comp->isDirtyValues = s->isDirtyValues;
-    comp->modelData = s->modelData;
-#if NZ > 0
-    memcpy(comp->z, s->z, NZ * sizeof(double));
-#endif
-    comp->nSteps = s->nSteps;
+    Status status = checkScalarVariables(comp, unknowns, nUnknowns);
+
+    if (status > Warning) {
+        return status;
+    }
+
+    return checkScalarVariables(comp, knowns, nKnowns);
 }
 
-void doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
+Status getDirectionalDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, const double seed[], size_t nSeed, double sensitivity[], size_t nSensitivity) {
 
-#if NX > 0
-    double  x[NX] = { 0 };
-    double dx[NX] = { 0 };
+    Status status = checkDerivative(comp, unknowns, nUnknowns, knowns, nKnowns, nSeed, nSensitivity, nKnowns, nUnknowns);
 
-    getContinuousStates(comp, x, NX);
-    getDerivatives(comp, dx, NX);
+    if (status > Warning) {
+        return status;
+    }
 
-    // forward Euler step
-    for (int i = 0; i < NX; i++) {
-        x[i] += FIXED_SOLVER_STEP * dx[i];
+    for (size_t i = 0; i < nUnknowns; i++) {
+        sensitivity[i] = 0;
+        for (size_t j = 0; j < nKnowns; j++) {
+            double partialDerivative = 0;
+            Status s = getPartialDerivative(comp, (ValueReference)unknowns[i], (ValueReference)knowns[j], &partialDerivative);
+            if (s > status) status = s;
+            if (status > Warning) return status;
+            sensitivity[i] += partialDerivative * seed[j];
+        }
     }
 
-    setContinuousStates(comp, x, NX);
-#endif
+    return status;
+}
+
+Status getAdjointDerivative(ModelInstance* comp, const unsigned int unknowns[], size_t nUnknowns, const unsigned int knowns[], size_t nKnowns, const double seed[], size_t nSeed, double sensitivity[], size_t nSensitivity) {
+
+    Status status = checkDerivative(comp, unknowns, nUnknowns, knowns, nKnowns, nSeed, nSensitivity, nUnknowns, nKnowns);
+
+    if (status > Warning) {
+        return status;
+    }
+
+    for (size_t i = 0; i < nKnowns; i++) {
+        sensitivity[i] = 0;
+        for (size_t j = 0; j < nUnknowns; j++) {
+            double partialDerivative = 0;
+            Status s = getPartialDerivative(comp, (ValueReference)unknowns[j], (ValueReference)knowns[i], &partialDerivative);
+            if (s > status) status = s;
+            if (status > Warning) return status;
+            sensitivity[i] += partialDerivative * seed[j];
+        }
+    }
+
+    return status;
+}
+#endif
+
+#ifdef MODEL_BUFFER
+Status resizeModelBuffer(ModelInstance* comp, size_t size) {
+
+    if (size == comp->bufferSize) {
+        return OK;
+    }
+
+    if (size == 0) {
+        free(comp->buffer);
+        comp->buffer = NULL;
+        comp->bufferSize = 0;
+        return OK;
+    }
+
+    char* buffer = (char*)realloc(comp->buffer, size);
+
+    if (!buffer) {
+        logError(comp, "Failed to allocate %zu bytes for the model data.", size);
+        return Error;
+    }
+
+    comp->buffer = buffer;
+    comp->bufferSize = size;
+
+    return OK;
+}
+
+// copy a model buffer (the target is only reallocated if the size changes)
+static bool copyModelBuffer(char** buffer, size_t* size, const char* source, size_t sourceSize) {
+
+    if (*size != sourceSize) {
+
+        char* resized = sourceSize > 0 ? (char*)realloc(*buffer, sourceSize) : NULL;
+
+        if (sourceSize > 0 && !resized) {
+            return false;
+        }
+
+        if (sourceSize == 0) {
+            free(*buffer);
+        }
+
+        *buffer = resized;
+        *size = sourceSize;
+    }
+
+    if (sourceSize > 0) {
+        memcpy(*buffer, source, sourceSize);
+    }
+
+    return true;
+}
+#endif
+
+void* allocateFMUState(ModelInstance* comp) {
+
+    FMUStateSnapshot* s = comp->freeFMUStates;
+
+    if (s) {
+        comp->freeFMUStates = s->next;
+        s->next = NULL;
+        return s;
+    }
+
+    return calloc(1, sizeof(FMUStateSnapshot));
+}
+
+void* getFMUState(ModelInstance* comp, void* FMUState) {
+
+    // overwrite the given snapshot or take one from the pool
+    FMUStateSnapshot* s = FMUState ? (FMUStateSnapshot*)FMUState : (FMUStateSnapshot*)allocateFMUState(comp);
+
+    if (!s) {
+        return NULL;
+    }
+
+    s->startTime = comp->startTime;
+    s->stopTime = comp->stopTime;
+    s->time = comp->time;
+    s->status = comp->status;
+    s->state = comp->state;
+    s->newDiscreteStatesNeeded = comp->newDiscreteStatesNeeded;
+    s->terminateSimulation = comp->terminateSimulation;
+    s->nominalsOfContinuousStatesChanged = comp->nominalsOfContinuousStatesChanged;
+    s->valuesOfContinuousStatesChanged = comp->valuesOfContinuousStatesChanged;
+    s->nextEventTimeDefined = comp->nextEventTimeDefined;
+    s->nextEventTime = comp->nextEventTime;
+    s->clocksTicked = comp->clocksTicked;
+    s->dirtyBlocks = comp->dirtyBlocks;
+    s->modelData = comp->modelData;
+#ifdef MODEL_BUFFER
+    if (!copyModelBuffer(&s->buffer, &s->bufferSize, comp->buffer, comp->bufferSize)) {
+        logError(comp, "Failed to allocate %zu bytes for the FMU state.", comp->bufferSize);
+        if (s != FMUState) {
+            freeFMUState(comp, s);
+        }
+        return NULL;
+    }
+#endif
+#if NZ > 0
+    memcpy(s->z, comp->z, NZ * sizeof(double));
+#endif
+    s->nSteps = comp->nSteps;
+    s->solverStepSize = comp->solverStepSize;
+
+    return s;
+}
+
+Status setFMUState(ModelInstance* comp, void* FMUState) {
+
+    const FMUStateSnapshot* s = (const FMUStateSnapshot*)FMUState;
+
+#ifdef MODEL_BUFFER
+    if (!copyModelBuffer(&comp->buffer, &comp->bufferSize, s->buffer, s->bufferSize)) {
+        logError(comp, "Failed to allocate %zu bytes for the model data.", s->bufferSize);
+        return Error;
+    }
+#endif
+
+    comp->startTime = s->startTime;
+    comp->stopTime = s->stopTime;
+    comp->time = s->time;
+    comp->status = s->status;
+    comp->state = s->state;
+    comp->newDiscreteStatesNeeded = s->newDiscreteStatesNeeded;
+    comp->terminateSimulation = s->terminateSimulation;
+    comp->nominalsOfContinuousStatesChanged = s->nominalsOfContinuousStatesChanged;
+    comp->valuesOfContinuousStatesChanged = s->valuesOfContinuousStatesChanged;
+    comp->nextEventTimeDefined = s->nextEventTimeDefined;
+    comp->nextEventTime = s->nextEventTime;
+    comp->clocksTicked = s->clocksTicked;
+    comp->dirtyBlocks = s->dirtyBlocks;
+    comp->modelData = s->modelData;
+#if NZ > 0
+    memcpy(comp->z, s->z, NZ * sizeof(double));
+#endif
+    comp->nSteps = s->nSteps;
+    comp->solverStepSize = s->solverStepSize;
+
+    return OK;
+}
+
+void freeFMUState(ModelInstance* comp, void* FMUState) {
+
+    FMUStateSnapshot* s = (FMUStateSnapshot*)FMUState;
+
+    if (!s) {
+        return;
+    }
+
+    // return the snapshot to the pool
+    s->next = comp->freeFMUStates;
+    comp->freeFMUStates = s;
+}
+
+// serialized FMU state: magic, version, instantiation token, the snapshot fields (without pointers) and the model buffer
+#define FMU_STATE_MAGIC   "FMUSTATE"
+#define FMU_STATE_VERSION 2
+
+#define WRITE_VALUE(v) do { if (buffer) memcpy(buffer + n, &(v), sizeof(v)); n += sizeof(v); } while (0)
+#define READ_VALUE(v)  do { memcpy(&(v), buffer + n, sizeof(v)); n += sizeof(v); } while (0)
+
+static size_t writeFMUState(const FMUStateSnapshot* s, char* buffer) {
+
+    size_t n = 0;
+
+    const char magic[8] = FMU_STATE_MAGIC;
+    const uint32_t version = FMU_STATE_VERSION;
+    const char token[] = INSTANTIATION_TOKEN;
+    const uint32_t tokenLength = sizeof(token) - 1;
+
+    WRITE_VALUE(magic);
+    WRITE_VALUE(version);
+    WRITE_VALUE(tokenLength);
+
+    if (buffer) memcpy(buffer + n, token, tokenLength);
+    n += tokenLength;
+
+    const int32_t status = s->status;
+    const int32_t state = s->state;
+    const uint8_t flags =
+        s->newDiscreteStatesNeeded                 |
+        s->terminateSimulation               << 1 |
+        s->nominalsOfContinuousStatesChanged << 2 |
+        s->valuesOfContinuousStatesChanged   << 3 |
+        s->nextEventTimeDefined              << 4 |
+        s->clocksTicked                      << 5;
+
+    WRITE_VALUE(s->startTime);
+    WRITE_VALUE(s->stopTime);
+    WRITE_VALUE(s->time);
+    WRITE_VALUE(status);
+    WRITE_VALUE(state);
+    WRITE_VALUE(flags);
+    WRITE_VALUE(s->nextEventTime);
+    WRITE_VALUE(s->dirtyBlocks);
+    WRITE_VALUE(s->nSteps);
+    WRITE_VALUE(s->solverStepSize);
+#if NZ > 0
+    WRITE_VALUE(s->z);
+#endif
+    WRITE_VALUE(s->modelData);
+#ifdef MODEL_BUFFER
+    const uint64_t bufferSize = s->bufferSize;
+    WRITE_VALUE(bufferSize);
+    if (buffer && bufferSize > 0) memcpy(buffer + n, s->buffer, s->bufferSize);
+    n += s->bufferSize;
+#endif
+
+    return n;
+}
+
+size_t serializedFMUStateSize(const void* FMUState) {
+    static const FMUStateSnapshot empty = { 0 };
+    return writeFMUState(FMUState ? (const FMUStateSnapshot*)FMUState : &empty, NULL);
+}
+
+void serializeFMUState(const void* FMUState, char* buffer) {
+    writeFMUState((const FMUStateSnapshot*)FMUState, buffer);
+}
+
+Status deserializeFMUState(ModelInstance* comp, const char* buffer, size_t size, void* FMUState) {
+
+    FMUStateSnapshot* s = (FMUStateSnapshot*)FMUState;
+
+    size_t n = 0;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t tokenLength;
+    const char token[] = INSTANTIATION_TOKEN;
+
+    if (size < sizeof(magic) + sizeof(version) + sizeof(tokenLength)) {
+        logError(comp, "The serialized FMU state is too short.");
+        return Error;
+    }
+
+    READ_VALUE(magic);
+    READ_VALUE(version);
+    READ_VALUE(tokenLength);
+
+    if (memcmp(magic, FMU_STATE_MAGIC, sizeof(magic)) || version != FMU_STATE_VERSION) {
+        logError(comp, "The serialized FMU state has an unsupported format.");
+        return Error;
+    }
+
+    if (tokenLength != sizeof(token) - 1 || size < n + tokenLength || memcmp(buffer + n, token, tokenLength)) {
+        logError(comp, "The serialized FMU state was created by a different model.");
+        return Error;
+    }
+
+    n += tokenLength;
+
+#ifdef MODEL_BUFFER
+    // the size of the model buffer is checked when it is read
+    const bool invalidSize = size < serializedFMUStateSize(NULL);
+#else
+    const bool invalidSize = size != serializedFMUStateSize(NULL);
+#endif
+
+    if (invalidSize) {
+        logError(comp, "Expected a serialized FMU state of %zu bytes but was %zu.", serializedFMUStateSize(NULL), size);
+        return Error;
+    }
+
+    int32_t status;
+    int32_t state;
+    uint8_t flags;
+
+    READ_VALUE(s->startTime);
+    READ_VALUE(s->stopTime);
+    READ_VALUE(s->time);
+    READ_VALUE(status);
+    READ_VALUE(state);
+    READ_VALUE(flags);
+    READ_VALUE(s->nextEventTime);
+    READ_VALUE(s->dirtyBlocks);
+    READ_VALUE(s->nSteps);
+    READ_VALUE(s->solverStepSize);
+#if NZ > 0
+    READ_VALUE(s->z);
+#endif
+    READ_VALUE(s->modelData);
+#ifdef MODEL_BUFFER
+    uint64_t bufferSize;
+    READ_VALUE(bufferSize);
+
+    if (size != n + bufferSize) {
+        logError(comp, "Expected a serialized FMU state of %zu bytes but was %zu.", n + (size_t)bufferSize, size);
+        return Error;
+    }
+
+    if (!copyModelBuffer(&s->buffer, &s->bufferSize, buffer + n, (size_t)bufferSize)) {
+        logError(comp, "Failed to allocate %zu bytes for the FMU state.", (size_t)bufferSize);
+        return Error;
+    }
+#endif
+
+    s->status                            = (Status)status;
+    s->state                             = (ModelState)state;
+    s->newDiscreteStatesNeeded           = flags & 1;
+    s->terminateSimulation               = flags & (1 << 1);
+    s->nominalsOfContinuousStatesChanged = flags & (1 << 2);
+    s->valuesOfContinuousStatesChanged   = flags & (1 << 3);
+    s->nextEventTimeDefined              = flags & (1 << 4);
+    s->clocksTicked                      = flags & (1 << 5);
+    s->next                              = NULL;
+
+    return OK;
+}
+
+#ifdef ENSEMBLE
+
+// members that are integrated over a whole communication step before moving on to the next block
+#define ENSEMBLE_BLOCK_SIZE 256
+
+Ensemble* createEnsemble(size_t size, double startTime) {
+
+    Ensemble* ensemble = (Ensemble*)calloc(1, sizeof(Ensemble));
+
+    if (!ensemble) {
+        return NULL;
+    }
+
+    ensemble->size          = size;
+    ensemble->startTime     = startTime;
+    ensemble->time          = startTime;
+    ensemble->dirtyBlocks   = ALL_BLOCKS;
+
+    // start values of a single instance
+    ModelInstance* comp = (ModelInstance*)calloc(1, sizeof(ModelInstance));
+
+    if (!comp) {
+        free(ensemble);
+        return NULL;
+    }
+
+    if (setStartValues(comp) > Warning) {
+        free(comp);
+        free(ensemble);
+        return NULL;
+    }
+
+    bool allocated = true;
+
+#define ALLOCATE_ENSEMBLE_ARRAY(name) \
+    E(name) = (double*)malloc(size * sizeof(double)); \
+    if (E(name)) { \
+        for (size_t i = 0; i < size; i++) E(name)[i] = M(name); \
+    } else { \
+        allocated = false; \
+    }
+    ENSEMBLE_VARIABLES(ALLOCATE_ENSEMBLE_ARRAY)
+#undef ALLOCATE_ENSEMBLE_ARRAY
+
+    free(comp);
+
+    if (!allocated) {
+        freeEnsemble(ensemble);
+        return NULL;
+    }
+
+    return ensemble;
+}
+
+void freeEnsemble(Ensemble* ensemble) {
+
+    if (!ensemble) {
+        return;
+    }
+
+#define FREE_ENSEMBLE_ARRAY(name) free(E(name));
+    ENSEMBLE_VARIABLES(FREE_ENSEMBLE_ARRAY)
+#undef FREE_ENSEMBLE_ARRAY
+
+    free(ensemble);
+}
+
+static double* ensembleArray(Ensemble* ensemble, ValueReference vr) {
+
+    switch (vr) {
+#define ENSEMBLE_ARRAY_CASE(name) case vr_ ## name: return E(name);
+        ENSEMBLE_VARIABLES(ENSEMBLE_ARRAY_CASE)
+#undef ENSEMBLE_ARRAY_CASE
+        default:
+            return NULL;
+    }
+}
+
+Status getEnsembleFloat64(Ensemble* ensemble, ValueReference vr, double values[], size_t nValues) {
+
+    const double* array = ensembleArray(ensemble, vr);
+
+    if (!array || nValues != ensemble->size) {
+        return Error;
+    }
+
+    if (ensemble->dirtyBlocks) {
+        calculateEnsembleBlocks(&ensemble->data, ensemble->dirtyBlocks, 0, ensemble->size);
+        ensemble->dirtyBlocks = 0;
+    }
+
+    memcpy(values, array, nValues * sizeof(double));
+
+    return OK;
+}
+
+Status setEnsembleFloat64(Ensemble* ensemble, ValueReference vr, const double values[], size_t nValues) {
+
+    double* array = ensembleArray(ensemble, vr);
+
+    if (!array || nValues != ensemble->size) {
+        return Error;
+    }
+
+    memcpy(array, values, nValues * sizeof(double));
+
+    ensemble->dirtyBlocks = ALL_BLOCKS;
+
+    return OK;
+}
+
+// forward Euler step of the members [begin, end)
+static void doFixedStepEnsemble(EnsembleData* data, size_t begin, size_t end) {
+
+    calculateEnsembleBlocks(data, ALL_BLOCKS, begin, end);
+
+#define EULER_STEP(x, der_x) \
+    for (size_t i = begin; i < end; i++) { \
+        data->x[i] += FIXED_SOLVER_STEP * data->der_x[i]; \
+    }
+    ENSEMBLE_STATES(EULER_STEP)
+#undef EULER_STEP
+}
+
+void doStepEnsemble(Ensemble* ensemble, double currentCommunicationPoint, double communicationStepSize) {
+
+    const double nextCommunicationPoint = currentCommunicationPoint + communicationStepSize + EPSILON;
+
+    const uint64_t nSteps = ensemble->nSteps;
+
+    // same steps as fmi3DoStep()
+    while (ensemble->time + FIXED_SOLVER_STEP <= nextCommunicationPoint) {
+        ensemble->nSteps++;
+        ensemble->time = ensemble->startTime + ensemble->nSteps * FIXED_SOLVER_STEP;
+    }
+
+    // integrate one block of members at a time so its arrays stay in the cache
+    for (size_t begin = 0; begin < ensemble->size; begin += ENSEMBLE_BLOCK_SIZE) {
+
+        const size_t end = begin + ENSEMBLE_BLOCK_SIZE < ensemble->size ? begin + ENSEMBLE_BLOCK_SIZE : ensemble->size;
+
+        for (uint64_t i = nSteps; i < ensemble->nSteps; i++) {
+            doFixedStepEnsemble(&ensemble->data, begin, end);
+        }
+    }
+
+    ensemble->dirtyBlocks = ALL_BLOCKS;
+}
+
+#endif
+
+#if NX > 0 && FIXED_SOLVER != FIXED_SOLVER_EULER
+// derivatives at an intermediate point of the step
+static void getDerivativesAt(ModelInstance *comp, double time, const double x[], double dx[]) {
+    comp->time = time;
+    setContinuousStates(comp, x, NX);
+    getDerivatives(comp, dx, NX);
+}
+#endif
+
+#if NX > 0 && FIXED_SOLVER == FIXED_SOLVER_RK4
+static void rk4Step(ModelInstance *comp, double x[], const double k1[], double h) {
+
+    const double t = comp->time;
+
+    double y[NX], k2[NX], k3[NX], k4[NX];
+
+    for (int i = 0; i < NX; i++) {
+        y[i] = x[i] + h / 2 * k1[i];
+    }
+
+    getDerivativesAt(comp, t + h / 2, y, k2);
+
+    for (int i = 0; i < NX; i++) {
+        y[i] = x[i] + h / 2 * k2[i];
+    }
+
+    getDerivativesAt(comp, t + h / 2, y, k3);
+
+    for (int i = 0; i < NX; i++) {
+        y[i] = x[i] + h * k3[i];
+    }
+
+    getDerivativesAt(comp, t + h, y, k4);
+
+    for (int i = 0; i < NX; i++) {
+        x[i] += h / 6 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+    }
+}
+#endif
+
+#if NX > 0 && FIXED_SOLVER == FIXED_SOLVER_RK45
+// integrate over the step H with as many Dormand-Prince sub-steps as the tolerance requires
+// (starting with the step size that was accepted at the end of the previous call)
+static void rk45Step(ModelInstance *comp, double x[], const double dx[], double H) {
+
+    const double t0 = comp->time;
+
+    double k1[NX], k2[NX], k3[NX], k4[NX], k5[NX], k6[NX], k7[NX], y[NX];
+
+    memcpy(k1, dx, sizeof(k1));
+
+    double tau = 0;  // time since the start of the step
+    double hNext = comp->solverStepSize;
+
+    while (H - tau > EPSILON) {
+
+        // the last sub-step ends at the end of the step
+        const double hTrial = hNext;
+        const double h = fmin(hTrial, H - tau);
+
+        const double t = t0 + tau;
+
+        for (int i = 0; i < NX; i++) {
+            y[i] = x[i] + h * (1.0 / 5 * k1[i]);
+        }
+
+        getDerivativesAt(comp, t + h * 1 / 5, y, k2);
+
+        for (int i = 0; i < NX; i++) {
+            y[i] = x[i] + h * (3.0 / 40 * k1[i] + 9.0 / 40 * k2[i]);
+        }
+
+        getDerivativesAt(comp, t + h * 3 / 10, y, k3);
+
+        for (int i = 0; i < NX; i++) {
+            y[i] = x[i] + h * (44.0 / 45 * k1[i] - 56.0 / 15 * k2[i] + 32.0 / 9 * k3[i]);
+        }
+
+        getDerivativesAt(comp, t + h * 4 / 5, y, k4);
+
+        for (int i = 0; i < NX; i++) {
+            y[i] = x[i] + h * (19372.0 / 6561 * k1[i] - 25360.0 / 2187 * k2[i] + 64448.0 / 6561 * k3[i] - 212.0 / 729 * k4[i]);
+        }
+
+        getDerivativesAt(comp, t + h * 8 / 9, y, k5);
+
+        for (int i = 0; i < NX; i++) {
+            y[i] = x[i] + h * (9017.0 / 3168 * k1[i] - 355.0 / 33 * k2[i] + 46732.0 / 5247 * k3[i] + 49.0 / 176 * k4[i] - 5103.0 / 18656 * k5[i]);
+        }
+
+        getDerivativesAt(comp, t + h, y, k6);
+
+        // solution of order 5
+        for (int i = 0; i < NX; i++) {
+            y[i] = x[i] + h * (35.0 / 384 * k1[i] + 500.0 / 1113 * k3[i] + 125.0 / 192 * k4[i] - 2187.0 / 6784 * k5[i] + 11.0 / 84 * k6[i]);
+        }
+
+        getDerivativesAt(comp, t + h, y, k7);
+
+        // difference to the embedded solution of order 4 relative to the tolerance
+        double error = 0;
+
+        for (int i = 0; i < NX; i++) {
+
+            const double e = h * (71.0 / 57600 * k1[i] - 71.0 / 16695 * k3[i] + 71.0 / 1920 * k4[i] - 17253.0 / 339200 * k5[i] + 22.0 / 525 * k6[i] - 1.0 / 40 * k7[i]);
+            const double scale = FIXED_SOLVER_TOLERANCE * (1 + fmax(fabs(x[i]), fabs(y[i])));
+
+            error = fmax(error, fabs(e) / scale);
+        }
+
+        const double hOptimal = h * (error > 0 ? fmin(5, fmax(0.2, 0.9 * pow(error, -0.2))) : 5);
+
+        // accept the sub-step (or give up on the tolerance if the step size becomes too small)
+        if (error <= 1 || h <= EPSILON) {
+            tau += h;
+            memcpy(x, y, sizeof(y));
+            memcpy(k1, k7, sizeof(k1));  // first same as last
+        }
+
+        // a sub-step that was shortened to the end of the step does not reduce the step size
+        hNext = h < hTrial && error <= 1 ? fmax(hTrial, hOptimal) : hOptimal;
+    }
+
+    // the step size can grow up to the length of the step
+    comp->solverStepSize = fmin(hNext, H);
+}
+#endif
+
+#if NX > 0
+// advance the continuous states x with the derivatives dx at the start of the step by one fixed step
+static void integrate(ModelInstance *comp, double x[], const double dx[]) {
+#if FIXED_SOLVER == FIXED_SOLVER_RK4
+    rk4Step(comp, x, dx, FIXED_SOLVER_STEP);
+#elif FIXED_SOLVER == FIXED_SOLVER_RK45
+    rk45Step(comp, x, dx, FIXED_SOLVER_STEP);
+#else
+    UNUSED(comp);
+    // forward Euler step
+    for (int i = 0; i < NX; i++) {
+        x[i] += FIXED_SOLVER_STEP * dx[i];
+    }
+#endif
+}
+#endif
+
+void doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
+
+#if NX > 0
+    double  x[NX] = { 0 };
+    double dx[NX] = { 0 };
+
+    getContinuousStates(comp, x, NX);
+    getDerivatives(comp, dx, NX);
+
+    integrate(comp, x, dx);
+
+    setContinuousStates(comp, x, NX);
+#endif
 
     comp->nSteps++;
 
@@ -584,3 +1704,62 @@ void doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
             &earlyReturnTime);          // earlyReturnTime
     }
 }
+
+void doFixedSteps(ModelInstance *comp, double nextCommunicationPoint) {
+
+#if defined(FAST_FIXED_STEPS) && NX > 0 && NZ < 1
+    // time events and intermediate updates have to be handled after every step
+    // (early return is only possible at events)
+    if (comp->nextEventTimeDefined || comp->intermediateUpdate) {
+        return;
+    }
+
+    double  x[NX] = { 0 };
+    double dx[NX] = { 0 };
+
+    // without event indicators the states only have to be read once
+    getContinuousStates(comp, x, NX);
+
+#if FIXED_SOLVER == FIXED_SOLVER_RK45
+    // integrate over all fixed steps up to the communication point at once
+    // so that the adaptive step size can grow beyond FIXED_SOLVER_STEP
+    uint64_t nSteps = comp->nSteps;
+    double time = comp->time;
+
+    while (time + FIXED_SOLVER_STEP <= nextCommunicationPoint) {
+        nSteps++;
+        time = comp->startTime + nSteps * FIXED_SOLVER_STEP;
+    }
+
+    if (nSteps > comp->nSteps) {
+
+        getDerivatives(comp, dx, NX);
+
+        rk45Step(comp, x, dx, time - comp->time);
+
+        setContinuousStates(comp, x, NX);
+
+        comp->nSteps = nSteps;
+
+        comp->time = time;
+    }
+#else
+    // same steps as the loop over doFixedStep()
+    while (comp->time + FIXED_SOLVER_STEP <= nextCommunicationPoint) {
+
+        getDerivatives(comp, dx, NX);
+
+        integrate(comp, x, dx);
+
+        setContinuousStates(comp, x, NX);
+
+        comp->nSteps++;
+
+        comp->time = comp->startTime + comp->nSteps * FIXED_SOLVER_STEP;
+    }
+#endif
+#else
+    UNUSED(comp);
+    UNUSED(nextCommunicationPoint);
+#endif
+}
@@ -35,14 +35,12 @@ do { \
     size_t index = 0; \
     Status status = OK; \
     if (nvr == 0) return (fmiStatus)status; \
-    if (S->isDirtyValues) { \
-        Status s = calculateValues(S); \
+    for (size_t i = 0; i < nvr; i++) { \
+        Status s = updateValues(S, requiredBlocks(S, vr[i])); \
         status = max(status, s); \
         if (status > Warning) return (fmiStatus)status; \
-        S->isDirtyValues = false; \
-    } \
-    for (size_t i = 0; i < nvr; i++) { \
-        Status s = get ## T(S, vr[i], value, nvr, &index); \
+        if (getVariable(S, T ## Type, vr[i], value, sizeof(value[0]), nvr, &index)) continue; \
+        s = get ## T(S, vr[i], value, nvr, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmiStatus)status; \
     } \
@@ -56,11 +54,12 @@ do { \
     size_t index = 0; \
     Status status = OK; \
     for (size_t i = 0; i < nvr; i++) { \
+        S->dirtyBlocks |= dependentBlocks(S, vr[i]); \
+        if (setVariable(S, T ## Type, vr[i], value, sizeof(value[0]), nvr, &index)) continue; \
         Status s = set ## T(S, vr[i], value, nvr, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmiStatus)status; \
     } \
-    if (nvr > 0) S->isDirtyValues = true; \
     return (fmiStatus)status; \
 } while (0)
 
@@ -70,7 +69,10 @@ do { \
     for (size_t i = 0; i < nvr; i++) { \
         bool v = false; \
         size_t index = 0; \
-        Status s = getBoolean(S, vr[i], &v, nvr, &index); \
+        Status s = updateValues(S, requiredBlocks(S, vr[i])); \
+        status = max(status, s); \
+        if (status > Warning) return (fmiStatus)status; \
+        s = getBoolean(S, vr[i], &v, nvr, &index); \
         value[i] = v; \
         status = max(status, s); \
         if (status > Warning) return (fmiStatus)status; \
@@ -84,6 +86,7 @@ do { \
     for (size_t i = 0; i < nvr; i++) { \
         bool v = value[i]; \
         size_t index = 0; \
+        S->dirtyBlocks |= dependentBlocks(S, vr[i]); \
         Status s = setBoolean(S, vr[i], &v, nvr, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmiStatus)status; \
@@ -114,7 +117,7 @@ do { \
 static fmiStatus init(fmiComponent c) {
     ModelInstance* instance = (ModelInstance *)c;
     instance->state = Initialized;
-    calculateValues(instance);
+    updateValues(instance, ALL_BLOCKS);
     return fmiOK;
 }
 
@@ -238,8 +241,7 @@ fmiStatus fmiResetSlave(fmiComponent c) {
     ModelInstance* instance = (ModelInstance *)c;
     if (invalidState(instance, "fmiResetSlave", Initialized))
          return fmiError;
-    reset(instance);
-    return fmiOK;
+    return (fmiStatus)reset(instance);
 }
 
 void fmiFreeSlaveInstance(fmiComponent c) {
@@ -310,6 +312,8 @@ fmiStatus fmiDoStep(fmiComponent c, fmiReal currentCommunicationPoint, fmiReal c
 
     const fmiReal nextCommunicationPoint = currentCommunicationPoint + communicationStepSize + EPSILON;
 
+    doFixedSteps(instance, nextCommunicationPoint);
+
     while (true) {
 
         if (instance->time + FIXED_SOLVER_STEP > nextCommunicationPoint) {
@@ -12,6 +12,14 @@
 #include "model.h"
 #include "cosimulation.h"
 
+#ifdef ASYNC_DO_STEP
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
 
 // C-code FMUs have functions names prefixed with MODEL_IDENTIFIER_.
 // Define DISABLE_PREFIX to build a binary FMU.
@@ -38,14 +46,12 @@ do { \
     ASSERT_NOT_NULL(vr); \
     ASSERT_NOT_NULL(value); \
     size_t index = 0; \
-    if (S->isDirtyValues) { \
-        Status s = calculateValues(S); \
+    for (size_t i = 0; i < nvr; i++) { \
+        Status s = updateValues(S, requiredBlocks(S, vr[i])); \
         status = max(status, s); \
         if (status > Warning) return (fmi2Status)status; \
-        S->isDirtyValues = false; \
-    } \
-    for (size_t i = 0; i < nvr; i++) { \
-        Status s = get ## T(S, vr[i], value, nvr, &index); \
+        if (getVariable(S, T ## Type, vr[i], value, sizeof(value[0]), nvr, &index)) continue; \
+        s = get ## T(S, vr[i], value, nvr, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmi2Status)status; \
     } \
@@ -60,11 +66,12 @@ do { \
     ASSERT_NOT_NULL(value); \
     size_t index = 0; \
     for (size_t i = 0; i < nvr; i++) { \
+        S->dirtyBlocks |= dependentBlocks(S, vr[i]); \
+        if (setVariable(S, T ## Type, vr[i], value, sizeof(value[0]), nvr, &index)) continue; \
         Status s = set ## T(S, vr[i], value, nvr, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmi2Status)status; \
     } \
-    if (nvr > 0) S->isDirtyValues = true; \
     return (fmi2Status)status; \
 } while (0)
 
@@ -74,7 +81,10 @@ do { \
     for (size_t i = 0; i < nvr; i++) { \
         bool v = false; \
         size_t index = 0; \
-        Status s = getBoolean(S, vr[i], &v, nvr, &index); \
+        Status s = updateValues(S, requiredBlocks(S, vr[i])); \
+        status = max(status, s); \
+        if (status > Warning) return (fmi2Status)status; \
+        s = getBoolean(S, vr[i], &v, nvr, &index); \
         value[i] = v; \
         status = max(status, s); \
         if (status > Warning) return (fmi2Status)status; \
@@ -88,6 +98,7 @@ do { \
     for (size_t i = 0; i < nvr; i++) { \
         bool v = value[i]; \
         size_t index = 0; \
+        S->dirtyBlocks |= dependentBlocks(S, vr[i]); \
         Status s = setBoolean(S, vr[i], &v, nvr, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmi2Status)status; \
@@ -194,12 +205,232 @@ do { \
     if (!allowedState(c, MASK_fmi2##S, #S)) \
         return fmi2Error;
 
+#ifdef ASYNC_DO_STEP
+
+#ifdef _WIN32
+#define LOCK_ASYNC_STEP(a)   EnterCriticalSection(&(a)->mutex)
+#define UNLOCK_ASYNC_STEP(a) LeaveCriticalSection(&(a)->mutex)
+#define WAIT_ASYNC_STEP(a)   SleepConditionVariableCS(&(a)->condition, &(a)->mutex, INFINITE)
+#define NOTIFY_ASYNC_STEP(a) WakeAllConditionVariable(&(a)->condition)
+#else
+#define LOCK_ASYNC_STEP(a)   pthread_mutex_lock(&(a)->mutex)
+#define UNLOCK_ASYNC_STEP(a) pthread_mutex_unlock(&(a)->mutex)
+#define WAIT_ASYNC_STEP(a)   pthread_cond_wait(&(a)->condition, &(a)->mutex)
+#define NOTIFY_ASYNC_STEP(a) pthread_cond_broadcast(&(a)->condition)
+#endif
+
+// worker thread that computes the steps of an instance for which fmi2DoStep() returns fmi2Pending
+typedef struct {
+
+#ifdef _WIN32
+    HANDLE thread;
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE condition;
+#else
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+#endif
+
+    ModelInstance *comp;
+    fmi2StepFinished stepFinished;
+
+    fmi2Real nextCommunicationPoint;
+
+    bool requested;  // a step has been requested but not started
+    bool pending;    // the requested step has not finished
+    bool cancel;     // the step has been canceled
+    bool quit;       // the instance is freed
+
+    fmi2Status status;  // result of the last step
+
+} AsyncStep;
+
+static bool asyncStepCanceled(AsyncStep *a) {
+    LOCK_ASYNC_STEP(a);
+    const bool cancel = a->cancel;
+    UNLOCK_ASYNC_STEP(a);
+    return cancel;
+}
+
+// the state of the instance is only changed by the calling thread when it observes the end of the step
+static void updateAsyncStepState(ModelInstance *comp) {
+
+    AsyncStep *a = (AsyncStep *)comp->asyncStep;
+
+    if (!a || comp->state != StepInProgress) {
+        return;
+    }
+
+    LOCK_ASYNC_STEP(a);
+
+    if (!a->pending) {
+        comp->state = a->status > fmi2Discard ? StepFailed : StepComplete;
+    }
+
+    UNLOCK_ASYNC_STEP(a);
+}
+
+#endif
+
+// compute the step up to the next communication point
+static fmi2Status doStep(ModelInstance *comp, fmi2Real nextCommunicationPoint) {
+
+#ifdef ASYNC_DO_STEP
+    // asynchronous steps can be canceled after every fixed step
+    if (!comp->asyncStep) {
+        doFixedSteps(comp, nextCommunicationPoint);
+    }
+#else
+    doFixedSteps(comp, nextCommunicationPoint);
+#endif
+
+    while (true) {
+
+        if (comp->time + FIXED_SOLVER_STEP > nextCommunicationPoint) {
+            break;  // next communcation point reached
+        }
+
+#ifdef ASYNC_DO_STEP
+        if (comp->asyncStep && asyncStepCanceled((AsyncStep *)comp->asyncStep)) {
+            return fmi2Error;
+        }
+#endif
+
+        bool stateEvent, timeEvent;
+
+        doFixedStep(comp, &stateEvent, &timeEvent);
+
+#ifdef EVENT_UPDATE
+        if (stateEvent || timeEvent) {
+            eventUpdate(comp);
+        }
+#endif
+    }
+
+    return comp->terminateSimulation ? fmi2Discard : fmi2OK;
+}
+
+#ifdef ASYNC_DO_STEP
+
+#ifdef _WIN32
+static DWORD WINAPI asyncStepThread(LPVOID arg) {
+#else
+static void *asyncStepThread(void *arg) {
+#endif
+
+    AsyncStep *a = (AsyncStep *)arg;
+
+    LOCK_ASYNC_STEP(a);
+
+    while (true) {
+
+        while (!a->requested && !a->quit) {
+            WAIT_ASYNC_STEP(a);
+        }
+
+        if (a->quit) {
+            break;
+        }
+
+        a->requested = false;
+
+        const fmi2Real nextCommunicationPoint = a->nextCommunicationPoint;
+
+        UNLOCK_ASYNC_STEP(a);
+
+        const fmi2Status status = doStep(a->comp, nextCommunicationPoint);
+
+        LOCK_ASYNC_STEP(a);
+
+        a->status = status;
+        a->pending = false;
+
+        NOTIFY_ASYNC_STEP(a);
+
+        // canceled steps are not reported
+        if (!a->cancel) {
+            UNLOCK_ASYNC_STEP(a);
+            a->stepFinished(a->comp->componentEnvironment, status);
+            LOCK_ASYNC_STEP(a);
+        }
+    }
+
+    UNLOCK_ASYNC_STEP(a);
+
+    return 0;
+}
+
+static AsyncStep *createAsyncStep(ModelInstance *comp, fmi2StepFinished stepFinished) {
+
+    AsyncStep *a = (AsyncStep *)calloc(1, sizeof(AsyncStep));
+
+    if (!a) {
+        return NULL;
+    }
+
+    a->comp = comp;
+    a->stepFinished = stepFinished;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&a->mutex);
+    InitializeConditionVariable(&a->condition);
+
+    a->thread = CreateThread(NULL, 0, asyncStepThread, a, 0, NULL);
+
+    if (!a->thread) {
+        DeleteCriticalSection(&a->mutex);
+        free(a);
+        return NULL;
+    }
+#else
+    pthread_mutex_init(&a->mutex, NULL);
+    pthread_cond_init(&a->condition, NULL);
+
+    if (pthread_create(&a->thread, NULL, asyncStepThread, a)) {
+        pthread_cond_destroy(&a->condition);
+        pthread_mutex_destroy(&a->mutex);
+        free(a);
+        return NULL;
+    }
+#endif
+
+    return a;
+}
+
+static void freeAsyncStep(AsyncStep *a) {
+
+    LOCK_ASYNC_STEP(a);
+    a->cancel = true;
+    a->quit = true;
+    NOTIFY_ASYNC_STEP(a);
+    UNLOCK_ASYNC_STEP(a);
+
+#ifdef _WIN32
+    WaitForSingleObject(a->thread, INFINITE);
+    CloseHandle(a->thread);
+    DeleteCriticalSection(&a->mutex);
+#else
+    pthread_join(a->thread, NULL);
+    pthread_cond_destroy(&a->condition);
+    pthread_mutex_destroy(&a->mutex);
+#endif
+
+    free(a);
+}
+
+#endif
+
 static bool allowedState(ModelInstance *instance, int statesExpected, char *name) {
 
     if (!instance) {
         return false;
     }
 
+#ifdef ASYNC_DO_STEP
+    updateAsyncStepState(instance);
+#endif
+
     if (!(instance->state & statesExpected)) {
         logError(instance, "fmi2%s: Illegal call sequence.", name);
         return false;
@@ -223,7 +454,7 @@ fmi2Component fmi2Instantiate(fmi2String instanceName, fmi2Type fmuType, fmi2Str
         return NULL;
     }
 
-    return createModelInstance(
+    ModelInstance *comp = createModelInstance(
         (loggerType)functions->logger,
         NULL,
         functions->componentEnvironment,
@@ -232,6 +463,22 @@ fmi2Component fmi2Instantiate(fmi2String instanceName, fmi2Type fmuType, fmi2Str
         fmuResourceLocation,
         loggingOn,
         (InterfaceType)fmuType);
+
+#ifdef ASYNC_DO_STEP
+    // compute the steps asynchronously if the environment can be notified
+    if (comp && fmuType == fmi2CoSimulation && functions->stepFinished) {
+
+        comp->asyncStep = createAsyncStep(comp, functions->stepFinished);
+
+        if (!comp->asyncStep) {
+            logError(comp, "Failed to start the worker thread for asynchronous steps.");
+            freeModelInstance(comp);
+            return NULL;
+        }
+    }
+#endif
+
+    return comp;
 }
 
 fmi2Status fmi2SetupExperiment(fmi2Component c, fmi2Boolean toleranceDefined, fmi2Real tolerance,
@@ -266,10 +513,7 @@ fmi2Status fmi2ExitInitializationMode(fmi2Component c) {
 
     // if values were set and no fmi2GetXXX triggered update before,
     // ensure calculated values are updated now
-    if (S->isDirtyValues) {
-        status = (fmi2Status)calculateValues(S);
-        S->isDirtyValues = false;
-    }
+    status = (fmi2Status)updateValues(S, ALL_BLOCKS);
 
     if (S->type == ModelExchange) {
         S->state = EventMode;
@@ -293,14 +537,17 @@ fmi2Status fmi2Reset(fmi2Component c) {
 
     ASSERT_STATE(Reset);
 
-    reset(S);
-
-    return fmi2OK;
+    return (fmi2Status)reset(S);
 }
 
 void fmi2FreeInstance(fmi2Component c) {
 
     if (S) {
+#ifdef ASYNC_DO_STEP
+        if (S->asyncStep) {
+            freeAsyncStep((AsyncStep *)S->asyncStep);
+        }
+#endif
         freeModelInstance(S);
     }
 }
@@ -339,11 +586,6 @@ fmi2Status fmi2GetReal(fmi2Component c, const fmi2ValueReference vr[], size_t nv
     if (nvr > 0 && nullPointer(S, "fmi2GetReal", "value[]", value))
         return fmi2Error;
 
-    if (nvr > 0 && S->isDirtyValues) {
-        calculateValues(S);
-        S->isDirtyValues = false;
-    }
-
     GET_VARIABLES(Float64);
 }
 
@@ -357,11 +599,6 @@ fmi2Status fmi2GetInteger(fmi2Component c, const fmi2ValueReference vr[], size_t
     if (nvr > 0 && nullPointer(S, "fmi2GetInteger", "value[]", value))
             return fmi2Error;
 
-    if (nvr > 0 && S->isDirtyValues) {
-        calculateValues(S);
-        S->isDirtyValues = false;
-    }
-
     GET_VARIABLES(Int32);
 }
 
@@ -375,11 +612,6 @@ fmi2Status fmi2GetBoolean(fmi2Component c, const fmi2ValueReference vr[], size_t
     if (nvr > 0 && nullPointer(S, "fmi2GetBoolean", "value[]", value))
             return fmi2Error;
 
-    if (nvr > 0 && S->isDirtyValues) {
-        calculateValues(S);
-        S->isDirtyValues = false;
-    }
-
     GET_BOOLEAN_VARIABLES;
 }
 
@@ -393,11 +625,6 @@ fmi2Status fmi2GetString (fmi2Component c, const fmi2ValueReference vr[], size_t
     if (nvr>0 && nullPointer(S, "fmi2GetString", "value[]", value))
             return fmi2Error;
 
-    if (nvr > 0 && S->isDirtyValues) {
-        calculateValues(S);
-        S->isDirtyValues = false;
-    }
-
     GET_VARIABLES(String);
 }
 
@@ -460,7 +687,14 @@ fmi2Status fmi2GetFMUstate (fmi2Component c, fmi2FMUstate* FMUstate) {
 
     ASSERT_STATE(GetFMUstate);
 
-    *FMUstate = getFMUState(S);
+    // keep the existing FMU state of the caller if the call fails
+    void* s = getFMUState(S, *FMUstate);
+
+    if (!s) {
+        return fmi2Error;
+    }
+
+    *FMUstate = s;
 
     return fmi2OK;
 }
@@ -473,16 +707,14 @@ fmi2Status fmi2SetFMUstate(fmi2Component c, fmi2FMUstate FMUstate) {
         return fmi2Error;
     }
 
-    setFMUState(S, FMUstate);
-
-    return fmi2OK;
+    return (fmi2Status)setFMUState(S, FMUstate);
 }
 
 fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
 
     ASSERT_STATE(FreeFMUstate);
 
-    free(*FMUstate);
+    freeFMUState(S, *FMUstate);
 
     *FMUstate = NULL;
 
@@ -491,12 +723,13 @@ fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
 
 fmi2Status fmi2SerializedFMUstateSize(fmi2Component c, fmi2FMUstate FMUstate, size_t *size) {
 
-    UNUSED(c);
-    UNUSED(FMUstate);
-
     ASSERT_STATE(SerializedFMUstateSize);
 
-    *size = sizeof(ModelInstance);
+    if (nullPointer(S, "fmi2SerializedFMUstateSize", "FMUstate", FMUstate)) {
+        return fmi2Error;
+    }
+
+    *size = serializedFMUStateSize(FMUstate);
 
     return fmi2OK;
 }
@@ -509,11 +742,11 @@ fmi2Status fmi2SerializeFMUstate(fmi2Component c, fmi2FMUstate FMUstate, fmi2Byt
         return fmi2Error;
     }
 
-    if (invalidNumber(S, "fmi2SerializeFMUstate", "size", size, sizeof(ModelInstance))) {
+    if (invalidNumber(S, "fmi2SerializeFMUstate", "size", size, serializedFMUStateSize(FMUstate))) {
         return fmi2Error;
     }
 
-    memcpy(serializedState, FMUstate, sizeof(ModelInstance));
+    serializeFMUState(FMUstate, (char*)serializedState);
 
     return fmi2OK;
 }
@@ -522,15 +755,20 @@ fmi2Status fmi2DeSerializeFMUstate (fmi2Component c, const fmi2Byte serializedSt
 
     ASSERT_STATE(DeSerializeFMUstate);
 
-    if (invalidNumber(S, "fmi2DeSerializeFMUstate", "size", size, sizeof(ModelInstance))) {
+    void* s = *FMUstate ? *FMUstate : allocateFMUState(S);
+
+    if (!s) {
         return fmi2Error;
     }
 
-    if (*FMUstate == NULL) {
-        *FMUstate = calloc(1, sizeof(ModelInstance));
+    if (deserializeFMUState(S, (const char*)serializedState, size, s) > Warning) {
+        if (!*FMUstate) {
+            freeFMUState(S, s);
+        }
+        return fmi2Error;
     }
 
-    memcpy(*FMUstate, serializedState, sizeof(ModelInstance));
+    *FMUstate = s;
 
     return fmi2OK;
 }
@@ -541,26 +779,7 @@ fmi2Status fmi2GetDirectionalDerivative(fmi2Component c, const fmi2ValueReferenc
 
     ASSERT_STATE(GetDirectionalDerivative);
 
-    // TODO: check value references
-    // TODO: assert nUnknowns == nDeltaOfUnknowns
-    // TODO: assert nKnowns == nDeltaKnowns
-
-    Status status = OK;
-
-    for (size_t i = 0; i < nUnknown; i++) {
-        dvUnknown[i] = 0;
-        for (size_t j = 0; j < nKnown; j++) {
-            double partialDerivative = 0;
-            Status s = getPartialDerivative(S, vUnknown_ref[i], vKnown_ref[j], &partialDerivative);
-            status = max(status, s);
-            if (status > Warning) {
-                return (fmi2Status)status;
-            }
-            dvUnknown[i] += partialDerivative * dvKnown[j];
-        }
-    }
-
-    return fmi2OK;
+    return (fmi2Status)getDirectionalDerivative(S, vUnknown_ref, nUnknown, vKnown_ref, nKnown, dvKnown, nKnown, dvUnknown, nUnknown);
 }
 
 // ---------------------------------------------------------------------------
@@ -615,6 +834,28 @@ fmi2Status fmi2GetRealOutputDerivatives(fmi2Component c, const fmi2ValueReferenc
 
 fmi2Status fmi2CancelStep(fmi2Component c) {
 
+#ifdef ASYNC_DO_STEP
+    // the step may already have finished without the caller having noticed
+    if (S && S->asyncStep && S->state == StepInProgress) {
+
+        AsyncStep *a = (AsyncStep *)S->asyncStep;
+
+        LOCK_ASYNC_STEP(a);
+
+        a->cancel = true;
+
+        while (a->pending) {
+            WAIT_ASYNC_STEP(a);
+        }
+
+        UNLOCK_ASYNC_STEP(a);
+
+        S->state = StepCanceled;
+
+        return fmi2OK;
+    }
+#endif
+
     ASSERT_STATE(CancelStep);
 
     logError(S, "fmi2CancelStep: Can be called when fmi2DoStep returned fmi2Pending."
@@ -645,24 +886,29 @@ fmi2Status fmi2DoStep(fmi2Component c, fmi2Real currentCommunicationPoint,
 
     const fmi2Real nextCommunicationPoint = currentCommunicationPoint + communicationStepSize + EPSILON;
 
-    while (true) {
+#ifdef ASYNC_DO_STEP
+    if (S->asyncStep) {
 
-        if (S->time + FIXED_SOLVER_STEP > nextCommunicationPoint) {
-            break;  // next communcation point reached
-        }
+        AsyncStep *a = (AsyncStep *)S->asyncStep;
 
-        bool stateEvent, timeEvent;
+        LOCK_ASYNC_STEP(a);
 
-        doFixedStep(S, &stateEvent, &timeEvent);
+        a->nextCommunicationPoint = nextCommunicationPoint;
+        a->requested = true;
+        a->pending = true;
+        a->cancel = false;
 
-#ifdef EVENT_UPDATE
-        if (stateEvent || timeEvent) {
-            eventUpdate(S);
-        }
-#endif
+        NOTIFY_ASYNC_STEP(a);
+
+        UNLOCK_ASYNC_STEP(a);
+
+        S->state = StepInProgress;
+
+        return fmi2Pending;
     }
+#endif
 
-    return S->terminateSimulation ? fmi2Discard : fmi2OK;
+    return doStep(S, nextCommunicationPoint);
 }
 
 /* Inquire slave status */
@@ -695,10 +941,17 @@ static fmi2Status getStatus(char* fname, fmi2Component c, const fmi2StatusKind s
 
 fmi2Status fmi2GetStatus(fmi2Component c, const fmi2StatusKind s, fmi2Status *value) {
 
-    UNUSED(value);
-
     ASSERT_STATE(GetStatus);
 
+#ifdef ASYNC_DO_STEP
+    if (s == fmi2DoStepStatus && S->asyncStep) {
+        *value = S->state == StepInProgress ? fmi2Pending : ((AsyncStep *)S->asyncStep)->status;
+        return fmi2OK;
+    }
+#else
+    UNUSED(value);
+#endif
+
     return getStatus("fmi2GetStatus", c, s);
 }
 
@@ -706,7 +959,8 @@ fmi2Status fmi2GetRealStatus(fmi2Component c, const fmi2StatusKind s, fmi2Real *
 
     ASSERT_STATE(GetRealStatus);
 
-    if (s == fmi2LastSuccessfulTime) {
+    // the time is not defined while a step is in progress
+    if (s == fmi2LastSuccessfulTime && S->state != StepInProgress) {
         *value = S->time;
         return fmi2OK;
     }
@@ -727,7 +981,7 @@ fmi2Status fmi2GetBooleanStatus(fmi2Component c, const fmi2StatusKind s, fmi2Boo
 
     ASSERT_STATE(GetBooleanStatus);
 
-    if (s == fmi2Terminated) {
+    if (s == fmi2Terminated && S->state != StepInProgress) {
         *value = S->terminateSimulation;
         return fmi2OK;
     }
@@ -736,8 +990,15 @@ fmi2Status fmi2GetBooleanStatus(fmi2Component c, const fmi2StatusKind s, fmi2Boo
 }
 
 fmi2Status fmi2GetStringStatus(fmi2Component c, const fmi2StatusKind s, fmi2String *value) {
-    UNUSED(value);
     ASSERT_STATE(GetStringStatus);
+#ifdef ASYNC_DO_STEP
+    if (s == fmi2PendingStatus && S->asyncStep) {
+        *value = S->state == StepInProgress ? "Step in progress." : "No step in progress.";
+        return fmi2OK;
+    }
+#else
+    UNUSED(value);
+#endif
     return getStatus("fmi2GetStringStatus", c, s);
 }
 
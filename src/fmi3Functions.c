@@ -20,6 +20,7 @@
 #define FMI3_FUNCTION_PREFIX pasteB(MODEL_IDENTIFIER, _)
 #endif
 #include "fmi3Functions.h"
+#include "refEnsembleFunctions.h"
 
 #define ASSERT_NOT_NULL(p) \
 do { \
@@ -38,14 +39,12 @@ do { \
     ASSERT_NOT_NULL(values); \
     size_t index = 0; \
     if (nValueReferences == 0) return (fmi3Status)status; \
-    if (S->isDirtyValues) { \
-        Status s = calculateValues(S); \
+    for (size_t i = 0; i < nValueReferences; i++) { \
+        Status s = updateValues(S, requiredBlocks(S, (ValueReference)valueReferences[i])); \
         status = max(status, s); \
         if (status > Warning) return (fmi3Status)status; \
-        S->isDirtyValues = false; \
-    } \
-    for (size_t i = 0; i < nValueReferences; i++) { \
-        Status s = get ## T(S, (ValueReference)valueReferences[i], values, nValues, &index); \
+        if (getVariable(S, T ## Type, (ValueReference)valueReferences[i], values, sizeof(values[0]), nValues, &index)) continue; \
+        s = get ## T(S, (ValueReference)valueReferences[i], values, nValues, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmi3Status)status; \
     } \
@@ -64,11 +63,12 @@ do { \
     ASSERT_NOT_NULL(values); \
     size_t index = 0; \
     for (size_t i = 0; i < nValueReferences; i++) { \
+        S->dirtyBlocks |= dependentBlocks(S, (ValueReference)valueReferences[i]); \
+        if (setVariable(S, T ## Type, (ValueReference)valueReferences[i], values, sizeof(values[0]), nValues, &index)) continue; \
         Status s = set ## T(S, (ValueReference)valueReferences[i], values, nValues, &index); \
         status = max(status, s); \
         if (status > Warning) return (fmi3Status)status; \
     } \
-    if (nValueReferences > 0) S->isDirtyValues = true; \
     if (index != nValues) { \
         logError(S, "Expected nValues = %zu but was %zu.", index, nValues); \
         return fmi3Error; \
@@ -163,6 +163,7 @@ do { \
 // TODO: fix masks
 #define MASK_fmi3GetIntervalDecimal        MASK_AnyState
 #define MASK_fmi3GetIntervalFraction       MASK_AnyState
+#define MASK_fmi3GetShiftDecimal           MASK_AnyState
 #define MASK_fmi3SetIntervalDecimal        MASK_AnyState
 #define MASK_fmi3SetIntervalFraction       MASK_AnyState
 #define MASK_fmi3NewDiscreteStates         MASK_AnyState
@@ -410,15 +411,10 @@ fmi3Status fmi3ExitInitializationMode(fmi3Instance instance) {
 
     // if values were set and no fmi3GetXXX triggered update before,
     // ensure calculated values are updated now
-    if (S->isDirtyValues) {
-
-        status = (fmi3Status)calculateValues(S);
-
-        if (status > fmi3Warning) {
-            return status;
-        }
+    status = (fmi3Status)updateValues(S, ALL_BLOCKS);
 
-        S->isDirtyValues = false;
+    if (status > fmi3Warning) {
+        return status;
     }
 
     switch (S->type) {
@@ -463,9 +459,7 @@ fmi3Status fmi3Reset(fmi3Instance instance) {
 
     ASSERT_STATE(Reset);
 
-    reset(S);
-
-    return fmi3OK;
+    return (fmi3Status)reset(S);
 }
 
 fmi3Status fmi3GetFloat32(fmi3Instance instance,
@@ -613,7 +607,10 @@ fmi3Status fmi3GetBinary(fmi3Instance instance,
 
     for (size_t i = 0; i < nValueReferences; i++) {
         size_t index = 0;
-        Status s = getBinary(S, (ValueReference)valueReferences[i], valueSizes, (const char**)values, nValues, &index);
+        Status s = updateValues(S, requiredBlocks(S, (ValueReference)valueReferences[i]));
+        status = max(status, s);
+        if (status > Warning) return (fmi3Status)status;
+        s = getBinary(S, (ValueReference)valueReferences[i], valueSizes, (const char**)values, nValues, &index);
         status = max(status, s);
         if (status > Warning) return (fmi3Status)status;
     }
@@ -784,6 +781,7 @@ fmi3Status fmi3SetBinary(fmi3Instance instance,
 
     for (size_t i = 0; i < nValueReferences; i++) {
         size_t index = 0;
+        S->dirtyBlocks |= dependentBlocks(S, (ValueReference)valueReferences[i]);
         Status s = setBinary(S, (ValueReference)valueReferences[i], valueSizes, (const char* const*)values, nValues, &index);
         status = max(status, s);
         if (status > Warning) return (fmi3Status)status;
@@ -843,7 +841,14 @@ fmi3Status fmi3GetFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
 
     ASSERT_STATE(GetFMUState);
 
-    *FMUState = getFMUState(S);
+    // keep the existing FMU state of the caller if the call fails
+    void* s = getFMUState(S, *FMUState);
+
+    if (!s) {
+        return fmi3Error;
+    }
+
+    *FMUState = s;
 
     return fmi3OK;
 }
@@ -856,16 +861,14 @@ fmi3Status fmi3SetFMUState(fmi3Instance instance, fmi3FMUState FMUState) {
         return fmi3Error;
     }
 
-    setFMUState(S, FMUState);
-
-    return fmi3OK;
+    return (fmi3Status)setFMUState(S, FMUState);
 }
 
 fmi3Status fmi3FreeFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
 
     ASSERT_STATE(FreeFMUState);
 
-    free(*FMUState);
+    freeFMUState(S, *FMUState);
 
     *FMUState = NULL;
 
@@ -876,12 +879,13 @@ fmi3Status fmi3SerializedFMUStateSize(fmi3Instance instance,
     fmi3FMUState  FMUState,
     size_t* size) {
 
-    UNUSED(instance);
-    UNUSED(FMUState);
-
     ASSERT_STATE(SerializedFMUStateSize);
 
-    *size = sizeof(ModelInstance);
+    if (nullPointer(S, "fmi3SerializedFMUStateSize", "FMUState", FMUState)) {
+        return fmi3Error;
+    }
+
+    *size = serializedFMUStateSize(FMUState);
 
     return fmi3OK;
 }
@@ -897,11 +901,11 @@ fmi3Status fmi3SerializeFMUState(fmi3Instance instance,
         return fmi3Error;
     }
 
-    if (invalidNumber(S, "fmi3SerializeFMUState", "size", size, sizeof(ModelInstance))) {
+    if (invalidNumber(S, "fmi3SerializeFMUState", "size", size, serializedFMUStateSize(FMUState))) {
         return fmi3Error;
     }
 
-    memcpy(serializedState, FMUState, sizeof(ModelInstance));
+    serializeFMUState(FMUState, (char*)serializedState);
 
     return fmi3OK;
 }
@@ -913,15 +917,20 @@ fmi3Status fmi3DeserializeFMUState(fmi3Instance instance,
 
     ASSERT_STATE(DeserializeFMUState);
 
-    if (invalidNumber(S, "fmi3DeserializeFMUState", "size", size, sizeof(ModelInstance))) {
+    void* s = *FMUState ? *FMUState : allocateFMUState(S);
+
+    if (!s) {
         return fmi3Error;
     }
 
-    if (*FMUState == NULL) {
-        *FMUState = calloc(1, sizeof(ModelInstance));
+    if (deserializeFMUState(S, (const char*)serializedState, size, s) > Warning) {
+        if (!*FMUState) {
+            freeFMUState(S, s);
+        }
+        return fmi3Error;
     }
 
-    memcpy(*FMUState, serializedState, sizeof(ModelInstance));
+    *FMUState = s;
 
     return fmi3OK;
 }
@@ -936,29 +945,9 @@ fmi3Status fmi3GetDirectionalDerivative(fmi3Instance instance,
     fmi3Float64 sensitivity[],
     size_t nSensitivity) {
 
-    UNUSED(nSeed);
-    UNUSED(nSensitivity);
-
     ASSERT_STATE(GetDirectionalDerivative);
 
-    // TODO: check value references
-    // TODO: assert nUnknowns == nDeltaOfUnknowns
-    // TODO: assert nKnowns == nDeltaKnowns
-
-    Status status = OK;
-
-    for (size_t i = 0; i < nUnknowns; i++) {
-        sensitivity[i] = 0;
-        for (size_t j = 0; j < nKnowns; j++) {
-            double partialDerivative = 0;
-            Status s = getPartialDerivative(S, (ValueReference)unknowns[i], (ValueReference)knowns[j], &partialDerivative);
-            status = max(status, s);
-            if (status > Warning) return (fmi3Status)status;
-            sensitivity[i] += partialDerivative * seed[j];
-        }
-    }
-
-    return fmi3OK;
+    return (fmi3Status)getDirectionalDerivative(S, unknowns, nUnknowns, knowns, nKnowns, seed, nSeed, sensitivity, nSensitivity);
 }
 
 fmi3Status fmi3GetAdjointDerivative(fmi3Instance instance,
@@ -971,27 +960,9 @@ fmi3Status fmi3GetAdjointDerivative(fmi3Instance instance,
     fmi3Float64 sensitivity[],
     size_t nSensitivity) {
 
-    UNUSED(nSeed);
-    UNUSED(nSensitivity);
-
     ASSERT_STATE(GetAdjointDerivative);
 
-    // TODO: check value references
-
-    Status status = OK;
-
-    for (size_t i = 0; i < nKnowns; i++) {
-        sensitivity[i] = 0;
-        for (size_t j = 0; j < nUnknowns; j++) {
-            double partialDerivative = 0;
-            Status s = getPartialDerivative(S, (ValueReference)unknowns[j], (ValueReference)knowns[i], &partialDerivative);
-            status = max(status, s);
-            if (status > Warning) return (fmi3Status)status;
-            sensitivity[i] += partialDerivative * seed[j];
-        }
-    }
-
-    return fmi3OK;
+    return (fmi3Status)getAdjointDerivative(S, unknowns, nUnknowns, knowns, nKnowns, seed, nSeed, sensitivity, nSensitivity);
 }
 
 fmi3Status fmi3EnterConfigurationMode(fmi3Instance instance) {
@@ -1067,11 +1038,17 @@ fmi3Status fmi3GetShiftDecimal(fmi3Instance instance,
     size_t nValueReferences,
     fmi3Float64 shifts[]) {
 
-    UNUSED(valueReferences);
-    UNUSED(nValueReferences);
-    UNUSED(shifts);
+    ASSERT_STATE(GetShiftDecimal);
 
-    NOT_IMPLEMENTED;
+    Status status = OK;
+
+    for (size_t i = 0; i < nValueReferences; i++) {
+        Status s = getShift(instance, (ValueReference)valueReferences[i], &shifts[i]);
+        status = max(status, s);
+        if (status > Warning) return (fmi3Status)status;
+    }
+
+    return (fmi3Status)status;
 }
 
 fmi3Status fmi3GetShiftFraction(fmi3Instance instance,
@@ -1410,6 +1387,8 @@ fmi3Status fmi3DoStep(fmi3Instance instance,
 
     *eventHandlingNeeded = fmi3False;
 
+    doFixedSteps(S, nextCommunicationPoint);
+
     while (true) {
 
         nextCommunicationPointReached = S->time + FIXED_SOLVER_STEP > nextCommunicationPoint;
@@ -1457,3 +1436,33 @@ fmi3Status fmi3ActivateModelPartition(fmi3Instance instance,
 
     return (fmi3Status)activateModelPartition(S, (ValueReference)clockReference, activationTime);
 }
+
+#ifdef ENSEMBLE
+
+refEnsemble refInstantiateEnsemble(fmi3String instantiationToken, size_t nMembers, fmi3Float64 startTime) {
+
+    if (!instantiationToken || strcmp(instantiationToken, INSTANTIATION_TOKEN) || nMembers < 1) {
+        return NULL;
+    }
+
+    return createEnsemble(nMembers, startTime);
+}
+
+void refFreeEnsemble(refEnsemble ensemble) {
+    freeEnsemble((Ensemble*)ensemble);
+}
+
+fmi3Status refGetEnsembleFloat64(refEnsemble ensemble, fmi3ValueReference valueReference, fmi3Float64 values[], size_t nValues) {
+    return (fmi3Status)getEnsembleFloat64((Ensemble*)ensemble, (ValueReference)valueReference, values, nValues);
+}
+
+fmi3Status refSetEnsembleFloat64(refEnsemble ensemble, fmi3ValueReference valueReference, const fmi3Float64 values[], size_t nValues) {
+    return (fmi3Status)setEnsembleFloat64((Ensemble*)ensemble, (ValueReference)valueReference, values, nValues);
+}
+
+fmi3Status refDoStepEnsemble(refEnsemble ensemble, fmi3Float64 currentCommunicationPoint, fmi3Float64 communicationStepSize) {
+    doStepEnsemble((Ensemble*)ensemble, currentCommunicationPoint, communicationStepSize);
+    return fmi3OK;
+}
+
+#endif
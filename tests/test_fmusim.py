@@ -1,7 +1,9 @@
 import os
+import shutil
 from itertools import product
 from pathlib import Path
-from subprocess import check_call
+from subprocess import CalledProcessError, check_call, check_output, run
+from zipfile import ZipFile
 
 import numpy as np
 import pytest
@@ -17,7 +19,7 @@ work = Path(__file__).parent / 'work'
 os.makedirs(work, exist_ok=True)
 
 
-def call_fmusim(fmi_version, interface_type, test_name, args, model='BouncingBall.fmu'):
+def call_fmusim(fmi_version, interface_type, test_name, args, model='BouncingBall.fmu', remove_output_file=True):
 
     if fmi_version == 1:
         install = root / f'fmi{fmi_version}_{interface_type}' / 'install'
@@ -26,7 +28,7 @@ def call_fmusim(fmi_version, interface_type, test_name, args, model='BouncingBal
 
     output_file = work / f'{test_name}_fmi{fmi_version}_{interface_type}.csv'
 
-    if output_file.exists():
+    if remove_output_file and output_file.exists():
         os.remove(output_file)
 
     check_call([
@@ -90,6 +92,82 @@ def test_start_value_arrays(interface_type):
     assert result['y[1]'][0] == 3
 
 
+@pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
+def test_start_value_parameters(fmi_version, interface_type):
+
+    # e is a discrete Float parameter
+    result = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_start_value_parameters',
+        args=['--start-value', 'e', '0.5', '--output-variable', 'e'])
+
+    assert result['e'][0] == 0.5
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_structural_parameters(interface_type):
+
+    result = call_fmusim(
+        fmi_version=3,
+        interface_type=interface_type,
+        test_name='test_structural_parameters',
+        args=['--start-value', 'm', '8', '--start-value', 'n', '8'],
+        model='LinearTransform.fmu'
+    )
+
+    # identity matrix and u[j] = j + 1
+    assert all(result[f'y[{i}]'][0] == i + 1 for i in range(8))
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+@pytest.mark.parametrize('model, message', [
+    ('LinearTransform.fmu', b'The dimensions m and n must be at least 1.'),
+    ('SparseLinearTransform.fmu', b'The dimensions m, n and nnz must be at least 1.')
+])
+def test_invalid_structural_parameters(model, message, interface_type):
+
+    install = root / 'fmi3' / 'install'
+
+    process = run([
+        install / 'fmusim',
+        '--interface-type', interface_type,
+        '--start-value', 'm', '0',
+        '--output-file', work / f'test_invalid_structural_parameters_{model[:-4]}_{interface_type}.csv',
+        install / model],
+        cwd=work,
+        capture_output=True
+    )
+
+    assert process.returncode != 0
+    assert message in process.stdout
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_sparse_matrix(interface_type):
+
+    # A = [[1, 0, 2, 0], [0, 0, 0, 0], [0, 3, 0, 4]]
+    result = call_fmusim(
+        fmi_version=3,
+        interface_type=interface_type,
+        test_name='test_sparse_matrix',
+        args=[
+            '--start-value', 'm', '3',
+            '--start-value', 'n', '4',
+            '--start-value', 'nnz', '4',
+            '--start-value', 'rowPointers', '0 2 2',
+            '--start-value', 'columnIndices', '0 2 1 3',
+            '--start-value', 'values', '1 2 3 4',
+            '--start-value', 'u', '1 2 3 4',
+        ],
+        model='SparseLinearTransform.fmu'
+    )
+
+    assert result['y[0]'][0] == 7
+    assert result['y[1]'][0] == 0
+    assert result['y[2]'][0] == 22
+
+
 @pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
 def test_input_file(fmi_version, interface_type):
 
@@ -121,6 +199,266 @@ def test_input_file(fmi_version, interface_type):
     assert result['Int32_output'][-1] == 2
 
 
+@pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
+def test_input_file_discrete_changes(fmi_version, interface_type):
+
+    fmi_log_file = work / f'test_input_file_discrete_changes_fmi{fmi_version}_{interface_type}.txt'
+
+    call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_input_file_discrete_changes',
+        args=['--input-file', resources / 'Feedthrough_in.csv', '--stop-time', '5', '--log-fmi-calls', '--fmi-log-file', fmi_log_file],
+        model='Feedthrough.fmu')
+
+    with open(fmi_log_file) as f:
+        calls = [line for line in f if 'SetInteger(' in line or 'SetInt32(' in line]
+
+    # Int32_input is only set initially and when it changes from 1 to 2
+    assert len(calls) == 2
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_input_file_types(interface_type):
+
+    result = call_fmusim(
+        fmi_version=3,
+        interface_type=interface_type,
+        test_name='test_input_file_types',
+        args=['--input-file', resources / 'Feedthrough_typed_in.csv', '--stop-time', '2'],
+        model='Feedthrough.fmu')
+
+    # Int64 values beyond 2^53 are applied without loss of precision
+    assert result['Int64_output'][0] == 9007199254740993
+    assert result['Int64_output'][-1] == -9007199254740993
+
+    assert result['UInt8_output'][0] == 255
+    assert result['UInt8_output'][-1] == 1
+
+    assert result['Boolean_output'][0]
+    assert not result['Boolean_output'][-1]
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_input_file_binary(interface_type):
+
+    fmi_log_file = work / f'test_input_file_binary_fmi3_{interface_type}.txt'
+
+    result = call_fmusim(
+        fmi_version=3,
+        interface_type=interface_type,
+        test_name='test_input_file_binary',
+        args=['--input-file', resources / 'Feedthrough_binary_in.csv', '--stop-time', '2', '--log-fmi-calls', '--fmi-log-file', fmi_log_file],
+        model='Feedthrough.fmu')
+
+    with open(fmi_log_file) as f:
+        calls = [line for line in f if line.startswith('fmi3SetBinary')]
+
+    # values are only set when they change
+    assert len(calls) == 2
+    assert 'values={0x666f6f}' in calls[0]
+    assert 'values={0x626172}' in calls[1]
+
+
+def test_binary_input_invalid_strings():
+
+    install = root / 'fmi3' / 'install'
+
+    binary_input_file = work / 'test_binary_input_invalid_strings.bin'
+
+    check_call([
+        install / 'fmusim',
+        '--input-file', resources / 'Feedthrough_binary_in.csv',
+        '--convert-input-file', binary_input_file,
+        install / 'Feedthrough.fmu'],
+        cwd=work
+    )
+
+    data = binary_input_file.read_bytes()
+
+    assert data.endswith(b'bar\x00')
+
+    # remove the terminator of the last value
+    binary_input_file.write_bytes(data[:-1] + b'X')
+
+    process = run([
+        install / 'fmusim',
+        '--input-file', binary_input_file,
+        '--output-file', work / 'test_binary_input_invalid_strings.csv',
+        install / 'Feedthrough.fmu'],
+        cwd=work,
+        capture_output=True
+    )
+
+    assert process.returncode != 0
+    assert b'is invalid' in process.stdout
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
+def test_stream_input(fmi_version, interface_type):
+
+    args = ['--input-file', resources / 'Feedthrough_in.csv', '--stop-time', '5']
+
+    result1 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_stream_input_1',
+        args=args,
+        model='Feedthrough.fmu')
+
+    result2 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_stream_input_2',
+        args=args + ['--stream-input'],
+        model='Feedthrough.fmu')
+
+    assert np.all(result1 == result2)
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
+def test_stream_input_window(fmi_version, interface_type):
+
+    # more rows than the stream window of 1024 rows that slides by 504 rows
+    # with discrete changes and repeated time points around its boundaries
+    input_file = work / f'test_stream_input_window_fmi{fmi_version}_{interface_type}.csv'
+
+    events = {511, 512, 1023, 1024, 1025, 1527, 1528, 2031, 2032, 2033, 2535, 3071, 4095}
+
+    i = 1
+    b = 0
+
+    with open(input_file, 'w') as f:
+
+        f.write('time,Float64_continuous_input,Float64_discrete_input,Int32_input,Boolean_input\n')
+
+        for row in range(5000):
+
+            if row in events:
+                i = 3 - i
+
+            if row % 7 == 0 or row in events:
+                b = 1 - b
+
+            t = row * 1e-3
+            x = float(np.sin(row * 1e-2))
+
+            f.write(f'{t!r},{x!r},{i / 2},{i},{b}\n')
+
+            if row in {1024, 2032}:
+                f.write(f'{t!r},{x + 1!r},{i / 2},{i},{b}\n')
+
+    args = ['--input-file', input_file, '--stop-time', '5', '--output-interval', '1e-3']
+
+    result1 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_stream_input_window_1',
+        args=args,
+        model='Feedthrough.fmu')
+
+    result2 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_stream_input_window_2',
+        args=args + ['--stream-input'],
+        model='Feedthrough.fmu')
+
+    assert len(result1) > 5000
+    assert np.all(result1 == result2)
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_stream_input_invalid_row(interface_type):
+
+    input_file = work / f'test_stream_input_invalid_row_{interface_type}.csv'
+
+    # the invalid last row is only read ahead to find the next input event
+    with open(input_file, 'w') as f:
+        f.write('time,Float64_continuous_input\n')
+        for row in range(3000):
+            f.write(f'{row * 1e-3!r},{row}\n')
+        f.write('3,3000,1\n')
+
+    with pytest.raises(CalledProcessError):
+        call_fmusim(
+            fmi_version=3,
+            interface_type=interface_type,
+            test_name='test_stream_input_invalid_row',
+            args=['--input-file', input_file, '--stream-input', '--stop-time', '1'],
+            model='Feedthrough.fmu')
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_input_without_rows(interface_type):
+
+    install = root / 'fmi3' / 'install'
+
+    input_file = work / f'test_input_without_rows_{interface_type}.csv'
+    binary_input_file = work / f'test_input_without_rows_{interface_type}.bin'
+
+    with open(input_file, 'w') as f:
+        f.write('time,Float64_continuous_input,Int32_input\n')
+
+    check_call([
+        install / 'fmusim',
+        '--interface-type', interface_type,
+        '--input-file', input_file,
+        '--convert-input-file', binary_input_file,
+        install / 'Feedthrough.fmu'],
+        cwd=work
+    )
+
+    for args in [['--input-file', binary_input_file], ['--input-file', input_file, '--stream-input']]:
+
+        result = call_fmusim(
+            fmi_version=3,
+            interface_type=interface_type,
+            test_name='test_input_without_rows',
+            args=args + ['--stop-time', '1'],
+            model='Feedthrough.fmu')
+
+        # the start values are kept
+        assert np.all(result['Float64_continuous_output'] == 0)
+        assert np.all(result['Int32_output'] == 0)
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
+def test_binary_input(fmi_version, interface_type):
+
+    if fmi_version == 1:
+        install = root / f'fmi{fmi_version}_{interface_type}' / 'install'
+    else:
+        install = root / f'fmi{fmi_version}' / 'install'
+
+    binary_input_file = work / f'test_binary_input_fmi{fmi_version}_{interface_type}.bin'
+
+    check_call([
+        install / 'fmusim',
+        '--interface-type', interface_type,
+        '--input-file', resources / 'Feedthrough_in.csv',
+        '--convert-input-file', binary_input_file,
+        install / 'Feedthrough.fmu'],
+        cwd=work
+    )
+
+    result1 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_binary_input_1',
+        args=['--input-file', resources / 'Feedthrough_in.csv', '--stop-time', '5'],
+        model='Feedthrough.fmu')
+
+    result2 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_binary_input_2',
+        args=['--input-file', binary_input_file, '--stop-time', '5'],
+        model='Feedthrough.fmu')
+
+    assert np.all(result1 == result2)
+
+
 @pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
 def test_fmi_log_file(fmi_version, interface_type):
 
@@ -245,6 +583,47 @@ def test_event_mode_time_events():
     assert np.all(result['counter'] == [1, 1, 2, 2, 3, 3, 3, 4, 4, 5, 5, 6])
 
 
+def test_scheduled_execution():
+
+    result = call_fmusim(
+        fmi_version=3,
+        interface_type='se',
+        test_name='test_scheduled_execution',
+        args=[],
+        model='Clocks.fmu'
+    )
+
+    # inClock1 ticks every second and the countdown clock inClock3 is activated at t = 4
+    assert np.all(result['inClock1Ticks'] == np.arange(1, 12))
+    assert np.all(result['inClock3Ticks'] == [0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1])
+    assert np.all(result['output3']       == [0, 0, 0, 0, 1000, 1000, 1000, 1000, 1000, 1000, 1000])
+
+
+@pytest.mark.parametrize('interval_variability', ['tunable', 'changing'])
+def test_scheduled_execution_interval_variability(interval_variability):
+
+    install = root / 'fmi3' / 'install'
+
+    # Clocks.fmu with an inClock1 whose interval is retrieved from the FMU (without a shift)
+    filename = work / f'Clocks_{interval_variability}.fmu'
+
+    with ZipFile(install / 'Clocks.fmu') as source, ZipFile(filename, 'w') as target:
+        for info in source.infolist():
+            data = source.read(info)
+            if info.filename == 'modelDescription.xml':
+                data = data.replace(b'intervalVariability="constant" intervalDecimal="1.0"',
+                                    f'intervalVariability="{interval_variability}"'.encode())
+            target.writestr(info, data)
+
+    output_file = work / f'test_scheduled_execution_{interval_variability}.csv'
+
+    check_call([install / 'fmusim', '--interface-type', 'se', '--output-file', output_file, filename], cwd=work)
+
+    result = read_csv(output_file)
+
+    assert np.all(result['inClock1Ticks'] == np.arange(1, 12))
+
+
 @pytest.mark.parametrize('fmi_version, interface_type', product([2, 3], ['cs', 'me']))
 def test_restore_fmu_state(fmi_version, interface_type):
 
@@ -277,3 +656,290 @@ def test_restore_fmu_state(fmi_version, interface_type):
 
     assert result2['time'][0] == 1
     assert result2['h'][0] == result1['h'][-1]
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([2, 3], ['cs', 'me']))
+def test_restore_fmu_state_delta(fmi_version, interface_type):
+
+    base_file = f'FMUStateBase_{fmi_version}_{interface_type}.bin'
+    delta_file = f'FMUStateDelta_{fmi_version}_{interface_type}.bin'
+
+    call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_restore_fmu_state_delta_base',
+        args=['--stop-time', '1', '--final-fmu-state-file', base_file],
+        model='BouncingBall.fmu'
+    )
+
+    result1 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_restore_fmu_state_delta_1',
+        args=['--stop-time', '2', '--final-fmu-state-file', delta_file, '--fmu-state-base-file', base_file],
+        model='BouncingBall.fmu'
+    )
+
+    result2 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_restore_fmu_state_delta_2',
+        args=['--start-time', '2', '--stop-time', '3', '--initial-fmu-state-file', delta_file],
+        model='BouncingBall.fmu'
+    )
+
+    assert result2['time'][0] == 2
+    assert result2['h'][0] == result1['h'][-1]
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([2, 3], ['cs', 'me']))
+def test_restore_fmu_state_delta_directory(fmi_version, interface_type):
+
+    # the base file is found relative to the delta file
+    directory = work / f'FMUStates_{fmi_version}_{interface_type}'
+    moved_directory = work / f'FMUStatesMoved_{fmi_version}_{interface_type}'
+
+    for d in [directory, moved_directory]:
+        if d.exists():
+            shutil.rmtree(d)
+
+    os.makedirs(directory)
+
+    base_file = directory / 'base.bin'
+    delta_file = directory / 'delta.bin'
+
+    call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_restore_fmu_state_delta_directory_base',
+        args=['--stop-time', '1', '--final-fmu-state-file', base_file],
+        model='BouncingBall.fmu'
+    )
+
+    # the same file through a different path cannot be its own base
+    with pytest.raises(CalledProcessError):
+        call_fmusim(
+            fmi_version=fmi_version,
+            interface_type=interface_type,
+            test_name='test_restore_fmu_state_delta_directory_self',
+            args=['--stop-time', '2', '--final-fmu-state-file', base_file,
+                  '--fmu-state-base-file', directory / '..' / directory.name / 'base.bin'],
+            model='BouncingBall.fmu'
+        )
+
+    result1 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_restore_fmu_state_delta_directory_1',
+        args=['--stop-time', '2', '--final-fmu-state-file', delta_file, '--fmu-state-base-file', base_file],
+        model='BouncingBall.fmu'
+    )
+
+    os.rename(directory, moved_directory)
+
+    result2 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_restore_fmu_state_delta_directory_2',
+        args=['--start-time', '2', '--stop-time', '3', '--initial-fmu-state-file', moved_directory / 'delta.bin'],
+        model='BouncingBall.fmu'
+    )
+
+    assert result2['time'][0] == 2
+    assert result2['h'][0] == result1['h'][-1]
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([2, 3], ['cs', 'me']))
+def test_resume_from_checkpoint(fmi_version, interface_type):
+
+    args = ['--stop-time', '3', '--checkpoint-interval', '0.5']
+
+    result1 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_resume_from_checkpoint_1',
+        args=args + ['--checkpoint-file', f'Checkpoint1_{fmi_version}_{interface_type}'],
+        model='BouncingBall.fmu'
+    )
+
+    checkpoint_file = f'Checkpoint2_{fmi_version}_{interface_type}'
+
+    # interrupted run
+    call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_resume_from_checkpoint_2',
+        args=args + ['--checkpoint-file', checkpoint_file, '--stop-time', '1.25'],
+        model='BouncingBall.fmu'
+    )
+
+    result2 = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_resume_from_checkpoint_2',
+        args=args + ['--checkpoint-file', checkpoint_file, '--resume-from-checkpoint'],
+        model='BouncingBall.fmu',
+        remove_output_file=False
+    )
+
+    assert np.all(result2 == result1)
+
+
+@pytest.mark.parametrize('fmi_version, interface_type', product([1, 2, 3], ['cs', 'me']))
+def test_ensemble(fmi_version, interface_type):
+
+    result = call_fmusim(
+        fmi_version=fmi_version,
+        interface_type=interface_type,
+        test_name='test_ensemble',
+        args=['--ensemble', '2', '--start-value', 'mu', '0.5 1.5'],
+        model='VanDerPol.fmu'
+    )
+
+    for member, mu in enumerate(['0.5', '1.5']):
+
+        reference = call_fmusim(
+            fmi_version=fmi_version,
+            interface_type=interface_type,
+            test_name=f'test_ensemble_{member}',
+            args=['--start-value', 'mu', mu],
+            model='VanDerPol.fmu'
+        )
+
+        rows = result[result['member'] == member]
+
+        assert np.all(rows['time'] == reference['time'])
+        assert np.all(rows['x0'] == reference['x0'])
+
+
+def test_ensemble_functions():
+
+    fmi_log_file = work / 'test_ensemble_functions_fmi3_cs.txt'
+
+    result = call_fmusim(
+        fmi_version=3,
+        interface_type='cs',
+        test_name='test_ensemble_functions',
+        args=['--ensemble', '3', '--start-value', 'k', '0.5 1 2', '--start-value', 'x', '2', '--log-fmi-calls', '--fmi-log-file', fmi_log_file],
+        model='Dahlquist.fmu'
+    )
+
+    with open(fmi_log_file) as f:
+        calls = f.read()
+
+    # all members are advanced at once
+    assert 'refDoStepEnsemble(' in calls
+    assert 'fmi3DoStep(' not in calls
+
+    for member, k in enumerate(['0.5', '1', '2']):
+
+        reference = call_fmusim(
+            fmi_version=3,
+            interface_type='cs',
+            test_name=f'test_ensemble_functions_{member}',
+            args=['--start-value', 'k', k, '--start-value', 'x', '2'],
+            model='Dahlquist.fmu'
+        )
+
+        rows = result[result['member'] == member]
+
+        assert np.all(rows['time'] == reference['time'])
+        assert np.all(rows['x'] == reference['x'])
+
+
+@pytest.mark.parametrize('fmi_version', [2, 3])
+@pytest.mark.parametrize('master', ['jacobi', 'gauss-seidel'])
+def test_system(fmi_version, master):
+
+    install = root / f'fmi{fmi_version}' / 'install'
+
+    system_file = work / f'test_system_fmi{fmi_version}.txt'
+
+    with open(system_file, 'w') as file:
+        file.write(f'fmu source {install / "Dahlquist.fmu"}\n')
+        file.write(f'fmu sink {install / "Feedthrough.fmu"}\n')
+        file.write('connection source.x sink.Float64_continuous_input\n')
+
+    check_call([
+        install / 'fmusim',
+        '--system',
+        '--master', master,
+        '--output-interval', '0.1',
+        '--output-file', work / f'test_system_{master}_fmi{fmi_version}.csv',
+        system_file],
+        cwd=work
+    )
+
+    source = read_csv(work / f'test_system_{master}_fmi{fmi_version}_source.csv')
+    sink = read_csv(work / f'test_system_{master}_fmi{fmi_version}_sink.csv')
+
+    assert sink['Float64_continuous_output'][0] == source['x'][0]
+
+    if master == 'jacobi':
+        # the inputs are set to the outputs of the previous communication point
+        assert np.all(sink['Float64_continuous_output'][1:] == source['x'][:-1])
+    else:
+        # the sink steps after the source with its outputs at the end of the step
+        assert np.all(sink['Float64_continuous_output'] == source['x'])
+
+
+@pytest.mark.parametrize('fmi_version', [2, 3])
+def test_system_algebraic_loop(fmi_version):
+
+    install = root / f'fmi{fmi_version}' / 'install'
+
+    system_file = work / f'test_system_algebraic_loop_fmi{fmi_version}.txt'
+
+    with open(system_file, 'w') as file:
+        file.write(f'fmu a {install / "Feedthrough.fmu"}\n')
+        file.write(f'fmu b {install / "Feedthrough.fmu"}\n')
+        file.write('connection a.Float64_continuous_output b.Float64_continuous_input\n')
+        file.write('connection b.Float64_continuous_output a.Float64_continuous_input\n')
+
+    output = check_output([
+        install / 'fmusim',
+        '--system',
+        '--output-file', work / f'test_system_algebraic_loop_fmi{fmi_version}.csv',
+        system_file],
+        cwd=work
+    )
+
+    assert b'Algebraic loop: a.Float64_continuous_output -> b.Float64_continuous_input, b.Float64_continuous_output -> a.Float64_continuous_input' in output
+
+
+@pytest.mark.parametrize('fmi_version', [2, 3])
+def test_system_break_cycle(fmi_version):
+
+    install = root / f'fmi{fmi_version}' / 'install'
+
+    system_file = work / f'test_system_break_cycle_fmi{fmi_version}.txt'
+
+    # b.Float64_discrete_output does not depend on b.Float64_continuous_input so the cycle is broken
+    # at the connection to a.Float64_continuous_input (although b is listed first)
+    with open(system_file, 'w') as file:
+        file.write(f'fmu source {install / "Dahlquist.fmu"}\n')
+        file.write(f'fmu b {install / "Feedthrough.fmu"}\n')
+        file.write(f'fmu a {install / "Feedthrough.fmu"}\n')
+        file.write('connection source.x b.Float64_discrete_input\n')
+        file.write('connection a.Float64_continuous_output b.Float64_continuous_input\n')
+        file.write('connection b.Float64_discrete_output a.Float64_continuous_input\n')
+
+    check_call([
+        install / 'fmusim',
+        '--system',
+        '--output-interval', '0.5',
+        '--output-file', work / f'test_system_break_cycle_fmi{fmi_version}.csv',
+        system_file],
+        cwd=work
+    )
+
+    a = read_csv(work / f'test_system_break_cycle_fmi{fmi_version}_a.csv')
+    b = read_csv(work / f'test_system_break_cycle_fmi{fmi_version}_b.csv')
+
+    assert a['Float64_continuous_output'][0] == b['Float64_discrete_output'][0]
+
+    # a uses the output of b of the previous communication point
+    assert np.all(a['Float64_continuous_output'][1:] == b['Float64_discrete_output'][:-1])
+
+    # b steps after a with its output at the end of the step
+    assert np.all(b['Float64_continuous_output'] == a['Float64_continuous_output'])
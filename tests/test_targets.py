@@ -1,6 +1,8 @@
 import os
 import subprocess
 from pathlib import Path
+import numpy as np
+import pytest
 from fmpy import simulate_fmu
 from fmpy.validation import validate_fmu
 
@@ -59,12 +61,14 @@ def test_fmi2():
         for interface_type in ['cs', 'me']:
             subprocess.check_call(build_dir / 'temp' / f'{model}_{interface_type}', cwd=os.path.join(build_dir, 'temp'))
 
+    subprocess.check_call(build_dir / 'temp' / 'cs_async_step', cwd=os.path.join(build_dir, 'temp'))
+
 
 def test_fmi3():
 
     build_dir = root / 'fmi3'
 
-    models = ['BouncingBall', 'Dahlquist', 'LinearTransform', 'Resource', 'Stair', 'VanDerPol', 'Feedthrough']
+    models = ['BouncingBall', 'Dahlquist', 'LinearTransform', 'SparseLinearTransform', 'Resource', 'Stair', 'VanDerPol', 'Feedthrough']
 
     for model in models:
         validate(build_dir, model=model, fmi_types=['ModelExchange', 'CoSimulation'])
@@ -73,4 +77,71 @@ def test_fmi3():
         for interface_type in ['cs', 'me']:
             subprocess.check_call(build_dir / 'temp' / f'{model}_{interface_type}', cwd=os.path.join(build_dir, 'temp'))
 
+    subprocess.check_call(build_dir / 'temp' / 'equation_blocks', cwd=os.path.join(build_dir, 'temp'))
+
+    subprocess.check_call(build_dir / 'temp' / 'linear_transform_derivatives', cwd=os.path.join(build_dir, 'temp'))
+
+    subprocess.check_call(build_dir / 'temp' / 'resource_files', cwd=os.path.join(build_dir, 'temp'))
+
     assert not validate_fmu(build_dir / 'install' / 'Clocks.fmu')
+
+
+def van_der_pol(t, mu=1, h=1e-4):
+    """ Solution of the Van der Pol oscillator at the times t calculated with RK4 and the step size h """
+
+    def f(x):
+        return np.array([x[1], mu * (1 - x[0]**2) * x[1] - x[0]])
+
+    x = np.array([2.0, 0.0])
+    n = 0
+    values = []
+
+    for ti in t:
+        while n * h < ti - h / 2:
+            k1 = f(x)
+            k2 = f(x + h / 2 * k1)
+            k3 = f(x + h / 2 * k2)
+            k4 = f(x + h * k3)
+            x = x + h / 6 * (k1 + 2 * k2 + 2 * k3 + k4)
+            n += 1
+        values.append(x)
+
+    return np.array(values)
+
+
+@pytest.mark.parametrize('fixed_solver', ['RK4', 'RK45'])
+def test_fixed_solver(fixed_solver, pytestconfig):
+
+    build_dir = root / f'fmi3_{fixed_solver.lower()}'
+
+    os.makedirs(build_dir, exist_ok=True)
+
+    cmake_options = []
+
+    if pytestconfig.getoption('cmake_generator'):
+        cmake_options += ['-G', pytestconfig.getoption('cmake_generator')]
+
+    if pytestconfig.getoption('cmake_architecture'):
+        cmake_options += ['-A', pytestconfig.getoption('cmake_architecture')]
+
+    cmake_options += [
+        '-D', 'FMI_VERSION=3',
+        '-D', f'FIXED_SOLVER={fixed_solver}',
+        '-D', f'CMAKE_INSTALL_PREFIX={build_dir / "install"}',
+        '..'
+    ]
+
+    subprocess.check_call(['cmake'] + cmake_options, cwd=build_dir)
+    subprocess.check_call(['cmake', '--build', '.', '--target', 'install', '--config', 'Release'], cwd=build_dir)
+
+    # communication steps of many fixed steps in which the step size of RK45 can grow
+    result = simulate_fmu(build_dir / 'install' / 'Dahlquist.fmu', fmi_type='CoSimulation', output_interval=1)
+
+    assert np.max(np.abs(result['x'] - np.exp(-result['time']))) < 1e-4
+
+    result = simulate_fmu(build_dir / 'install' / 'VanDerPol.fmu', fmi_type='CoSimulation', output_interval=1)
+
+    reference = van_der_pol(result['time'])
+
+    assert np.max(np.abs(result['x0'] - reference[:, 0])) < 1e-4
+    assert np.max(np.abs(result['x1'] - reference[:, 1])) < 1e-4